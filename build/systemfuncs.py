@@ -20,6 +20,13 @@ class FTruncateFunction(SystemFunction):
 	def iterHeaders(cls, targetPlatform):
 		yield '<unistd.h>'
 
+class InotifyInit1Function(SystemFunction):
+	name = 'inotify_init1'
+
+	@classmethod
+	def iterHeaders(cls, targetPlatform):
+		yield '<sys/inotify.h>'
+
 class MMapFunction(SystemFunction):
 	name = 'mmap'
 
@@ -43,6 +50,13 @@ class NftwFunction(SystemFunction):
 	def iterHeaders(cls, targetPlatform):
 		yield '<ftw.h>'
 
+class ShmOpenFunction(SystemFunction):
+	name = 'shm_open'
+
+	@classmethod
+	def iterHeaders(cls, targetPlatform):
+		yield '<sys/mman.h>'
+
 # Build a list of system functions using introspection.
 systemFunctions = [
 	obj
@@ -18,6 +18,7 @@
 #include "GLUtil.hh"
 #include "Reactor.hh"
 #include "RomInfo.hh"
+#include "StartupProfiler.hh"
 #include "hash_map.hh"
 #include "outer.hh"
 #include "ranges.hh"
@@ -58,12 +59,14 @@ CommandLineParser::CommandLineParser(Reactor& reactor_)
 {
 	haveConfig = false;
 	haveSettings = false;
+	profileStartup = false;
 
 	registerOption("-h",          helpOption,    PHASE_BEFORE_INIT, 1);
 	registerOption("--help",      helpOption,    PHASE_BEFORE_INIT, 1);
 	registerOption("-v",          versionOption, PHASE_BEFORE_INIT, 1);
 	registerOption("--version",   versionOption, PHASE_BEFORE_INIT, 1);
 	registerOption("-bash",       bashOption,    PHASE_BEFORE_INIT, 1);
+	registerOption("-profile-startup", profileStartupOption, PHASE_BEFORE_INIT, 1);
 
 	registerOption("-setting",    settingOption, PHASE_BEFORE_SETTINGS);
 	registerOption("-control",    controlOption, PHASE_BEFORE_SETTINGS, 1);
@@ -168,11 +171,14 @@ void CommandLineParser::parse(int argc, char** argv)
 	     (phase <= PHASE_LAST) && (parseStatus != EXIT);
 	     phase = static_cast<ParsePhase>(phase + 1)) {
 		switch (phase) {
-		case PHASE_INIT:
+		case PHASE_INIT: {
+			StartupProfiler::Scope scope("Reactor init");
 			reactor.init();
 			getInterpreter().init(argv[0]);
 			break;
-		case PHASE_LOAD_SETTINGS:
+		}
+		case PHASE_LOAD_SETTINGS: {
+			StartupProfiler::Scope scope("load settings");
 			// after -control and -setting has been parsed
 			if (parseStatus != CONTROL) {
 				// if there already is a XML-StdioConnection, we
@@ -207,6 +213,7 @@ void CommandLineParser::parse(int argc, char** argv)
 				settingsConfig.setSaveFilename(context, filename);
 			}
 			break;
+		}
 		case PHASE_DEFAULT_MACHINE: {
 			if (!haveConfig) {
 				// load default config file in case the user didn't specify one
@@ -596,4 +603,19 @@ string_view CommandLineParser::BashOption::optionHelp() const
 	return {}; // don't include this option in --help
 }
 
+
+// class ProfileStartupOption
+
+void CommandLineParser::ProfileStartupOption::parseOption(
+	const string& /*option*/, span<string>& /*cmdLine*/)
+{
+	auto& parser = OUTER(CommandLineParser, profileStartupOption);
+	parser.profileStartup = true;
+}
+
+string_view CommandLineParser::ProfileStartupOption::optionHelp() const
+{
+	return "Print how long the different startup phases took";
+}
+
 } // namespace openmsx
@@ -67,6 +67,10 @@ public:
 	  */
 	bool isHiddenStartup() const;
 
+	/** Print the startup profile once startup is finished?
+	  */
+	bool isProfileStartup() const { return profileStartup; }
+
 private:
 	struct OptionData {
 		CLIOption* option;
@@ -139,6 +143,11 @@ private:
 		std::string_view optionHelp() const override;
 	} bashOption;
 
+	struct ProfileStartupOption final : CLIOption {
+		void parseOption(const std::string& option, span<std::string>& cmdLine) override;
+		std::string_view optionHelp() const override;
+	} profileStartupOption;
+
 	MSXRomCLI msxRomCLI;
 	CliExtension cliExtension;
 	ReplayCLI replayCLI;
@@ -153,6 +162,7 @@ private:
 	ParseStatus parseStatus;
 	bool haveConfig;
 	bool haveSettings;
+	bool profileStartup;
 };
 
 } // namespace openmsx
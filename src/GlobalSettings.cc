@@ -1,6 +1,8 @@
 #include "GlobalSettings.hh"
 #include "SettingsConfig.hh"
 #include "GlobalCommandController.hh"
+#include "SeekableInflate.hh"
+#include "Scheduler.hh"
 #include "strCat.hh"
 #include "view.hh"
 #include "xrange.hh"
@@ -42,6 +44,13 @@ GlobalSettings::GlobalSettings(GlobalCommandController& commandController_)
 			{"hq",   ResampledSoundDevice::RESAMPLE_HQ},
 			{"fast", ResampledSoundDevice::RESAMPLE_LQ},
 			{"blip", ResampledSoundDevice::RESAMPLE_BLIP}})
+	, decompressionCacheSetting(commandController,
+		"decompression_cache_size",
+		"amount of memory (in MB) used to cache data from large compressed files",
+		64, 1, 4096)
+	, schedulerProfilingSetting(commandController, "scheduler_profiling",
+		"collect statistics per Schedulable, see 'machine_info scheduler_profile'",
+		false, Setting::DONT_SAVE)
 	, throttleManager(commandController)
 {
 	deadzoneSettings = to_vector(
@@ -53,10 +62,15 @@ GlobalSettings::GlobalSettings(GlobalCommandController& commandController_)
 				25, 0, 100);
 		}));
 	getPowerSetting().attach(*this);
+	decompressionCacheSetting.attach(*this);
+	update(decompressionCacheSetting);
+	schedulerProfilingSetting.attach(*this);
 }
 
 GlobalSettings::~GlobalSettings()
 {
+	schedulerProfilingSetting.detach(*this);
+	decompressionCacheSetting.detach(*this);
 	getPowerSetting().detach(*this);
 	commandController.getSettingsConfig().setSaveSettings(
 		autoSaveSetting.getBoolean());
@@ -70,6 +84,11 @@ void GlobalSettings::update(const Setting& setting)
 		// this solved a bug, but apart from that this behaviour also
 		// makes more sense
 		getPauseSetting().setBoolean(false);
+	} else if (&setting == &decompressionCacheSetting) {
+		SeekableInflate::setCacheLimit(
+			size_t(decompressionCacheSetting.getInt()) * 1024 * 1024);
+	} else if (&setting == &schedulerProfilingSetting) {
+		Scheduler::setProfiling(schedulerProfilingSetting.getBoolean());
 	}
 }
 
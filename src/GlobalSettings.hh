@@ -47,6 +47,9 @@ public:
 	EnumSetting<ResampledSoundDevice::ResampleType>& getResampleSetting() {
 		return resampleSetting;
 	}
+	IntegerSetting& getDecompressionCacheSetting() {
+		return decompressionCacheSetting;
+	}
 	IntegerSetting& getJoyDeadzoneSetting(int i) {
 		return *deadzoneSettings[i];
 	}
@@ -67,6 +70,8 @@ private:
 	StringSetting  umrCallBackSetting;
 	StringSetting  invalidPsgDirectionsSetting;
 	EnumSetting<ResampledSoundDevice::ResampleType> resampleSetting;
+	IntegerSetting decompressionCacheSetting;
+	BooleanSetting schedulerProfilingSetting;
 	std::vector<std::unique_ptr<IntegerSetting>> deadzoneSettings;
 	ThrottleManager throttleManager;
 };
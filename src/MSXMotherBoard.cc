@@ -144,6 +144,17 @@ private:
 	MSXMotherBoard& motherBoard;
 };
 
+class SchedulerProfileInfo final : public InfoTopic
+{
+public:
+	explicit SchedulerProfileInfo(MSXMotherBoard& motherBoard);
+	void execute(span<const TclObject> tokens,
+	             TclObject& result) const override;
+	string help(const vector<string>& tokens) const override;
+private:
+	MSXMotherBoard& motherBoard;
+};
+
 class FastForwardHelper final : private Schedulable
 {
 public:
@@ -207,6 +218,7 @@ MSXMotherBoard::MSXMotherBoard(Reactor& reactor_)
 	machineNameInfo = make_unique<MachineNameInfo>(*this);
 	machineTypeInfo = make_unique<MachineTypeInfo>(*this);
 	deviceInfo = make_unique<DeviceInfo>(*this);
+	schedulerProfileInfo = make_unique<SchedulerProfileInfo>(*this);
 	debugger = make_unique<Debugger>(*this);
 
 	msxMixer->mute(); // powered down
@@ -988,6 +1000,43 @@ void DeviceInfo::tabCompletion(vector<string>& tokens) const
 }
 
 
+// SchedulerProfileInfo
+
+SchedulerProfileInfo::SchedulerProfileInfo(MSXMotherBoard& motherBoard_)
+	: InfoTopic(motherBoard_.getMachineInfoCommand(), "scheduler_profile")
+	, motherBoard(motherBoard_)
+{
+}
+
+void SchedulerProfileInfo::execute(span<const TclObject> /*tokens*/,
+                                   TclObject& result) const
+{
+	auto entries = to_vector(view::transform(
+		motherBoard.getScheduler().getProfile(),
+		[](auto& e) { return &e; }));
+	ranges::sort(entries, [](auto* x, auto* y) { return x->time > y->time; });
+	for (auto* e : entries) {
+		result.addListElement(makeTclDict(
+			"name",        e->name,
+			"sync_points", e->syncPoints,
+			"cpu_exits",   e->cpuExits,
+			"executions",  e->executions,
+			"time_us",     e->time / 1000,
+			"deleted",     e->deleted));
+	}
+}
+
+string SchedulerProfileInfo::help(const vector<string>& /*tokens*/) const
+{
+	return "Returns, per Schedulable, how many sync points it created, how "
+	       "often the CPU emulation loop had to be left for it, how often "
+	       "its executeUntil() method was called and the total time spent "
+	       "in that method. Sorted on time. Only collected while the "
+	       "'scheduler_profiling' setting is enabled, enabling it resets "
+	       "the statistics.";
+}
+
+
 // FastForwardHelper
 
 FastForwardHelper::FastForwardHelper(MSXMotherBoard& motherBoard_)
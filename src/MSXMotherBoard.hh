@@ -23,6 +23,7 @@ class CliComm;
 class CommandController;
 class Debugger;
 class DeviceInfo;
+class SchedulerProfileInfo;
 class EventDelay;
 class ExtCmd;
 class FastForwardHelper;
@@ -260,6 +261,7 @@ private:
 	std::unique_ptr<MachineTypeInfo> machineTypeInfo;
 	std::unique_ptr<DeviceInfo>   deviceInfo;
 	friend class DeviceInfo;
+	std::unique_ptr<SchedulerProfileInfo> schedulerProfileInfo;
 
 	std::unique_ptr<FastForwardHelper> fastForwardHelper;
 
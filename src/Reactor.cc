@@ -21,9 +21,12 @@
 #include "CommandException.hh"
 #include "GlobalCliComm.hh"
 #include "InfoTopic.hh"
+#include "Interpreter.hh"
 #include "Display.hh"
 #include "Mixer.hh"
+#include "ProfileCounters.hh"
 #include "AviRecorder.hh"
+#include "RawFrameRecorder.hh"
 #include "GlobalSettings.hh"
 #include "BooleanSetting.hh"
 #include "EnumSetting.hh"
@@ -35,6 +38,7 @@
 #include "FileException.hh"
 #include "FileOperations.hh"
 #include "ReadDir.hh"
+#include "StartupProfiler.hh"
 #include "Thread.hh"
 #include "Timer.hh"
 #include "serialize.hh"
@@ -45,8 +49,10 @@
 #include "StringOp.hh"
 #include "unreachable.hh"
 #include "view.hh"
+#include "xrange.hh"
 #include "build-info.hh"
 #include <cassert>
+#include <iostream>
 #include <memory>
 
 using std::make_shared;
@@ -172,6 +178,15 @@ public:
 	string help(const vector<string>& tokens) const override;
 };
 
+class ProfileCommand final : public Command
+{
+public:
+	explicit ProfileCommand(CommandController& commandController);
+	void execute(span<const TclObject> tokens, TclObject& result) override;
+	string help(const vector<string>& tokens) const override;
+	void tabCompletion(vector<string>& tokens) const override;
+};
+
 class ConfigInfo final : public InfoTopic
 {
 public:
@@ -195,6 +210,15 @@ private:
 	const uint64_t reference;
 };
 
+class StartupProfileInfo final : public InfoTopic
+{
+public:
+	explicit StartupProfileInfo(InfoCommand& openMSXInfoCommand);
+	void execute(span<const TclObject> tokens,
+	             TclObject& result) const override;
+	string help(const vector<string>& tokens) const override;
+};
+
 class SoftwareInfoTopic final : InfoTopic
 {
 public:
@@ -257,7 +281,10 @@ void Reactor::init()
 		*globalCommandController);
 	setClipboardCommand = make_unique<SetClipboardCommand>(
 		*globalCommandController);
+	profileCommand = make_unique<ProfileCommand>(
+		*globalCommandController);
 	aviRecordCommand = make_unique<AviRecorder>(*this);
+	rawFrameRecordCommand = make_unique<RawFrameRecorder>(*this);
 	extensionInfo = make_unique<ConfigInfo>(
 		getOpenMSXInfoCommand(), "extensions");
 	machineInfo   = make_unique<ConfigInfo>(
@@ -266,6 +293,8 @@ void Reactor::init()
 		getOpenMSXInfoCommand());
 	softwareInfoTopic = make_unique<SoftwareInfoTopic>(
 		getOpenMSXInfoCommand(), *this);
+	startupProfileInfo = make_unique<StartupProfileInfo>(
+		getOpenMSXInfoCommand());
 	tclCallbackMessages = make_unique<TclCallbackMessages>(
 		*globalCliComm, *globalCommandController);
 
@@ -298,6 +327,7 @@ Reactor::~Reactor()
 RomDatabase& Reactor::getSoftwareDatabase()
 {
 	if (!softwareDatabase) {
+		StartupProfiler::Scope scope("load software database");
 		softwareDatabase = make_unique<RomDatabase>(*globalCliComm);
 	}
 	return *softwareDatabase;
@@ -423,7 +453,9 @@ void Reactor::replaceBoard(MSXMotherBoard& oldBoard_, Board newBoard_)
 
 void Reactor::switchMachine(const string& machine)
 {
+	StartupProfiler::Scope scope(strCat("load machine ", machine));
 	if (!display) {
+		StartupProfiler::Scope scope2("video init");
 		display = make_unique<Display>(*this);
 		// TODO: Currently it is not possible to move this call into the
 		//       constructor of Display because the call to createVideoSystem()
@@ -521,28 +553,38 @@ void Reactor::run(CommandLineParser& parser)
 	auto& commandController = *globalCommandController;
 
 	// execute init.tcl
-	try {
-		commandController.source(
-			preferSystemFileContext().resolve("init.tcl"));
-	} catch (FileException&) {
-		// no init.tcl, ignore
+	{
+		StartupProfiler::Scope scope("init.tcl");
+		try {
+			commandController.source(
+				preferSystemFileContext().resolve("init.tcl"));
+		} catch (FileException&) {
+			// no init.tcl, ignore
+		}
+		addTclScriptsProfile();
 	}
 
 	// execute startup scripts
-	for (auto& s : parser.getStartupScripts()) {
-		try {
-			commandController.source(userFileContext().resolve(s));
-		} catch (FileException& e) {
-			throw FatalError("Couldn't execute script: ",
-			                 e.getMessage());
+	if (!parser.getStartupScripts().empty()) {
+		StartupProfiler::Scope scope("startup scripts");
+		for (auto& s : parser.getStartupScripts()) {
+			try {
+				commandController.source(userFileContext().resolve(s));
+			} catch (FileException& e) {
+				throw FatalError("Couldn't execute script: ",
+				                 e.getMessage());
+			}
 		}
 	}
-	for (auto& cmd : parser.getStartupCommands()) {
-		try {
-			commandController.executeCommand(cmd);
-		} catch (CommandException& e) {
-			throw FatalError("Couldn't execute command: ", cmd,
-			                 '\n', e.getMessage());
+	if (!parser.getStartupCommands().empty()) {
+		StartupProfiler::Scope scope("startup commands");
+		for (auto& cmd : parser.getStartupCommands()) {
+			try {
+				commandController.executeCommand(cmd);
+			} catch (CommandException& e) {
+				throw FatalError("Couldn't execute command: ", cmd,
+				                 '\n', e.getMessage());
+			}
 		}
 	}
 
@@ -559,15 +601,40 @@ void Reactor::run(CommandLineParser& parser)
 		// in its constructor
 		//commandController.executeCommand("set power on");
 		if (activeBoard) {
+			StartupProfiler::Scope scope("power up");
 			activeBoard->powerUp();
 		}
 	}
 
+	StartupProfiler::finish();
+	if (parser.isProfileStartup()) {
+		std::cout << StartupProfiler::report() << std::flush;
+	}
+
 	while (doOneIteration()) {
 		// nothing
 	}
 }
 
+// init.tcl measures how long each script in share/scripts takes, add those
+// measurements to the startup profile.
+void Reactor::addTclScriptsProfile()
+{
+	auto& interp = getInterpreter();
+	try {
+		auto list = interp.execute("set ::openmsx::profile_list");
+		for (auto i : xrange(list.getListLength(interp))) {
+			auto entry = list.getListIndex(interp, i);
+			if (entry.getListLength(interp) != 2) continue;
+			StartupProfiler::add(
+				FileOperations::getFilename(entry.getListIndex(interp, 1).getString()),
+				entry.getListIndex(interp, 0).getInt(interp));
+		}
+	} catch (CommandException&) {
+		// e.g. no init.tcl, ignore
+	}
+}
+
 bool Reactor::doOneIteration()
 {
 	eventDistributor->deliverEvents();
@@ -1066,6 +1133,74 @@ string SetClipboardCommand::help(const vector<string>& /*tokens*/) const
 }
 
 
+// class ProfileCommand
+
+ProfileCommand::ProfileCommand(CommandController& commandController_)
+	: Command(commandController_, "profile")
+{
+}
+
+void ProfileCommand::execute(span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, Between{1, 2}, "?on|off|reset|report?");
+	string_view sub = (tokens.size() == 2) ? tokens[1].getString() : "report";
+	const auto& all = ProfileCountersBase::getAll();
+	if (sub == "on") {
+		ProfileCountersBase::enabled = true;
+	} else if (sub == "off") {
+		ProfileCountersBase::enabled = false;
+	} else if (sub == "reset") {
+		for (auto* p : all) p->reset();
+	} else if (sub == "report") {
+		// Counters with the same name (e.g. the same device in different
+		// machines) are summed.
+		struct Group {
+			const ProfileCountersBase* first;
+			vector<uint64_t> sums;
+		};
+		vector<Group> groups;
+		for (const auto* p : all) {
+			auto counters = p->getCounters();
+			auto it = ranges::find_if(groups, [&](const Group& g) {
+				return g.first->getName() == p->getName(); });
+			if (it == end(groups)) {
+				groups.push_back({p, vector<uint64_t>(counters.begin(), counters.end())});
+			} else {
+				for (auto i : xrange(counters.size())) {
+					it->sums[i] += counters[i];
+				}
+			}
+		}
+		for (const auto& g : groups) {
+			TclObject dict;
+			for (auto i : xrange(g.sums.size())) {
+				dict.addDictKeyValue(g.first->getCounterName(i), g.sums[i]);
+			}
+			result.addDictKeyValue(g.first->getName(), dict);
+		}
+	} else {
+		throw SyntaxError();
+	}
+}
+
+string ProfileCommand::help(const vector<string>& /*tokens*/) const
+{
+	return "Internal profile counters (intended for openMSX developers).\n"
+	       "  profile on      start counting\n"
+	       "  profile off     stop counting\n"
+	       "  profile reset   set all counters to zero\n"
+	       "  profile report  return all counters as a dict (this is the default)\n";
+}
+
+void ProfileCommand::tabCompletion(vector<string>& tokens) const
+{
+	static constexpr const char* const subCmds[] = {
+		"on", "off", "reset", "report",
+	};
+	completeString(tokens, subCmds);
+}
+
+
 // class ConfigInfo
 
 ConfigInfo::ConfigInfo(InfoCommand& openMSXInfoCommand,
@@ -1172,6 +1307,33 @@ void SoftwareInfoTopic::execute(
 	                        "genmsxid",         romInfo->getGenMSXid());
 }
 
+
+// StartupProfileInfo
+
+StartupProfileInfo::StartupProfileInfo(InfoCommand& openMSXInfoCommand)
+	: InfoTopic(openMSXInfoCommand, "startup_profile")
+{
+}
+
+void StartupProfileInfo::execute(span<const TclObject> /*tokens*/,
+                                 TclObject& result) const
+{
+	result.addListElement(makeTclList("total",
+		StartupProfiler::getTotal() / 1000000.0));
+	for (const auto& e : StartupProfiler::getEntries()) {
+		result.addListElement(makeTclList(
+			e.name, int(e.depth), e.duration / 1000000.0));
+	}
+}
+
+string StartupProfileInfo::help(const vector<string>& /*tokens*/) const
+{
+	return "Returns how long (in seconds) the different phases of the "
+	       "openMSX startup took. The result is a list, the first element "
+	       "is {total <time>}, the other elements are {<phase> <nesting "
+	       "level> <time>}.";
+}
+
 string SoftwareInfoTopic::help(const vector<string>& /*tokens*/) const
 {
 	return "Returns information about the software "
@@ -47,10 +47,13 @@ class StoreMachineCommand;
 class RestoreMachineCommand;
 class GetClipboardCommand;
 class SetClipboardCommand;
+class ProfileCommand;
 class AviRecorder;
+class RawFrameRecorder;
 class ConfigInfo;
 class RealTimeInfo;
 class SoftwareInfoTopic;
+class StartupProfileInfo;
 template <typename T> class EnumSetting;
 
 extern int exitCode;
@@ -78,6 +81,7 @@ public:
 	void enterMainLoop();
 
 	RTScheduler& getRTScheduler() { return *rtScheduler; }
+	AfterCommand& getAfterCommand() { return *afterCommand; }
 	EventDistributor& getEventDistributor() { return *eventDistributor; }
 	GlobalCliComm& getGlobalCliComm() { return *globalCliComm; }
 	GlobalCommandController& getGlobalCommandController() { return *globalCommandController; }
@@ -129,6 +133,7 @@ private:
 	// various factors). Returns true when openMSX wants to continue
 	// running.
 	bool doOneIteration();
+	void addTclScriptsProfile();
 
 	void unpause();
 	void pause();
@@ -167,11 +172,14 @@ private:
 	std::unique_ptr<RestoreMachineCommand> restoreMachineCommand;
 	std::unique_ptr<GetClipboardCommand> getClipboardCommand;
 	std::unique_ptr<SetClipboardCommand> setClipboardCommand;
+	std::unique_ptr<ProfileCommand> profileCommand;
 	std::unique_ptr<AviRecorder> aviRecordCommand;
+	std::unique_ptr<RawFrameRecorder> rawFrameRecordCommand;
 	std::unique_ptr<ConfigInfo> extensionInfo;
 	std::unique_ptr<ConfigInfo> machineInfo;
 	std::unique_ptr<RealTimeInfo> realTimeInfo;
 	std::unique_ptr<SoftwareInfoTopic> softwareInfoTopic;
+	std::unique_ptr<StartupProfileInfo> startupProfileInfo;
 	std::unique_ptr<TclCallbackMessages> tclCallbackMessages;
 
 	// Locking rules for activeBoard access:
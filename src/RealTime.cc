@@ -100,6 +100,7 @@ void RealTime::internalSync(EmuTime::param time, bool allowSleep)
 				Timer::sleep(sleep); // request to sleep for 'sleep+sleepAdjust'
 				int64_t slept = Timer::getTime() - currentRealTime;
 				delta = sleep - slept; // actually slept for 'slept' us
+				totalSleep += slept;
 			}
 			const double ALPHA = 0.2;
 			sleepAdjust = sleepAdjust * (1 - ALPHA) + delta * ALPHA;
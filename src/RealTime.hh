@@ -43,6 +43,10 @@ public:
 	  */
 	bool timeLeft(uint64_t us, EmuTime::param time);
 
+	/** Total real time (in us) spent sleeping to stay in sync.
+	  */
+	uint64_t getSleepTime() const { return totalSleep; }
+
 	void resync();
 
 	void enable();
@@ -80,6 +84,7 @@ private:
 	uint64_t idealRealTime;
 	EmuTime emuTime;
 	double sleepAdjust;
+	uint64_t totalSleep = 0;
 	bool enabled;
 };
 
@@ -12,6 +12,7 @@ Schedulable::Schedulable(Scheduler& scheduler_)
 Schedulable::~Schedulable()
 {
 	removeSyncPoints();
+	scheduler.profileDeleted(*this);
 }
 
 void Schedulable::schedulerDeleted()
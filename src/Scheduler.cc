@@ -2,11 +2,18 @@
 #include "Schedulable.hh"
 #include "Thread.hh"
 #include "MSXCPU.hh"
+#include "MSXDevice.hh"
 #include "ranges.hh"
 #include "serialize.hh"
 #include "stl.hh"
 #include <cassert>
+#include <chrono>
 #include <iterator> // for back_inserter
+#include <memory>
+#include <typeinfo>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
 
 namespace openmsx {
 
@@ -35,6 +42,7 @@ void Scheduler::setSyncPoint(EmuTime::param time, Schedulable& device)
 {
 	assert(Thread::isMainThread());
 	assert(time >= scheduleTime);
+	if (unlikely(profiling)) ++getProfileEntry(device).syncPoints;
 
 	// Push sync point into queue.
 	queue.insert(SynchronizationPoint(time, &device),
@@ -92,6 +100,7 @@ void Scheduler::scheduleHelper(EmuTime::param limit, EmuTime next)
 {
 	assert(!scheduleInProgress);
 	scheduleInProgress = true;
+	bool first = true;
 	while (true) {
 		assert(scheduleTime <= next);
 		scheduleTime = next;
@@ -101,7 +110,12 @@ void Scheduler::scheduleHelper(EmuTime::param limit, EmuTime next)
 
 		queue.remove_front();
 
-		device->executeUntil(next);
+		if (likely(!profiling)) {
+			device->executeUntil(next);
+		} else {
+			executeProfiled(*device, next, first);
+			first = false;
+		}
 
 		next = getNext();
 		if (likely(next > limit)) break;
@@ -111,6 +125,78 @@ void Scheduler::scheduleHelper(EmuTime::param limit, EmuTime next)
 	cpu->setNextSyncPoint(next);
 }
 
+void Scheduler::setProfiling(bool enabled)
+{
+	if (enabled && !profiling) ++profileGeneration;
+	profiling = enabled;
+}
+
+static std::string getSchedulableName(const Schedulable& device)
+{
+	if (auto* msxDevice = dynamic_cast<const MSXDevice*>(&device)) {
+		return msxDevice->getName();
+	}
+	const char* name = typeid(device).name();
+#ifdef __GNUC__
+	int status = 0;
+	std::unique_ptr<char, decltype(&free)> demangled(
+		abi::__cxa_demangle(name, nullptr, nullptr, &status), &free);
+	if (status == 0) return demangled.get();
+#endif
+	return name;
+}
+
+Scheduler::ProfileEntry& Scheduler::getProfileEntry(const Schedulable& device)
+{
+	if (myProfileGeneration != profileGeneration) {
+		myProfileGeneration = profileGeneration;
+		profile.clear();
+		profileIndex.clear();
+	}
+	auto [it, inserted] = profileIndex.emplace(&device, profile.size());
+	if (inserted) {
+		// Take the name now, it's still needed after the Schedulable
+		// is deleted (then the dynamic type can't be looked at).
+		profile.emplace_back().name = getSchedulableName(device);
+	}
+	return profile[it->second];
+}
+
+void Scheduler::executeProfiled(Schedulable& device, EmuTime::param time, bool first)
+{
+	auto& entry = getProfileEntry(device);
+	if (first) ++entry.cpuExits;
+	++entry.executions;
+	// Remember the index, not the reference: executeUntil() may add
+	// entries. It may also delete the device, so don't look it up again.
+	auto index = size_t(&entry - profile.data());
+	auto generation = profileGeneration;
+	auto start = std::chrono::steady_clock::now();
+	device.executeUntil(time);
+	auto duration = std::chrono::steady_clock::now() - start;
+	if (generation != profileGeneration) return; // profile restarted
+	profile[index].time += uint64_t(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+void Scheduler::profileDeleted(const Schedulable& device)
+{
+	if (myProfileGeneration != profileGeneration) return;
+	auto it = profileIndex.find(&device);
+	if (it == profileIndex.end()) return;
+	profile[it->second].deleted = true;
+	profileIndex.erase(it);
+}
+
+const std::vector<Scheduler::ProfileEntry>& Scheduler::getProfile()
+{
+	if (myProfileGeneration != profileGeneration) {
+		myProfileGeneration = profileGeneration;
+		profile.clear();
+		profileIndex.clear();
+	}
+	return profile;
+}
 
 template <typename Archive>
 void SynchronizationPoint::serialize(Archive& ar, unsigned /*version*/)
@@ -3,7 +3,10 @@
 
 #include "EmuTime.hh"
 #include "SchedulerQueue.hh"
+#include "hash_map.hh"
 #include "likely.hh"
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace openmsx {
@@ -71,6 +74,24 @@ public:
 	template <typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
+	/** Statistics per Schedulable, only collected while profiling is
+	  * enabled (see 'machine_info scheduler_profile').
+	  */
+	struct ProfileEntry {
+		std::string name;        // device name or (demangled) type name
+		uint64_t syncPoints = 0; // number of setSyncPoint() calls
+		uint64_t cpuExits = 0;   // number of times the CPU loop was left for this Schedulable
+		uint64_t executions = 0; // number of executeUntil() calls
+		uint64_t time = 0;       // total time spent in executeUntil(), in ns
+		bool deleted = false;    // the Schedulable no longer exists
+	};
+
+	/** Enable/disable profiling (for all machines). Enabling clears the
+	  * previously collected statistics. */
+	static void setProfiling(bool enabled);
+	[[nodiscard]] static bool isProfiling() { return profiling; }
+	[[nodiscard]] const std::vector<ProfileEntry>& getProfile();
+
 private: // -> intended for Schedulable
 	friend class Schedulable;
 
@@ -105,8 +126,13 @@ private: // -> intended for Schedulable
 	 */
 	bool pendingSyncPoint(const Schedulable& device, EmuTime& result) const;
 
+	/** Called when a Schedulable gets destroyed. */
+	void profileDeleted(const Schedulable& device);
+
 private:
 	void scheduleHelper(EmuTime::param limit, EmuTime next);
+	ProfileEntry& getProfileEntry(const Schedulable& device);
+	void executeProfiled(Schedulable& device, EmuTime::param time, bool first);
 
 	/** Vector used as heap, not a priority queue because that
 	  * doesn't allow removal of non-top element.
@@ -115,6 +141,12 @@ private:
 	EmuTime scheduleTime = EmuTime::zero();
 	MSXCPU* cpu = nullptr;
 	bool scheduleInProgress = false;
+
+	static inline bool profiling = false;
+	static inline unsigned profileGeneration = 0;
+	unsigned myProfileGeneration = 0;
+	std::vector<ProfileEntry> profile;
+	hash_map<const Schedulable*, size_t> profileIndex; // index in 'profile'
 };
 
 } // namespace openmsx
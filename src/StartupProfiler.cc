@@ -0,0 +1,79 @@
+#include "StartupProfiler.hh"
+#include "Timer.hh"
+#include "strCat.hh"
+#include <algorithm>
+#include <cstdio>
+
+namespace openmsx::StartupProfiler {
+
+// Initialized before main() runs, close enough to the program start.
+static const uint64_t reference = Timer::getTime();
+static uint64_t endTime = 0;
+static std::vector<Entry> entries;
+static unsigned currentDepth = 0;
+static bool finished = false;
+
+constexpr size_t NOT_RECORDED = size_t(-1);
+
+Scope::Scope(std::string_view name)
+	: index(NOT_RECORDED), start(0)
+{
+	if (finished) return;
+	index = entries.size();
+	entries.push_back({std::string(name), currentDepth, 0});
+	++currentDepth;
+	start = Timer::getTime();
+}
+
+Scope::~Scope()
+{
+	if (index == NOT_RECORDED) return;
+	entries[index].duration = Timer::getTime() - start;
+	--currentDepth;
+}
+
+void add(std::string_view name, uint64_t duration)
+{
+	if (finished) return;
+	entries.push_back({std::string(name), currentDepth, duration});
+}
+
+void finish()
+{
+	if (finished) return;
+	finished = true;
+	endTime = Timer::getTime();
+}
+
+const std::vector<Entry>& getEntries()
+{
+	return entries;
+}
+
+uint64_t getTotal()
+{
+	return (finished ? endTime : Timer::getTime()) - reference;
+}
+
+static std::string formatMs(uint64_t us)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%9.1f ms", us / 1000.0);
+	return buf;
+}
+
+std::string report()
+{
+	std::string result = strCat("Startup profile, total ",
+	                            formatMs(getTotal()), ":\n");
+	for (const auto& e : entries) {
+		auto indent = 2 * (e.depth + 1);
+		auto width = std::max<size_t>(indent + e.name.size() + 1, 48);
+		strAppend(result, spaces(indent), e.name,
+		          spaces(width - indent - e.name.size()),
+		          formatMs(e.duration), '\n');
+	}
+	return result;
+}
+
+} // namespace openmsx::StartupProfiler
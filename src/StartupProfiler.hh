@@ -0,0 +1,59 @@
+#ifndef STARTUPPROFILER_HH
+#define STARTUPPROFILER_HH
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Measures how long the different phases of the openMSX startup take.
+ *
+ * Phases are marked with (possibly nested) Scope objects. Once startup is
+ * finished (see finish()) nothing is recorded anymore, so it's fine to also
+ * put a Scope in code that runs again later (e.g. switching machines). The
+ * result can be queried via 'openmsx_info startup_profile' or printed on
+ * stdout via the '-profile-startup' command line option.
+ */
+namespace openmsx::StartupProfiler {
+
+	struct Entry {
+		std::string name;
+		unsigned depth;    // nesting level, 0 for top-level phases
+		uint64_t duration; // in us
+	};
+
+	/** Measures the time between construction and destruction of this
+	  * object, nested in the currently active Scope (if any). */
+	class Scope
+	{
+	public:
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		explicit Scope(std::string_view name);
+		~Scope();
+
+	private:
+		size_t index;
+		uint64_t start;
+	};
+
+	/** Add a phase that was measured by some other means (e.g. in a Tcl
+	  * script), nested in the currently active Scope. */
+	void add(std::string_view name, uint64_t duration);
+
+	/** Startup is done, stop recording. */
+	void finish();
+
+	[[nodiscard]] const std::vector<Entry>& getEntries();
+
+	/** Time (in us) between program start and the call to finish(), or
+	  * till now if startup is not yet finished. */
+	[[nodiscard]] uint64_t getTotal();
+
+	/** Human readable (indented) overview of all phases. */
+	[[nodiscard]] std::string report();
+
+} // namespace openmsx::StartupProfiler
+
+#endif
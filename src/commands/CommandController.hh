@@ -44,6 +44,14 @@ public:
 	virtual TclObject executeCommand(const std::string& command,
 	                                 CliConnection* connection = nullptr) = 0;
 
+	/**
+	 * Execute the given command, a Tcl list of words. The words are passed
+	 * as-is (no substitutions, the list is not parsed as a script again),
+	 * so e.g. binary data in a bytearray object stays intact.
+	 */
+	virtual TclObject executeCommand(TclObject& command,
+	                                 CliConnection* connection = nullptr) = 0;
+
 	/** TODO
 	 */
 	virtual void   registerSetting(Setting& setting) = 0;
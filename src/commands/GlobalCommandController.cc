@@ -1,4 +1,7 @@
 #include "GlobalCommandController.hh"
+#include "AfterCommand.hh"
+#include "MSXCPU.hh"
+#include "MSXMotherBoard.hh"
 #include "Reactor.hh"
 #include "Setting.hh"
 #include "ProxyCommand.hh"
@@ -19,6 +22,7 @@
 #include "view.hh"
 #include "xrange.hh"
 #include "build-info.hh"
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -40,6 +44,8 @@ GlobalCommandController::GlobalCommandController(
 	, helpCmd(*this)
 	, tabCompletionCmd(*this)
 	, updateCmd(*this)
+	, protocolCmd(*this)
+	, batchCmd(*this)
 	, platformInfo(getOpenMSXInfoCommand())
 	, versionInfo (getOpenMSXInfoCommand())
 	, romInfoTopic(getOpenMSXInfoCommand())
@@ -305,6 +311,13 @@ TclObject GlobalCommandController::executeCommand(
 	return interpreter.execute(command);
 }
 
+TclObject GlobalCommandController::executeCommand(
+	TclObject& command, CliConnection* connection_)
+{
+	ScopedAssign sa(connection, connection_);
+	return command.executeCommand(interpreter);
+}
+
 void GlobalCommandController::source(const string& script)
 {
 	try {
@@ -535,9 +548,8 @@ static GlobalCliComm::UpdateType getType(const TclObject& name)
 	throw CommandException("No such update type: ", name.getString());
 }
 
-CliConnection& GlobalCommandController::UpdateCmd::getConnection()
+static CliConnection& getCliConnection(GlobalCommandController& controller)
 {
-	auto& controller = OUTER(GlobalCommandController, updateCmd);
 	if (auto* c = controller.getConnection()) {
 		return *c;
 	}
@@ -545,6 +557,11 @@ CliConnection& GlobalCommandController::UpdateCmd::getConnection()
 	                       "it's used from an external application.");
 }
 
+CliConnection& GlobalCommandController::UpdateCmd::getConnection()
+{
+	return getCliConnection(OUTER(GlobalCommandController, updateCmd));
+}
+
 void GlobalCommandController::UpdateCmd::execute(
 	span<const TclObject> tokens, TclObject& /*result*/)
 {
@@ -579,6 +596,114 @@ void GlobalCommandController::UpdateCmd::tabCompletion(vector<string>& tokens) c
 }
 
 
+
+// class ProtocolCmd
+
+GlobalCommandController::ProtocolCmd::ProtocolCmd(CommandController& commandController_)
+	: Command(commandController_, "openmsx_protocol")
+{
+}
+
+void GlobalCommandController::ProtocolCmd::execute(
+	span<const TclObject> tokens, TclObject& /*result*/)
+{
+	checkNumArgs(tokens, 2, "binary");
+	if (tokens[1] != "binary") {
+		throw SyntaxError();
+	}
+	getCliConnection(OUTER(GlobalCommandController, protocolCmd)).switchToBinary();
+}
+
+string GlobalCommandController::ProtocolCmd::help(const vector<string>& /*tokens*/) const
+{
+	return "Switch the connection of the external application that executes "
+	       "this command to the binary protocol. See "
+	       "doc/manual/openmsx-control.html.";
+}
+
+void GlobalCommandController::ProtocolCmd::tabCompletion(vector<string>& tokens) const
+{
+	static constexpr const char* const protocols[] = { "binary" };
+	completeString(tokens, protocols);
+}
+
+
+// class BatchCmd
+
+GlobalCommandController::BatchCmd::BatchCmd(CommandController& commandController_)
+	: Command(commandController_, "openmsx_batch")
+{
+}
+
+static TclObject executeBatch(Interpreter& interp, const TclObject& commands)
+{
+	TclObject result;
+	for (auto i : xrange(commands.getListLength(interp))) {
+		auto command = commands.getListIndex(interp, i);
+		try {
+			result.addListElement(makeTclList(
+				"ok", command.executeCommand(interp)));
+		} catch (CommandException& e) {
+			result.addListElement(makeTclList("nok", e.getMessage()));
+		}
+	}
+	return result;
+}
+
+void GlobalCommandController::BatchCmd::execute(
+	span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{2}, "?-at time id|-notify id? commands");
+	auto& controller = OUTER(GlobalCommandController, batchCmd);
+	auto& interp = getInterpreter();
+	if (tokens.size() == 2) {
+		// all commands in one go, no emulation in between
+		result = executeBatch(interp, tokens[1]);
+	} else if (tokens[1] == "-at") {
+		// The result is sent as a 'batch' update. This uses the same
+		// mechanism as 'after time', so the commands are executed on
+		// the first event loop iteration after that emulated time.
+		checkNumArgs(tokens, 5, Prefix{2}, "time id commands");
+		auto* motherBoard = controller.reactor.getMotherBoard();
+		if (!motherBoard) {
+			throw CommandException("No active MSX machine.");
+		}
+		// 'machine_info time' is relative to the last reset
+		auto at = motherBoard->getCPU().getResetTime() +
+		          EmuDuration(tokens[2].getDouble(interp));
+		auto now = motherBoard->getCurrentTime();
+		double delay = (at > now) ? (at - now).toDouble() : 0.0;
+		auto notify = makeTclList(
+			"openmsx_batch", "-notify", tokens[3], tokens[4]);
+		controller.reactor.getAfterCommand().addAfterTime(
+			*motherBoard, delay, notify);
+	} else if (tokens[1] == "-notify") {
+		checkNumArgs(tokens, 4, Prefix{2}, "id commands");
+		controller.cliComm.update(CliComm::BATCH, tokens[2].getString(),
+		                          executeBatch(interp, tokens[3]).getString());
+	} else {
+		throw SyntaxError();
+	}
+}
+
+string GlobalCommandController::BatchCmd::help(const vector<string>& /*tokens*/) const
+{
+	return "openmsx_batch <commands>\n"
+	       "  Executes all commands in the given list, without emulating "
+	       "in between. Returns a list with for each command a pair: "
+	       "'ok' and its result, or 'nok' and the error message.\n"
+	       "openmsx_batch -at <time> <id> <commands>\n"
+	       "  Executes the commands once the emulated time (as in "
+	       "'machine_info time') is reached, the result is sent as an "
+	       "update of type 'batch' with the given id as name.\n"
+	       "openmsx_batch -notify <id> <commands>\n"
+	       "  Executes the commands now, but sends the result as a "
+	       "'batch' update instead of returning it.\n"
+	       "Meant to reduce the number of round trips for external "
+	       "applications, see doc/manual/openmsx-control.html.";
+}
+
+
 // Platform info
 
 GlobalCommandController::PlatformInfo::PlatformInfo(InfoCommand& openMSXInfoCommand_)
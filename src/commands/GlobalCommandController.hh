@@ -69,6 +69,8 @@ public:
 	bool hasCommand(std::string_view command) const override;
 	TclObject executeCommand(const std::string& command,
 	                         CliConnection* connection = nullptr) override;
+	TclObject executeCommand(TclObject& command,
+	                         CliConnection* connection = nullptr) override;
 	void registerSetting(Setting& setting) override;
 	void unregisterSetting(Setting& setting) override;
 	CliComm& getCliComm() override;
@@ -135,6 +137,19 @@ private:
 		CliConnection& getConnection();
 	} updateCmd;
 
+	struct ProtocolCmd final : Command {
+		explicit ProtocolCmd(CommandController& commandController);
+		void execute(span<const TclObject> tokens, TclObject& result) override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	} protocolCmd;
+
+	struct BatchCmd final : Command {
+		explicit BatchCmd(CommandController& commandController);
+		void execute(span<const TclObject> tokens, TclObject& result) override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+	} batchCmd;
+
 	struct PlatformInfo final : InfoTopic {
 		explicit PlatformInfo(InfoCommand& openMSXInfoCommand);
 		void execute(span<const TclObject> tokens,
@@ -138,6 +138,12 @@ TclObject MSXCommandController::executeCommand(const string& command,
 	return globalCommandController.executeCommand(command, connection);
 }
 
+TclObject MSXCommandController::executeCommand(TclObject& command,
+                                               CliConnection* connection)
+{
+	return globalCommandController.executeCommand(command, connection);
+}
+
 CliComm& MSXCommandController::getCliComm()
 {
 	return motherboard.getMSXCliComm();
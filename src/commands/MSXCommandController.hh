@@ -66,6 +66,8 @@ public:
 	bool hasCommand(std::string_view command) const override;
 	TclObject executeCommand(const std::string& command,
 	                         CliConnection* connection = nullptr) override;
+	TclObject executeCommand(TclObject& command,
+	                         CliConnection* connection = nullptr) override;
 	void registerSetting(Setting& setting) override;
 	void unregisterSetting(Setting& setting) override;
 	CliComm& getCliComm() override;
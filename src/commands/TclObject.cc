@@ -113,6 +113,12 @@ span<const uint8_t> TclObject::getBinary() const
 	return {buf, size_t(length)};
 }
 
+bool TclObject::isByteArray() const
+{
+	static const Tcl_ObjType* byteArrayType = Tcl_GetObjType("bytearray");
+	return obj->typePtr == byteArrayType;
+}
+
 unsigned TclObject::getListLength(Interpreter& interp_) const
 {
 	auto* interp = interp_.interp;
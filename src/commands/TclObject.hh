@@ -145,6 +145,9 @@ public:
 	bool getBoolean (Interpreter& interp) const;
 	double getDouble(Interpreter& interp) const;
 	span<const uint8_t> getBinary() const;
+	/** Is this (internally) a byte array, e.g. the result of
+	  * 'debug read_block'. */
+	bool isByteArray() const;
 	unsigned getListLength(Interpreter& interp) const;
 	TclObject getListIndex(Interpreter& interp, unsigned index) const;
 	TclObject getDictValue(Interpreter& interp, const TclObject& key) const;
@@ -207,6 +210,9 @@ private:
 	static Tcl_Obj* newObj(unsigned u) {
 		return Tcl_NewIntObj(u);
 	}
+	static Tcl_Obj* newObj(uint64_t u) {
+		return Tcl_NewWideIntObj(Tcl_WideInt(u));
+	}
 	static Tcl_Obj* newObj(float f) {
 		return Tcl_NewDoubleObj(double(f));
 	}
@@ -10,11 +10,13 @@
 #include "CommandController.hh"
 #include "DeviceFactory.hh"
 #include "TclArgParser.hh"
+#include "hash_map.hh"
 #include "serialize.hh"
 #include "serialize_stl.hh"
 #include "unreachable.hh"
 #include "view.hh"
 #include "xrange.hh"
+#include "xxhash.hh"
 #include <cassert>
 #include <iostream>
 #include <memory>
@@ -217,15 +219,54 @@ static string getFilename(string_view type, string_view name)
 	}
 }
 
+// Parsing a machine or extension description (and locating it in the
+// system/user directories) is a significant part of the cost of creating a
+// MSXMotherBoard (e.g. for 'test_machine' or when querying 'openmsx_info
+// machines <name>' for all machines). The parsed result only depends on the
+// content of the file, so keep a pristine copy of each parsed tree around and
+// hand out copies of it. The (already resolved) file is re-stat()ed to detect
+// modifications, but we don't repeat the full search over all directories.
+// So a file that later gets shadowed by a file with the same name in a
+// directory with higher priority won't be noticed until restart.
+struct CachedConfig {
+	string filename;
+	time_t modificationDate;
+	XMLElement config;
+};
+static hash_map<string, CachedConfig, XXHasher> configCache;
+
+static const CachedConfig& getCachedConfig(string_view type, string_view name)
+{
+	auto key = strCat(type, '/', name);
+	if (auto* cached = lookup(configCache, key)) {
+		FileOperations::Stat st;
+		if (FileOperations::getStat(cached->filename, st) &&
+		    (FileOperations::getModificationDate(st) ==
+		     cached->modificationDate)) {
+			return *cached;
+		}
+	}
+
+	CachedConfig result;
+	result.filename = getFilename(type, name);
+	FileOperations::Stat st;
+	result.modificationDate = FileOperations::getStat(result.filename, st)
+	                        ? FileOperations::getModificationDate(st)
+	                        : time_t(-1);
+	result.config = loadHelper(result.filename);
+	return configCache.insert_or_assign(move(key), move(result)).first->second;
+}
+
 XMLElement HardwareConfig::loadConfig(string_view type, string_view name)
 {
-	return loadHelper(getFilename(type, name));
+	return getCachedConfig(type, name).config;
 }
 
 void HardwareConfig::load(string_view type)
 {
-	string filename = getFilename(type, hwName);
-	setConfig(loadHelper(filename));
+	const auto& cached = getCachedConfig(type, hwName);
+	const auto& filename = cached.filename;
+	setConfig(cached.config); // copy, the config gets modified later on
 
 	assert(!userName.empty());
 	const auto& dirname = FileOperations::getDirName(filename);
@@ -2,15 +2,28 @@
 #include "LocalFileReference.hh"
 #include "MSXException.hh"
 #include "StringOp.hh"
+#include "hash_map.hh"
 #include "ranges.hh"
 #include "stl.hh"
+#include "utf8_core.hh"
+#include "utf8_unchecked.hh"
 #include "xrange.hh"
 #include <SDL_ttf.h>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 using std::string;
 
+// TTF_GetFontKerningSizeGlyphs() was added in SDL2_ttf 2.0.14.
+#ifdef SDL_TTF_VERSION_ATLEAST
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+#define HAVE_KERNING_SIZE_GLYPHS 1
+#endif
+#endif
+
 namespace openmsx {
 
 class SDLTTF
@@ -23,11 +36,60 @@ private:
 	~SDLTTF();
 };
 
+// Glyphs of one font (file and size), rendered by SDL_ttf only once. Text is
+// composed from these glyphs, the result is the same as rendering the whole
+// text with SDL_ttf (TTF_RenderUTF8_Blended()). Also the size of a text can
+// be calculated without calling SDL_ttf.
+//
+// SDL_ttf only gives glyph metrics for the Basic Multilingual Plane, for
+// other characters (or invalid UTF-8) the callers fall back to rendering the
+// full text with SDL_ttf. Also for a byte-swapped BOM (older SDL_ttf versions
+// byte swap the characters that follow it), and for fonts with kerning
+// enabled when SDL_ttf can't tell the kerning of two glyphs (before 2.0.14).
+class TTFGlyphCache
+{
+public:
+	explicit TTFGlyphCache(TTF_Font* font);
+
+	// Returns false if the cache can't handle this text.
+	bool getSize(std::string_view text, unsigned& width, unsigned& height);
+	SDLSurfacePtr render(const std::vector<std::string_view>& lines,
+	                     unsigned lineSkip, byte r, byte g, byte b);
+
+private:
+	struct Glyph {
+		std::vector<uint8_t> alpha; // 'width' x 'height' coverage values
+		int width;   // of the 'alpha' bitmap
+		int offset;  // x-position of the bitmap relative to the pen position
+		int minx, maxx, advance;
+	};
+	struct PlacedGlyph {
+		const Glyph* glyph;
+		unsigned codepoint;
+		int pen; // x-position
+	};
+	struct Layout {
+		std::vector<PlacedGlyph> glyphs;
+		int minx, maxx;
+		int width() const { return maxx - minx; }
+	};
+
+	bool layout(std::string_view text, Layout& result);
+	bool addGlyph(unsigned codepoint);
+
+	TTF_Font* font;
+	// Glyphs are allocated separately: a Layout points to them, and those
+	// pointers must stay valid when the hash_map grows.
+	hash_map<unsigned, std::unique_ptr<Glyph>> glyphs;
+	std::vector<unsigned> codepoints; // reused buffer
+	int height;
+};
+
 class TTFFontPool
 {
 public:
 	static TTFFontPool& instance();
-	TTF_Font* get(const string& filename, int ptSize);
+	std::pair<TTF_Font*, TTFGlyphCache*> get(const string& filename, int ptSize);
 	void release(TTF_Font* font);
 
 private:
@@ -51,6 +113,7 @@ private:
 	struct FontInfo {
 		LocalFileReference file;
 		TTF_Font* font;
+		std::unique_ptr<TTFGlyphCache> glyphs;
 		std::string name;
 		int size;
 		int count;
@@ -80,6 +143,152 @@ SDLTTF& SDLTTF::instance()
 }
 
 
+// class TTFGlyphCache
+
+TTFGlyphCache::TTFGlyphCache(TTF_Font* font_)
+	: font(font_)
+	, height(TTF_FontHeight(font))
+{
+}
+
+bool TTFGlyphCache::addGlyph(unsigned codepoint)
+{
+	if (codepoint > 0xFFFF) return false;
+	auto ch = Uint16(codepoint);
+
+	auto glyph = std::make_unique<Glyph>();
+	int miny, maxy;
+	if (TTF_GlyphMetrics(font, ch, &glyph->minx, &glyph->maxx,
+	                     &miny, &maxy, &glyph->advance)) {
+		return false;
+	}
+	SDL_Color white = { 255, 255, 255, 0 };
+	SDLSurfacePtr surface(TTF_RenderGlyph_Blended(font, ch, white));
+	if (!surface) return false;
+
+	// This is a single character rendered by TTF_RenderUTF8_Blended(),
+	// which shifts the text to the right when it starts with a negative
+	// 'minx'.
+	glyph->offset = std::min(0, glyph->minx);
+	glyph->width = surface->w;
+	glyph->alpha.assign(size_t(glyph->width) * height, 0);
+	const auto* format = surface->format;
+	assert(format->BytesPerPixel == 4);
+	for (auto y : xrange(std::min(surface->h, height))) {
+		auto* line = reinterpret_cast<const uint32_t*>(
+			static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch);
+		for (auto x : xrange(glyph->width)) {
+			glyph->alpha[y * glyph->width + x] =
+				(line[x] & format->Amask) >> format->Ashift;
+		}
+	}
+	glyphs.emplace(codepoint, std::move(glyph));
+	return true;
+}
+
+bool TTFGlyphCache::layout(std::string_view text, Layout& result)
+{
+	if (!utf8::is_valid(text.begin(), text.end())) return false;
+	bool kerning = TTF_GetFontKerning(font) != 0;
+#ifndef HAVE_KERNING_SIZE_GLYPHS
+	if (kerning) return false;
+#endif
+	codepoints.clear();
+	for (auto it = text.begin(); it != text.end(); ) {
+		auto cp = utf8::unchecked::next(it);
+		// Like TTF_SizeUTF8(): byte order marks are not rendered.
+		if (cp == 0xFEFF) continue;
+		if (cp == 0xFFFE) return false;
+		codepoints.push_back(cp);
+	}
+	// first add all missing glyphs
+	for (auto cp : codepoints) {
+		if (!glyphs.contains(cp) && !addGlyph(cp)) return false;
+	}
+
+	// same calculation as TTF_SizeUTF8()
+	result.glyphs.clear();
+	result.minx = result.maxx = 0;
+	int x = 0;
+	unsigned prev = 0;
+	for (auto cp : codepoints) {
+		if (kerning && prev) {
+#ifdef HAVE_KERNING_SIZE_GLYPHS
+			x += TTF_GetFontKerningSizeGlyphs(font, Uint16(prev), Uint16(cp));
+#endif
+		}
+		const auto* glyphPtr = lookup(glyphs, cp);
+		assert(glyphPtr);
+		const auto* glyph = glyphPtr->get();
+		result.minx = std::min(result.minx, x + glyph->minx);
+		result.maxx = std::max(result.maxx, x + std::max(glyph->advance, glyph->maxx));
+		result.glyphs.push_back({glyph, cp, x});
+		x += glyph->advance;
+		prev = cp;
+	}
+	return true;
+}
+
+bool TTFGlyphCache::getSize(std::string_view text, unsigned& width, unsigned& height_)
+{
+	Layout l;
+	if (!layout(text, l)) return false;
+	width = l.width();
+	height_ = height;
+	return true;
+}
+
+SDLSurfacePtr TTFGlyphCache::render(const std::vector<std::string_view>& lines,
+                                    unsigned lineSkip, byte r, byte g, byte b)
+{
+	std::vector<Layout> layouts(lines.size());
+	int width = 1;
+	for (auto i : xrange(lines.size())) {
+		if (!layout(lines[i], layouts[i])) return SDLSurfacePtr(nullptr);
+		width = std::max(width, layouts[i].width());
+	}
+	// For the last line we don't include spacing between two lines.
+	auto totalHeight = int((lines.size() - 1) * lineSkip + height);
+
+	SDLSurfacePtr surface(SDL_CreateRGBSurface(SDL_SWSURFACE, width, totalHeight,
+			32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000));
+	if (!surface) {
+		throw MSXException("Couldn't allocate surface for text.");
+	}
+	// Like SDL_ttf: the whole surface has the text color, only the
+	// alpha channel shows the text.
+	uint32_t color = (r << 16) | (g << 8) | (b << 0);
+	auto* pixels = static_cast<uint8_t*>(surface->pixels);
+	for (auto y : xrange(totalHeight)) {
+		auto* line = reinterpret_cast<uint32_t*>(pixels + y * surface->pitch);
+		std::fill_n(line, width, color);
+	}
+
+	for (auto i : xrange(lines.size())) {
+		const auto& l = layouts[i];
+		for (const auto& [glyph, cp, pen] : l.glyphs) {
+			// Laying out the later lines may have added glyphs,
+			// the ones of the earlier lines must still be the same.
+			assert(lookup(glyphs, cp)->get() == glyph);
+			int x0 = pen + glyph->offset - l.minx;
+			for (auto y : xrange(height)) {
+				auto* line = reinterpret_cast<uint32_t*>(
+					pixels + (i * lineSkip + y) * surface->pitch);
+				const auto* alpha = &glyph->alpha[y * glyph->width];
+				for (auto x : xrange(glyph->width)) {
+					int dx = x0 + x;
+					if ((alpha[x] == 0) || (dx < 0) || (dx >= width)) continue;
+					// overlapping glyphs: keep the most opaque
+					uint32_t a = std::max<uint32_t>(line[dx] >> 24, alpha[x]);
+					line[dx] = color | (a << 24);
+				}
+			}
+		}
+	}
+	return surface;
+}
+
+
 // class TTFFontPool
 
 TTFFontPool::~TTFFontPool()
@@ -93,14 +302,15 @@ TTFFontPool& TTFFontPool::instance()
 	return oneInstance;
 }
 
-TTF_Font* TTFFontPool::get(const string& filename, int ptSize)
+std::pair<TTF_Font*, TTFGlyphCache*> TTFFontPool::get(
+	const string& filename, int ptSize)
 {
 	auto it = ranges::find_if(pool, [&](auto& info) {
 		return (info.name == filename) && (info.size == ptSize);
 	});
 	if (it != end(pool)) {
 		++it->count;
-		return it->font;
+		return {it->font, it->glyphs.get()};
 	}
 
 	SDLTTF::instance(); // init library
@@ -111,11 +321,13 @@ TTF_Font* TTFFontPool::get(const string& filename, int ptSize)
 		throw MSXException(TTF_GetError());
 	}
 	info.font = result;
+	info.glyphs = std::make_unique<TTFGlyphCache>(result);
 	info.name = filename;
 	info.size = ptSize;
 	info.count = 1;
+	auto* glyphs = info.glyphs.get();
 	pool.push_back(std::move(info));
-	return result;
+	return {result, glyphs};
 }
 
 void TTFFontPool::release(TTF_Font* font)
@@ -134,7 +346,7 @@ void TTFFontPool::release(TTF_Font* font)
 
 TTFFont::TTFFont(const std::string& filename, int ptSize)
 {
-	font = TTFFontPool::instance().get(filename, ptSize);
+	std::tie(font, glyphs) = TTFFontPool::instance().get(filename, ptSize);
 }
 
 TTFFont::~TTFFont()
@@ -155,6 +367,12 @@ SDLSurfacePtr TTFFont::render(std::string text, byte r, byte g, byte b) const
 	auto lines = StringOp::split(text, '\n');
 	assert(!lines.empty());
 
+	// Normally all characters are in the glyph cache, otherwise let
+	// SDL_ttf render the whole text.
+	if (auto surface = glyphs->render(lines, getHeight(), r, g, b)) {
+		return surface;
+	}
+
 	if (lines.size() == 1) {
 		// Special case for a single line: we can avoid the
 		// copy to an extra SDL_Surface
@@ -241,6 +459,7 @@ unsigned TTFFont::getWidth() const
 void TTFFont::getSize(const std::string& text,
                       unsigned& width, unsigned& height) const
 {
+	if (glyphs->getSize(text, width, height)) return;
 	if (TTF_SizeUTF8(static_cast<TTF_Font*>(font), text.c_str(),
 	                 reinterpret_cast<int*>(&width),
 	                 reinterpret_cast<int*>(&height))) {
@@ -8,6 +8,8 @@
 
 namespace openmsx {
 
+class TTFGlyphCache;
+
 class TTFFont
 {
 public:
@@ -32,14 +34,17 @@ public:
 	/** Move construct. */
 	TTFFont(TTFFont&& other) noexcept
 		: font(other.font)
+		, glyphs(other.glyphs)
 	{
 		other.font = nullptr;
+		other.glyphs = nullptr;
 	}
 
 	/** Move assignment. */
 	TTFFont& operator=(TTFFont&& other) noexcept
 	{
 		std::swap(font, other.font);
+		std::swap(glyphs, other.glyphs);
 		return *this;
 	}
 
@@ -51,6 +56,8 @@ public:
 	/** Render the given text to a new SDL_Surface.
 	  * The text must be UTF-8 encoded.
 	  * The result is a 32bpp RGBA SDL_Surface.
+	  * Each glyph is only rasterized once per font (file and size), the
+	  * text is composed from those cached glyphs.
 	  */
 	SDLSurfacePtr render(std::string text, byte r, byte g, byte b) const;
 
@@ -74,6 +81,7 @@ public:
 
 private:
 	void* font = nullptr;  // TTF_Font*
+	TTFGlyphCache* glyphs = nullptr; // shared with other users of 'font'
 };
 
 } // namespace openmsx
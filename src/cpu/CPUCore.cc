@@ -163,6 +163,8 @@
 #include "Scheduler.hh"
 #include "MSXMotherBoard.hh"
 #include "CliComm.hh"
+#include "CPUProfiler.hh"
+#include "CPUTraceBuffer.hh"
 #include "TclCallback.hh"
 #include "Dasm.hh"
 #include "Z80.hh"
@@ -279,6 +281,23 @@ struct CondPE { bool operator()(byte f) const { return  (f & V_FLAG) != 0; } };
 struct CondPO { bool operator()(byte f) const { return !(f & V_FLAG); } };
 struct CondTrue { bool operator()(byte /*f*/) const { return true; } };
 
+std::ostream& operator<<(std::ostream& os, EnumTypeName<CPUCoreCounters>)
+{
+	return os << "CPUCoreCounters";
+}
+std::ostream& operator<<(std::ostream& os, EnumValueName<CPUCoreCounters> evn)
+{
+	std::string_view names[size_t(CPUCoreCounters::NUM)] = {
+		"ExecuteSlow",
+		"AcceptNMI",
+		"AcceptIRQ",
+		"Halted",
+		"FastBatch",
+		"ExecuteCall",
+	};
+	return os << names[size_t(evn.e)];
+}
+
 template<class T> CPUCore<T>::CPUCore(
 		MSXMotherBoard& motherboard_, const string& name,
 		const BooleanSetting& traceSetting_,
@@ -312,6 +331,7 @@ template<class T> CPUCore<T>::CPUCore(
 	, exitLoop(false)
 	, tracingEnabled(traceSetting.getBoolean())
 	, isTurboR(motherboard.isTurboR())
+	, profileCounters(name)
 {
 	static_assert(!std::is_polymorphic_v<CPUCore<T>>,
 		"keep CPUCore non-virtual to keep PC at offset 0");
@@ -589,6 +609,12 @@ NEVER_INLINE byte CPUCore<T>::RDMEMslow(unsigned address, unsigned cc)
 	}
 	// uncacheable
 	readCacheLine[high] = reinterpret_cast<const byte*>(1);
+	if (const byte* ptr = interface->getWatchedReadPtr(address)) {
+		// only uncacheable because of a watchpoint on another address
+		T::template PRE_MEM<PRE_PB, POST_PB>(address);
+		T::template POST_MEM<       POST_PB>(address);
+		return *ptr;
+	}
 	T::template PRE_MEM<PRE_PB, POST_PB>(address);
 	EmuTime time = T::getTimeFast(cc);
 	scheduler.schedule(time);
@@ -694,6 +720,13 @@ NEVER_INLINE void CPUCore<T>::WRMEMslow(unsigned address, byte value, unsigned c
 	}
 	// uncacheable
 	writeCacheLine[high] = reinterpret_cast<byte*>(1);
+	if (byte* ptr = interface->getWatchedWritePtr(address)) {
+		// only uncacheable because of a watchpoint on another address
+		T::template PRE_MEM<PRE_PB, POST_PB>(address);
+		T::template POST_MEM<       POST_PB>(address);
+		*ptr = value;
+		return;
+	}
 	T::template PRE_MEM<PRE_PB, POST_PB>(address);
 	EmuTime time = T::getTimeFast(cc);
 	scheduler.schedule(time);
@@ -2433,15 +2466,74 @@ xx_cb: {
 	}
 }
 
+template<class T> void CPUCore<T>::setProfiler(CPUProfiler* profiler_)
+{
+	profiler = profiler_;
+	exitCPULoopSync(); // (re)select the fast or the slow execution loop
+}
+
+template<class T> void CPUCore<T>::setTraceBuffer(CPUTraceBuffer* traceBuffer_)
+{
+	traceBuffer = traceBuffer_;
+	exitCPULoopSync(); // (re)select the fast or the slow execution loop
+}
+
+// Not while fast-forwarding (e.g. replaying after a reverse jump), that would
+// count the same instructions multiple times.
+template<class T> inline bool CPUCore<T>::isProfiling() const
+{
+	return unlikely(profiler != nullptr) && !interface->isFastForward();
+}
+template<class T> inline void CPUCore<T>::profilePre()
+{
+	if (isProfiling()) {
+		profiler->pre(*interface, getPC(), getSP(), T::getTimeFast());
+	}
+}
+template<class T> inline void CPUCore<T>::profilePost()
+{
+	if (isProfiling()) {
+		profiler->post(*interface, getPC(), getSP(), T::getTimeFast());
+	}
+}
+
 template<class T> inline void CPUCore<T>::cpuTracePre()
 {
 	start_pc = getPC();
+	if (unlikely(traceBuffer != nullptr)) {
+		traceBufferPre();
+	}
 }
 template<class T> inline void CPUCore<T>::cpuTracePost()
 {
 	if (unlikely(tracingEnabled)) {
 		cpuTracePost_slow();
 	}
+	if (unlikely(traceBuffer != nullptr)) {
+		traceBufferPost();
+	}
+}
+template<class T> void CPUCore<T>::traceBufferPre()
+{
+	// Capture the instruction bytes before executing, the instruction
+	// may modify itself.
+	auto time = T::getTimeFast();
+	for (unsigned i = 0; i < 4; ++i) {
+		traceOpcode[i] = interface->peekMem(word(start_pc + i), time);
+	}
+}
+template<class T> void CPUCore<T>::traceBufferPost()
+{
+	if (interface->isFastForward()) return; // don't record replays twice
+	CPUTraceBuffer::Record r;
+	r.time = (T::getTimeFast() - EmuTime::zero()).length();
+	r.pc = start_pc;
+	r.af = getAF(); r.bc = getBC(); r.de = getDE(); r.hl = getHL();
+	r.ix = getIX(); r.iy = getIY(); r.sp = getSP();
+	memcpy(r.opcode, traceOpcode, sizeof(traceOpcode));
+	r.flags = T::isR800() ? CPUTraceBuffer::FLAG_R800 : 0;
+	r.pad[0] = r.pad[1] = r.pad[2] = 0;
+	traceBuffer->record(r);
 }
 template<class T> void CPUCore<T>::cpuTracePost_slow()
 {
@@ -2470,9 +2562,15 @@ template<class T> ExecIRQ CPUCore<T>::getExecIRQ() const
 
 template<class T> void CPUCore<T>::executeSlow(ExecIRQ execIRQ)
 {
+	profileCounters.tick(CPUCoreCounters::ExecuteSlow);
 	if (unlikely(execIRQ == ExecIRQ::NMI)) {
+		profileCounters.tick(CPUCoreCounters::AcceptNMI);
 		nmiEdge = false;
+		unsigned retPC = getPC();
 		nmi(); // NMI occured
+		if (isProfiling()) {
+			profiler->interrupt(*interface, retPC, getPC(), getSP());
+		}
 	} else if (unlikely(execIRQ == ExecIRQ::IRQ)) {
 		// normal interrupt
 		if (unlikely(prevWasLDAI())) {
@@ -2496,7 +2594,9 @@ template<class T> void CPUCore<T>::executeSlow(ExecIRQ execIRQ)
 			assert(getF() & V_FLAG);
 			setF(getF() & ~V_FLAG);
 		}
+		profileCounters.tick(CPUCoreCounters::AcceptIRQ);
 		IRQAccept.signal();
+		unsigned retPC = getPC();
 		switch (getIM()) {
 			case 0: irq0();
 				break;
@@ -2507,15 +2607,23 @@ template<class T> void CPUCore<T>::executeSlow(ExecIRQ execIRQ)
 			default:
 				UNREACHABLE;
 		}
+		if (isProfiling()) {
+			profiler->interrupt(*interface, retPC, getPC(), getSP());
+		}
 	} else if (unlikely(getHALT())) {
 		// in halt mode
+		profileCounters.tick(CPUCoreCounters::Halted);
+		profilePre();
 		incR(T::advanceHalt(T::haltStates(), scheduler.getNext()));
+		profilePost();
 		setSlowInstructions();
 	} else {
+		profilePre();
 		cpuTracePre();
 		assert(T::limitReached()); // we want only one instruction
 		executeInstructions();
 		endInstruction();
+		profilePost();
 
 		if (T::isR800()) {
 			if (unlikely(prev2WasCall()) && likely(!prevWasPopRet())) {
@@ -2541,6 +2649,7 @@ template<class T> void CPUCore<T>::execute(bool fastForward)
 	// won't trigger. It is possible we already are in break mode, but
 	// break is ignored in fast-forward mode.
 	assert(fastForward || !interface->isBreaked());
+	profileCounters.tick(CPUCoreCounters::ExecuteCall);
 	if (fastForward) {
 		interface->setFastForward(true);
 	}
@@ -2561,8 +2670,9 @@ template<class T> void CPUCore<T>::execute2(bool fastForward)
 	// deciding between executeFast() and executeSlow() (because a
 	// SyncPoint could set an IRQ and then we must choose executeSlow())
 	if (fastForward ||
-	    (!interface->anyBreakPoints() && !tracingEnabled)) {
-		// fast path, no breakpoints, no tracing
+	    (!interface->anyBreakPoints() && !tracingEnabled && !profiler &&
+	     !traceBuffer)) {
+		// fast path, no breakpoints, no tracing, no profiling
 		do {
 			if (slowInstructions) {
 				--slowInstructions;
@@ -2573,6 +2683,7 @@ template<class T> void CPUCore<T>::execute2(bool fastForward)
 					T::enableLimit(); // does CPUClock::sync()
 					if (likely(!T::limitReached())) {
 						// multiple instructions
+						profileCounters.tick(CPUCoreCounters::FastBatch);
 						executeInstructions();
 						// note: pipeline only shifted one
 						// step for multiple instructions
@@ -2586,11 +2697,13 @@ template<class T> void CPUCore<T>::execute2(bool fastForward)
 	} else {
 		do {
 			if (slowInstructions == 0) {
+				profilePre();
 				cpuTracePre();
 				assert(T::limitReached()); // only one instruction
 				executeInstructions();
 				endInstruction();
 				cpuTracePost();
+				profilePost();
 			} else {
 				--slowInstructions;
 				executeSlow(getExecIRQ());
@@ -9,6 +9,7 @@
 #include "IntegerSetting.hh"
 #include "serialize_meta.hh"
 #include "openmsx.hh"
+#include "ProfileCounters.hh"
 #include "span.hh"
 #include <atomic>
 #include <string>
@@ -16,6 +17,8 @@
 namespace openmsx {
 
 class MSXCPUInterface;
+class CPUProfiler;
+class CPUTraceBuffer;
 class Scheduler;
 class MSXMotherBoard;
 class TclCallback;
@@ -45,6 +48,18 @@ enum class ExecIRQ {
 	NONE, // about to execute regular instruction
 };
 
+enum class CPUCoreCounters {
+	ExecuteSlow,   // single instruction (or IRQ/NMI/HALT) on the slow path
+	AcceptNMI,
+	AcceptIRQ,
+	Halted,        // executeSlow() while in HALT mode
+	FastBatch,     // batch of instructions on the fast path
+	ExecuteCall,   // call to execute(), typically once per CPU switch
+	NUM // must be last
+};
+std::ostream& operator<<(std::ostream& os, EnumTypeName<CPUCoreCounters>);
+std::ostream& operator<<(std::ostream& os, EnumValueName<CPUCoreCounters> evn);
+
 template<class CPU_POLICY>
 class CPUCore final : public CPUBase, public CPURegs, public CPU_POLICY
 {
@@ -55,6 +70,14 @@ public:
 
 	void setInterface(MSXCPUInterface* interf) { interface = interf; }
 
+	/** Start (non-nullptr) or stop (nullptr) per-instruction profiling.
+	  * @see CPUProfiler */
+	void setProfiler(CPUProfiler* profiler);
+
+	/** Start (non-nullptr) or stop (nullptr) recording a binary trace of
+	  * all executed instructions. @see CPUTraceBuffer */
+	void setTraceBuffer(CPUTraceBuffer* traceBuffer);
+
 	/**
 	 * Reset the CPU.
 	 */
@@ -167,10 +190,25 @@ private:
 	/** 'normal' Z80 and Z80 in a turboR behave slightly different */
 	const bool isTurboR;
 
+	RuntimeProfileCounters<CPUCoreCounters> profileCounters;
+
+	/** Non-nullptr while profiling, forces the slow execution loop. */
+	CPUProfiler* profiler = nullptr;
+
+	/** Non-nullptr while recording a binary trace, also forces the slow
+	  * execution loop. */
+	CPUTraceBuffer* traceBuffer = nullptr;
+	byte traceOpcode[4];
+
+	inline bool isProfiling() const;
+	inline void profilePre();
+	inline void profilePost();
 
 	inline void cpuTracePre();
 	inline void cpuTracePost();
 	void cpuTracePost_slow();
+	void traceBufferPre();
+	void traceBufferPost();
 
 	inline byte READ_PORT(unsigned port, unsigned cc);
 	inline void WRITE_PORT(unsigned port, byte value, unsigned cc);
@@ -0,0 +1,232 @@
+#include "CPUProfiler.hh"
+#include "MSXCPUInterface.hh"
+#include "MSXMemoryMapperBase.hh"
+#include "ranges.hh"
+#include "strCat.hh"
+#include "view.hh"
+#include "xrange.hh"
+#include <ostream>
+#include <typeinfo>
+
+namespace openmsx {
+
+// Layout of an 'addrKey':
+//   bits  0-15: address
+//   bits 16-17: primary slot
+//   bits 18-19: secondary slot (only when EXPANDED)
+//   bit     20: EXPANDED
+//   bit     21: HAS_SEGMENT
+//   bits 24-31: memory mapper segment (only when HAS_SEGMENT)
+constexpr uint32_t EXPANDED    = 1 << 20;
+constexpr uint32_t HAS_SEGMENT = 1 << 21;
+constexpr uint32_t ROOT = ~0u;
+constexpr size_t MAX_STACK_DEPTH = 256;
+
+static constexpr uint64_t makeKey(uint32_t hi, uint32_t lo)
+{
+	return (uint64_t(hi) << 32) | lo;
+}
+
+CPUProfiler::CPUProfiler(std::string name_)
+	: name(std::move(name_))
+{
+	clear();
+}
+
+void CPUProfiler::clear()
+{
+	nodes.assign(1, Node{ROOT, ROOT, ROOT, 0});
+	children.clear();
+	costs.clear();
+	stack.clear();
+	current = 0;
+}
+
+uint32_t CPUProfiler::getAddrKey(MSXCPUInterface& interface, unsigned pc)
+{
+	int page = pc >> 14;
+	int ps = interface.getPrimarySlot(page);
+	uint32_t key = pc | (ps << 16);
+	if (interface.isExpanded(ps)) {
+		key |= EXPANDED | (interface.getSecondarySlot(page) << 18);
+	}
+	// Only the segment of a memory mapper is taken into account. ROM
+	// mappers don't have a common interface to query the selected bank.
+	// The dynamic_cast is only redone when the visible device changes.
+	// Also compare the type: a removed device can be replaced by another
+	// one at the same address (same address and type gives the same
+	// result).
+	auto* device = interface.getVisibleMSXDevice(page);
+	auto& cache = pageCache[page];
+	if ((device != cache.device) || (typeid(*device) != *cache.type)) {
+		cache.device = device;
+		cache.type = &typeid(*device);
+		cache.mapper = dynamic_cast<MSXMemoryMapperBase*>(device);
+	}
+	if (cache.mapper) {
+		key |= HAS_SEGMENT | (cache.mapper->getSelectedSegment(page) << 24);
+	}
+	return key;
+}
+
+void CPUProfiler::pre(MSXCPUInterface& interface, unsigned pc, unsigned sp,
+                      EmuTime::param time)
+{
+	startTime = time;
+	startKey = getAddrKey(interface, pc);
+	startSP = sp;
+	startOpcode = interface.peekMem(pc, time);
+}
+
+void CPUProfiler::post(MSXCPUInterface& interface, unsigned pc, unsigned sp,
+                       EmuTime::param time)
+{
+	auto& cost = costs[makeKey(current, startKey)];
+	cost.count += 1;
+	cost.ticks += (time - startTime).length();
+
+	// Returns (and other ways to discard the return address, like
+	// 'pop hl ; jp (hl)' or resetting the stack pointer) are detected by
+	// the stack pointer moving above the pushed return address.
+	while (!stack.empty() && (stack.back().sp < sp)) {
+		current = nodes[stack.back().node].parent;
+		stack.pop_back();
+	}
+
+	bool isCall = (startOpcode == 0xCD) ||          // call nn
+	              ((startOpcode & 0xC7) == 0xC4) || // call cc,nn
+	              ((startOpcode & 0xC7) == 0xC7);   // rst n
+	if (isCall && (sp == uint16_t(startSP - 2))) {
+		enter(getAddrKey(interface, pc), startKey, sp);
+	}
+}
+
+void CPUProfiler::interrupt(MSXCPUInterface& interface, unsigned retPC,
+                            unsigned pc, unsigned sp)
+{
+	enter(getAddrKey(interface, pc), getAddrKey(interface, retPC), sp);
+}
+
+void CPUProfiler::enter(uint32_t func, uint32_t callSite, unsigned sp)
+{
+	if (stack.size() == MAX_STACK_DEPTH) return; // keep charging the caller
+
+	auto key = makeKey(current, func);
+	auto it = children.find(key);
+	uint32_t node;
+	if (it != children.end()) {
+		node = it->second;
+	} else {
+		node = uint32_t(nodes.size());
+		nodes.push_back(Node{current, func, callSite, 0});
+		children.emplace(key, node);
+	}
+	nodes[node].callSite = callSite;
+	nodes[node].calls += 1;
+	stack.push_back(Frame{node, uint16_t(sp)});
+	current = node;
+}
+
+std::vector<CPUProfiler::FlatEntry> CPUProfiler::getFlat() const
+{
+	hash_map<uint32_t, FlatEntry> flat;
+	for (const auto& [key, cost] : costs) {
+		auto addrKey = uint32_t(key);
+		auto& e = flat[addrKey];
+		e.addrKey = addrKey;
+		e.count += cost.count;
+		e.ticks += cost.ticks;
+	}
+	std::vector<FlatEntry> result;
+	result.reserve(flat.size());
+	for (const auto& p : flat) result.push_back(p.second);
+	ranges::sort(result, [](const FlatEntry& x, const FlatEntry& y) {
+		return x.ticks > y.ticks; });
+	return result;
+}
+
+std::string CPUProfiler::formatAddrKey(uint32_t addrKey)
+{
+	std::string result = strCat("slot", (addrKey >> 16) & 3);
+	if (addrKey & EXPANDED) strAppend(result, '-', (addrKey >> 18) & 3);
+	if (addrKey & HAS_SEGMENT) strAppend(result, ":seg", addrKey >> 24);
+	strAppend(result, ':', hex_string<4>(addrKey & 0xFFFF));
+	return result;
+}
+
+uint64_t CPUProfiler::ticksToCycles(uint64_t ticks, unsigned freq)
+{
+	return uint64_t(double(ticks) * freq / MAIN_FREQ + 0.5);
+}
+
+std::string CPUProfiler::getStackString(uint32_t node) const
+{
+	std::vector<uint32_t> path;
+	for (/**/; node != 0; node = nodes[node].parent) path.push_back(node);
+	std::string result = name;
+	for (auto n : view::reverse(path)) {
+		strAppend(result, ';', formatAddrKey(nodes[n].func));
+	}
+	return result;
+}
+
+void CPUProfiler::writeCallgrind(std::ostream& os, unsigned freq) const
+{
+	auto funcName = [&](uint32_t node) {
+		return (node == 0) ? name : formatAddrKey(nodes[node].func);
+	};
+
+	// exclusive costs per node, inclusive costs are the sum over the subtree
+	std::vector<std::vector<std::pair<uint32_t, Cost>>> exclusive(nodes.size());
+	std::vector<Cost> inclusive(nodes.size());
+	for (const auto& [key, cost] : costs) {
+		auto node = uint32_t(key >> 32);
+		exclusive[node].emplace_back(uint32_t(key), cost);
+		inclusive[node].count += cost.count;
+		inclusive[node].ticks += cost.ticks;
+	}
+	// children always have a higher index than their parent
+	for (auto n = nodes.size() - 1; n > 0; --n) {
+		auto p = nodes[n].parent;
+		inclusive[p].count += inclusive[n].count;
+		inclusive[p].ticks += inclusive[n].ticks;
+	}
+	std::vector<std::vector<uint32_t>> childList(nodes.size());
+	for (auto n : xrange(size_t(1), nodes.size())) {
+		childList[nodes[n].parent].push_back(uint32_t(n));
+	}
+
+	os << "ob=" << name << '\n';
+	for (auto n : xrange(nodes.size())) {
+		if (exclusive[n].empty() && childList[n].empty()) continue;
+		os << "fn=" << funcName(uint32_t(n)) << '\n';
+		for (const auto& [addrKey, cost] : exclusive[n]) {
+			os << strCat("0x", hex_string<4>(addrKey & 0xFFFF), ' ',
+			             cost.count, ' ', ticksToCycles(cost.ticks, freq), '\n');
+		}
+		for (auto c : childList[n]) {
+			const auto& child = nodes[c];
+			os << strCat("cfn=", funcName(c), '\n',
+			             "calls=", child.calls,
+			             " 0x", hex_string<4>(child.func & 0xFFFF), '\n',
+			             "0x", hex_string<4>(child.callSite & 0xFFFF), ' ',
+			             inclusive[c].count, ' ',
+			             ticksToCycles(inclusive[c].ticks, freq), '\n');
+		}
+	}
+}
+
+void CPUProfiler::writeFolded(std::ostream& os, unsigned freq) const
+{
+	std::vector<std::string> stackStrings(nodes.size());
+	for (const auto& [key, cost] : costs) {
+		auto node = uint32_t(key >> 32);
+		auto cycles = ticksToCycles(cost.ticks, freq);
+		if (cycles == 0) continue;
+		auto& s = stackStrings[node];
+		if (s.empty()) s = getStackString(node);
+		os << s << ';' << formatAddrKey(uint32_t(key)) << ' ' << cycles << '\n';
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,119 @@
+#ifndef CPUPROFILER_HH
+#define CPUPROFILER_HH
+
+#include "EmuTime.hh"
+#include "hash_map.hh"
+#include "openmsx.hh"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace openmsx {
+
+class MSXCPUInterface;
+class MSXDevice;
+class MSXMemoryMapperBase;
+
+/** Collects per-address execution statistics for one CPU (Z80 or R800).
+ *
+ * For each executed instruction the number of executions and the number of
+ * (emulated) clock ticks are accumulated. Addresses are qualified with the
+ * slot (and, for memory mapper RAM, the segment) that was visible at that
+ * moment, so that code in different slots/segments is kept apart.
+ *
+ * A shadow call stack is maintained (CALL/RST and accepted interrupts push
+ * a frame, frames are popped as soon as the stack pointer moves above them)
+ * so that the result can also be exported as a call graph (callgrind) or as
+ * stack samples (flamegraph 'folded' format).
+ *
+ * While profiling is active the CPU executes one instruction at a time (like
+ * when tracing). This makes emulation slower in real time, but emulated
+ * timing is not affected.
+ */
+class CPUProfiler
+{
+public:
+	struct FlatEntry {
+		uint32_t addrKey;
+		uint64_t count;
+		uint64_t ticks; // in EmuDuration units
+	};
+
+	explicit CPUProfiler(std::string name);
+
+	[[nodiscard]] const std::string& getName() const { return name; }
+	[[nodiscard]] bool empty() const { return costs.empty(); }
+	void clear();
+
+	/** Called right before/after a single instruction (or a HALT/IRQ
+	  * step) is executed. */
+	void pre(MSXCPUInterface& interface, unsigned pc, unsigned sp, EmuTime::param time);
+	void post(MSXCPUInterface& interface, unsigned pc, unsigned sp, EmuTime::param time);
+	/** Called when the CPU accepted an IRQ or NMI, 'retPC' is the
+	  * address of the interrupted instruction, the (new) pc and sp point
+	  * to the interrupt routine and the pushed return address. */
+	void interrupt(MSXCPUInterface& interface, unsigned retPC,
+	               unsigned pc, unsigned sp);
+
+	/** Costs per address (summed over all call stacks), most expensive
+	  * first. */
+	[[nodiscard]] std::vector<FlatEntry> getFlat() const;
+
+	/** Write the 'ob=' section of a callgrind file (the caller must write
+	  * the header). Costs are converted to CPU cycles using 'freq'. */
+	void writeCallgrind(std::ostream& os, unsigned freq) const;
+	/** Write all stack samples in the 'folded' format of flamegraph.pl,
+	  * weighted by CPU cycles. */
+	void writeFolded(std::ostream& os, unsigned freq) const;
+
+	[[nodiscard]] static std::string formatAddrKey(uint32_t addrKey);
+	[[nodiscard]] static uint64_t ticksToCycles(uint64_t ticks, unsigned freq);
+
+private:
+	struct Node {
+		uint32_t parent;
+		uint32_t func;     // addrKey of the entry point
+		uint32_t callSite; // addrKey of the (last) call instruction
+		uint64_t calls;
+	};
+	struct Frame {
+		uint32_t node;
+		uint16_t sp;
+	};
+	struct Cost {
+		uint64_t count = 0;
+		uint64_t ticks = 0;
+	};
+
+	[[nodiscard]] uint32_t getAddrKey(MSXCPUInterface& interface, unsigned pc);
+	void enter(uint32_t func, uint32_t callSite, unsigned sp);
+	[[nodiscard]] std::string getStackString(uint32_t node) const;
+
+	const std::string name;
+	std::vector<Node> nodes; // nodes[0] is the root
+	hash_map<uint64_t, uint32_t> children; // (parent, func) -> node
+	hash_map<uint64_t, Cost> costs;        // (node, addrKey) -> cost
+	std::vector<Frame> stack;
+	uint32_t current = 0;
+
+	// state between pre() and post()
+	EmuTime startTime = EmuTime::zero();
+	uint32_t startKey = 0;
+	uint16_t startSP = 0;
+	byte startOpcode = 0;
+
+	// per page: the last visible device, and that device as a memory
+	// mapper (or nullptr)
+	struct PageCache {
+		const MSXDevice* device = nullptr;
+		const std::type_info* type = nullptr;
+		MSXMemoryMapperBase* mapper = nullptr;
+	};
+	PageCache pageCache[4];
+};
+
+} // namespace openmsx
+
+#endif
@@ -0,0 +1,83 @@
+#include "CPUTraceBuffer.hh"
+#include "Dasm.hh"
+#include "EmuDuration.hh"
+#include "File.hh"
+#include "MSXException.hh"
+#include "strCat.hh"
+#include <cassert>
+#include <cstring>
+
+namespace openmsx {
+
+CPUTraceBuffer::CPUTraceBuffer(size_t capacity_)
+	: buffer(capacity_)
+{
+	assert(capacity_ != 0);
+}
+
+std::vector<CPUTraceBuffer::Record> CPUTraceBuffer::getLast(size_t count) const
+{
+	count = std::min(count, size());
+	std::vector<Record> result;
+	result.reserve(count);
+	size_t start = (next + buffer.size() - count) % buffer.size();
+	for (size_t i = 0; i < count; ++i) {
+		result.push_back(buffer[(start + i) % buffer.size()]);
+	}
+	return result;
+}
+
+void CPUTraceBuffer::save(const std::string& filename) const
+{
+	auto records = getLast(size());
+	uint64_t num = records.size();
+	File file(filename, File::TRUNCATE);
+	file.write(MAGIC, sizeof(MAGIC));
+	file.write(&num, sizeof(num));
+	file.write(records.data(), num * sizeof(Record));
+}
+
+std::vector<CPUTraceBuffer::Record> CPUTraceBuffer::load(const std::string& filename)
+{
+	File file(filename);
+	auto fileSize = file.getSize();
+	char magic[sizeof(MAGIC)];
+	uint64_t num = 0;
+	constexpr size_t HEADER_SIZE = sizeof(magic) + sizeof(num);
+	if (fileSize >= HEADER_SIZE) {
+		file.read(magic, sizeof(magic));
+		file.read(&num, sizeof(num));
+	}
+	if ((fileSize < HEADER_SIZE) || (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)) {
+		throw MSXException("Not an openMSX CPU trace file: ", filename);
+	}
+	// check before multiplying, a corrupt 'num' could overflow
+	auto maxNum = (fileSize - HEADER_SIZE) / sizeof(Record);
+	if ((num > maxNum) || ((fileSize - HEADER_SIZE) != (num * sizeof(Record)))) {
+		throw MSXException("Corrupt openMSX CPU trace file: ", filename);
+	}
+	std::vector<Record> result(num);
+	file.read(result.data(), num * sizeof(Record));
+	return result;
+}
+
+std::string CPUTraceBuffer::format(const Record& r, unsigned z80Freq, unsigned r800Freq)
+{
+	bool r800 = r.flags & FLAG_R800;
+	auto freq = r800 ? r800Freq : z80Freq;
+	auto cycles = uint64_t(double(r.time) * freq / MAIN_FREQ + 0.5);
+	std::string dasmOutput;
+	dasm(r.opcode, r.pc, dasmOutput);
+	return strCat(cycles, (r800 ? " R800 " : " Z80 "),
+	              hex_string<4>(r.pc),
+	              " : ", dasmOutput,
+	              " AF=", hex_string<4>(r.af),
+	              " BC=", hex_string<4>(r.bc),
+	              " DE=", hex_string<4>(r.de),
+	              " HL=", hex_string<4>(r.hl),
+	              " IX=", hex_string<4>(r.ix),
+	              " IY=", hex_string<4>(r.iy),
+	              " SP=", hex_string<4>(r.sp));
+}
+
+} // namespace openmsx
@@ -0,0 +1,76 @@
+#ifndef CPUTRACEBUFFER_HH
+#define CPUTRACEBUFFER_HH
+
+#include "openmsx.hh"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+/** Fixed-size ring buffer with a binary record per executed instruction.
+ *
+ * This is the fast alternative for the (textual) 'cputrace' setting: only
+ * raw data is stored while emulating, disassembling and formatting is done
+ * afterwards (see format()). So it's possible to capture millions of
+ * instructions, for example the ones right before a crash.
+ */
+class CPUTraceBuffer
+{
+public:
+	struct Record {
+		uint64_t time;   // EmuTime (in MAIN_FREQ ticks) after the instruction
+		word pc;         // address of the instruction
+		word af, bc, de, hl, ix, iy, sp; // registers after the instruction
+		byte opcode[4];  // the (max 4) instruction bytes, as they were executed
+		byte flags;      // R800 or not
+		byte pad[3];
+	};
+	static_assert(sizeof(Record) == 32);
+	static constexpr byte FLAG_R800 = 1;
+
+	/** File layout of save()/load():
+	  *   char    magic[16]   "openMSX trace 1"
+	  *   uint64  numRecords
+	  *   Record  records[numRecords] (oldest first)
+	  * All integers in host byte order. */
+	static constexpr char MAGIC[16] = "openMSX trace 1";
+
+	explicit CPUTraceBuffer(size_t capacity);
+
+	void record(const Record& r) {
+		buffer[next] = r;
+		if (++next == buffer.size()) next = 0;
+		++total;
+	}
+
+	[[nodiscard]] size_t capacity() const { return buffer.size(); }
+	[[nodiscard]] size_t size() const { return std::min<uint64_t>(total, buffer.size()); }
+	/** Total number of recorded instructions (including the ones that
+	  * were already overwritten). */
+	[[nodiscard]] uint64_t getTotal() const { return total; }
+	void clear() { next = 0; total = 0; }
+
+	/** The last 'count' records, oldest first. */
+	[[nodiscard]] std::vector<Record> getLast(size_t count) const;
+
+	/** Throws MSXException on error. */
+	void save(const std::string& filename) const;
+	[[nodiscard]] static std::vector<Record> load(const std::string& filename);
+
+	/** One line of text per record (disassembly + registers), the same
+	  * format as the 'cputrace' setting, prefixed with the time in CPU
+	  * cycles. */
+	[[nodiscard]] static std::string format(const Record& r, unsigned z80Freq,
+	                                        unsigned r800Freq);
+
+private:
+	std::vector<Record> buffer;
+	size_t next = 0;
+	uint64_t total = 0;
+};
+
+} // namespace openmsx
+
+#endif
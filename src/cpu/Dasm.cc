@@ -15,35 +15,35 @@ static int abs(unsigned char a)
 	return (a & 128) ? (256 - a) : a;
 }
 
-unsigned dasm(const MSXCPUInterface& interf, word pc, byte buf[4],
-              std::string& dest, EmuTime::param time)
+template<typename FetchByte>
+static unsigned dasmImpl(FetchByte fetch, word pc, byte buf[4], std::string& dest)
 {
 	const char* s;
 	unsigned i = 0;
 	const char* r = nullptr;
 
-	buf[0] = interf.peekMem(pc, time);
+	buf[0] = fetch(pc);
 	switch (buf[0]) {
 		case 0xCB:
-			buf[1] = interf.peekMem(pc + 1, time);
+			buf[1] = fetch(pc + 1);
 			s = mnemonic_cb[buf[1]];
 			i = 2;
 			break;
 		case 0xED:
-			buf[1] = interf.peekMem(pc + 1, time);
+			buf[1] = fetch(pc + 1);
 			s = mnemonic_ed[buf[1]];
 			i = 2;
 			break;
 		case 0xDD:
 		case 0xFD:
 			r = (buf[0] == 0xDD) ? "ix" : "iy";
-			buf[1] = interf.peekMem(pc + 1, time);
+			buf[1] = fetch(pc + 1);
 			if (buf[1] != 0xcb) {
 				s = mnemonic_xx[buf[1]];
 				i = 2;
 			} else {
-				buf[2] = interf.peekMem(pc + 2, time);
-				buf[3] = interf.peekMem(pc + 3, time);
+				buf[2] = fetch(pc + 2);
+				buf[3] = fetch(pc + 3);
 				s = mnemonic_xx_cb[buf[3]];
 				i = 4;
 			}
@@ -56,25 +56,25 @@ unsigned dasm(const MSXCPUInterface& interf, word pc, byte buf[4],
 	for (int j = 0; s[j]; ++j) {
 		switch (s[j]) {
 		case 'B':
-			buf[i] = interf.peekMem(pc + i, time);
+			buf[i] = fetch(pc + i);
 			strAppend(dest, '#', hex_string<2>(
 				static_cast<uint16_t>(buf[i])));
 			i += 1;
 			break;
 		case 'R':
-			buf[i] = interf.peekMem(pc + i, time);
+			buf[i] = fetch(pc + i);
 			strAppend(dest, '#', hex_string<4>(
 				pc + 2 + static_cast<int8_t>(buf[i])));
 			i += 1;
 			break;
 		case 'W':
-			buf[i + 0] = interf.peekMem(pc + i + 0, time);
-			buf[i + 1] = interf.peekMem(pc + i + 1, time);
+			buf[i + 0] = fetch(pc + i + 0);
+			buf[i + 1] = fetch(pc + i + 1);
 			strAppend(dest, '#', hex_string<4>(buf[i] + buf[i + 1] * 256));
 			i += 2;
 			break;
 		case 'X':
-			buf[i] = interf.peekMem(pc + i, time);
+			buf[i] = fetch(pc + i);
 			strAppend(dest, '(', r, sign(buf[i]), '#',
 			     hex_string<2>(abs(buf[i])), ')');
 			i += 1;
@@ -111,4 +111,20 @@ unsigned dasm(const MSXCPUInterface& interf, word pc, byte buf[4],
 	return i;
 }
 
+unsigned dasm(const MSXCPUInterface& interf, word pc, byte buf[4],
+              std::string& dest, EmuTime::param time)
+{
+	return dasmImpl([&](word addr) { return interf.peekMem(addr, time); },
+	                pc, buf, dest);
+}
+
+unsigned dasm(span<const byte> opcode, word pc, std::string& dest)
+{
+	byte buf[4];
+	return dasmImpl([&](word addr) -> byte {
+			word i = addr - pc;
+			return (i < opcode.size()) ? opcode[i] : 0;
+		}, pc, buf, dest);
+}
+
 } // namespace openmsx
@@ -3,6 +3,7 @@
 
 #include "EmuTime.hh"
 #include "openmsx.hh"
+#include "span.hh"
 #include <string>
 
 namespace openmsx {
@@ -21,6 +22,12 @@ class MSXCPUInterface;
 unsigned dasm(const MSXCPUInterface& interf, word pc, byte buf[4],
               std::string& dest, EmuTime::param time);
 
+/** Disassemble an instruction from a buffer (e.g. bytes that were captured
+  * in a trace) instead of from memory. Missing bytes are taken as zero.
+  * @return Length of the disassembled opcode in bytes
+  */
+unsigned dasm(span<const byte> opcode, word pc, std::string& dest);
+
 } // namespace openmsx
 
 #endif
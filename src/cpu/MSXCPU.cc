@@ -8,11 +8,16 @@
 #include "Z80.hh"
 #include "R800.hh"
 #include "TclObject.hh"
+#include "CommandException.hh"
+#include "FileContext.hh"
+#include "FileOperations.hh"
 #include "outer.hh"
 #include "ranges.hh"
 #include "serialize.hh"
 #include "unreachable.hh"
+#include <algorithm>
 #include <cassert>
+#include <fstream>
 #include <memory>
 
 using std::string;
@@ -28,6 +33,8 @@ MSXCPU::MSXCPU(MSXMotherBoard& motherboard_)
 	, diHaltCallback(
 		motherboard.getCommandController(), "di_halt_callback",
 		"Tcl proc called when the CPU executed a DI/HALT sequence")
+	, z80Profiler("z80")
+	, r800Profiler("r800")
 	, z80(std::make_unique<CPUCore<Z80TYPE>>(
 		motherboard, "z80", traceSetting,
 		diHaltCallback, EmuTime::zero()))
@@ -42,6 +49,8 @@ MSXCPU::MSXCPU(MSXMotherBoard& motherboard_)
 		? std::make_unique<CPUFreqInfoTopic>(
 			motherboard.getMachineInfoCommand(), "r800_freq", *r800)
 		: nullptr)
+	, profileCmd(motherboard.getCommandController())
+	, traceCmd(motherboard.getCommandController())
 	, debuggable(motherboard_)
 	, reference(EmuTime::zero())
 {
@@ -175,6 +184,7 @@ void MSXCPU::updateVisiblePage(byte page, byte primarySlot, byte secondarySlot)
 	std::copy_n(&slotReadLines [to][first], num, &cpuReadLines        [first]);
 	std::copy_n(&cpuWriteLines     [first], num, &slotWriteLines[from][first]);
 	std::copy_n(&slotWriteLines[to][first], num, &cpuWriteLines       [first]);
+	interface->invalidateWatchedLines(page * 0x4000, 0x4000);
 
 	if (r800) r800->updateVisiblePage(page, primarySlot, secondarySlot);
 }
@@ -193,6 +203,7 @@ void MSXCPU::invalidateAllSlotsRWCache(word start, unsigned size)
 		std::fill_n(slotReadLines[i] + first, num, nullptr);
 		std::fill_n(slotWriteLines[i] + first, num, nullptr);
 	}
+	if (interface) interface->invalidateWatchedLines(start, size);
 }
 
 template<bool READ, bool WRITE, bool SUB_START>
@@ -232,6 +243,8 @@ void MSXCPU::setRWCache(unsigned start, unsigned size, const byte* rData, byte*
 	disallowRead  += first;
 	disallowWrite += first;
 	unsigned num = size / CacheLine::SIZE;
+	// (also for non-visible slots, they might become visible later on)
+	interface->invalidateWatchedLines(start, size);
 
 	static const auto NON_CACHEABLE = reinterpret_cast<byte*>(1);
 	for (unsigned i = 0; i < num; ++i) {
@@ -407,6 +420,273 @@ string MSXCPU::CPUFreqInfoTopic::help(const vector<string>& /*tokens*/) const
 }
 
 
+// class ProfileCmd
+
+MSXCPU::ProfileCmd::ProfileCmd(CommandController& commandController_)
+	: Command(commandController_, "cpu_profile")
+{
+}
+
+void MSXCPU::ProfileCmd::execute(span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{2}, "subcommand ?arg ...?");
+	auto& cpu = OUTER(MSXCPU, profileCmd);
+	executeSubCommand(tokens[1].getString(),
+		"start",  [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               setProfiling(true); },
+		"stop",   [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               setProfiling(false); },
+		"status", [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               result = cpu.profiling; },
+		"clear",  [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               cpu.z80Profiler.clear();
+		               cpu.r800Profiler.clear(); },
+		"report", [&]{ report(tokens, result); },
+		"callgrind",  [&]{ exportFile(tokens, true); },
+		"flamegraph", [&]{ exportFile(tokens, false); });
+}
+
+void MSXCPU::ProfileCmd::setProfiling(bool enabled)
+{
+	auto& cpu = OUTER(MSXCPU, profileCmd);
+	cpu.profiling = enabled;
+	cpu.z80->setProfiler(enabled ? &cpu.z80Profiler : nullptr);
+	if (cpu.r800) {
+		cpu.r800->setProfiler(enabled ? &cpu.r800Profiler : nullptr);
+	}
+}
+
+void MSXCPU::ProfileCmd::report(span<const TclObject> tokens, TclObject& result) const
+{
+	checkNumArgs(tokens, Between{2, 3}, Prefix{2}, "?count?");
+	auto& cpu = OUTER(MSXCPU, profileCmd);
+	auto& interp = getInterpreter();
+	unsigned count = (tokens.size() == 3) ? tokens[2].getInt(interp) : 20;
+
+	struct Entry {
+		CPUProfiler::FlatEntry flat;
+		const CPUProfiler* profiler;
+		uint64_t cycles;
+	};
+	vector<Entry> entries;
+	auto collect = [&](const CPUProfiler& profiler, unsigned freq) {
+		for (const auto& e : profiler.getFlat()) {
+			entries.push_back({e, &profiler,
+			                   CPUProfiler::ticksToCycles(e.ticks, freq)});
+		}
+	};
+	collect(cpu.z80Profiler, cpu.z80->getFreq());
+	if (cpu.r800) collect(cpu.r800Profiler, cpu.r800->getFreq());
+	ranges::sort(entries, [](const Entry& x, const Entry& y) {
+		return x.cycles > y.cycles; });
+
+	entries.resize(std::min<size_t>(entries.size(), count));
+	for (const auto& e : entries) {
+		result.addListElement(makeTclDict(
+			TclObject("cpu"),     TclObject(e.profiler->getName()),
+			TclObject("address"), TclObject(CPUProfiler::formatAddrKey(e.flat.addrKey)),
+			TclObject("count"),   TclObject(e.flat.count),
+			TclObject("cycles"),  TclObject(e.cycles)));
+	}
+}
+
+void MSXCPU::ProfileCmd::exportFile(span<const TclObject> tokens, bool callgrind) const
+{
+	checkNumArgs(tokens, 3, "filename");
+	auto& cpu = OUTER(MSXCPU, profileCmd);
+	auto filename = FileOperations::expandTilde(string(tokens[2].getString()));
+	std::ofstream os;
+	FileOperations::openofstream(os, filename);
+	if (!os) {
+		throw CommandException("Couldn't open file for writing: ", filename);
+	}
+	if (callgrind) {
+		os << "# callgrind format\n"
+		      "version: 1\n"
+		      "creator: openMSX\n"
+		      "positions: instr\n"
+		      "events: Instructions Cycles\n"
+		      "\n";
+		cpu.z80Profiler.writeCallgrind(os, cpu.z80->getFreq());
+		if (cpu.r800) cpu.r800Profiler.writeCallgrind(os, cpu.r800->getFreq());
+	} else {
+		cpu.z80Profiler.writeFolded(os, cpu.z80->getFreq());
+		if (cpu.r800) cpu.r800Profiler.writeFolded(os, cpu.r800->getFreq());
+	}
+	if (!os) {
+		throw CommandException("Error while writing ", filename);
+	}
+}
+
+string MSXCPU::ProfileCmd::help(const vector<string>& /*tokens*/) const
+{
+	return "Per-address CPU profiler.\n"
+	       "  cpu_profile start               start profiling\n"
+	       "  cpu_profile stop                stop profiling, keep the results\n"
+	       "  cpu_profile status              returns whether profiling is active\n"
+	       "  cpu_profile clear               discard all results\n"
+	       "  cpu_profile report ?<count>?    the <count> (default 20) most expensive\n"
+	       "                                  addresses, as a list of dicts\n"
+	       "  cpu_profile callgrind <file>    write a callgrind file (e.g. for KCachegrind)\n"
+	       "  cpu_profile flamegraph <file>   write stack samples in the 'folded' format\n"
+	       "                                  of flamegraph.pl\n"
+	       "Addresses are qualified with the selected slot and, for memory mapper\n"
+	       "RAM, the selected segment. While profiling, emulation runs slower (in\n"
+	       "real time), but emulated timing is not affected.\n";
+}
+
+void MSXCPU::ProfileCmd::tabCompletion(vector<string>& tokens) const
+{
+	if (tokens.size() == 2) {
+		static constexpr const char* const subCmds[] = {
+			"start", "stop", "status", "clear", "report",
+			"callgrind", "flamegraph",
+		};
+		completeString(tokens, subCmds);
+	} else if ((tokens.size() == 3) &&
+	           ((tokens[1] == "callgrind") || (tokens[1] == "flamegraph"))) {
+		completeFileName(tokens, userFileContext());
+	}
+}
+
+
+// class TraceCmd
+
+constexpr size_t DEFAULT_TRACE_SIZE = 1024 * 1024; // 32MB
+constexpr unsigned DEFAULT_TRACE_DUMP = 100;
+
+MSXCPU::TraceCmd::TraceCmd(CommandController& commandController_)
+	: Command(commandController_, "cpu_trace")
+{
+}
+
+void MSXCPU::TraceCmd::execute(span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{2}, "subcommand ?arg ...?");
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	executeSubCommand(tokens[1].getString(),
+		"start",  [&]{ start(tokens); },
+		"stop",   [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               setRecording(false); },
+		"status", [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               status(result); },
+		"clear",  [&]{ checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		               if (cpu.traceBuffer) cpu.traceBuffer->clear(); },
+		"dump",   [&]{ dump(tokens, result); },
+		"save",   [&]{ save(tokens); },
+		"decode", [&]{ decode(tokens, result); });
+}
+
+void MSXCPU::TraceCmd::start(span<const TclObject> tokens)
+{
+	checkNumArgs(tokens, Between{2, 3}, Prefix{2}, "?entries?");
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	size_t entries = DEFAULT_TRACE_SIZE;
+	if (tokens.size() == 3) {
+		int n = tokens[2].getInt(getInterpreter());
+		if (n <= 0) throw CommandException("Number of entries must be positive");
+		entries = n;
+	}
+	if (!cpu.traceBuffer || (cpu.traceBuffer->capacity() != entries)) {
+		setRecording(false);
+		cpu.traceBuffer = std::make_unique<CPUTraceBuffer>(entries);
+	}
+	setRecording(true);
+}
+
+void MSXCPU::TraceCmd::setRecording(bool enabled)
+{
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	cpu.traceRecording = enabled && cpu.traceBuffer;
+	auto* buffer = cpu.traceRecording ? cpu.traceBuffer.get() : nullptr;
+	cpu.z80->setTraceBuffer(buffer);
+	if (cpu.r800) cpu.r800->setTraceBuffer(buffer);
+}
+
+void MSXCPU::TraceCmd::status(TclObject& result) const
+{
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	const auto* buffer = cpu.traceBuffer.get();
+	result = makeTclDict(
+		TclObject("recording"), TclObject(cpu.traceRecording),
+		TclObject("capacity"),  TclObject(uint64_t(buffer ? buffer->capacity() : 0)),
+		TclObject("size"),      TclObject(uint64_t(buffer ? buffer->size() : 0)),
+		TclObject("total"),     TclObject(uint64_t(buffer ? buffer->getTotal() : 0)));
+}
+
+void MSXCPU::TraceCmd::dump(span<const TclObject> tokens, TclObject& result) const
+{
+	checkNumArgs(tokens, Between{2, 3}, Prefix{2}, "?count?");
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	if (!cpu.traceBuffer) return;
+	unsigned count = (tokens.size() == 3) ? tokens[2].getInt(getInterpreter())
+	                                      : DEFAULT_TRACE_DUMP;
+	format(cpu.traceBuffer->getLast(count), result);
+}
+
+void MSXCPU::TraceCmd::save(span<const TclObject> tokens) const
+{
+	checkNumArgs(tokens, 3, "filename");
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	if (!cpu.traceBuffer) {
+		throw CommandException("Nothing recorded yet");
+	}
+	cpu.traceBuffer->save(FileOperations::expandTilde(string(tokens[2].getString())));
+}
+
+void MSXCPU::TraceCmd::decode(span<const TclObject> tokens, TclObject& result) const
+{
+	checkNumArgs(tokens, Between{3, 4}, "filename ?count?");
+	unsigned count = (tokens.size() == 4) ? tokens[3].getInt(getInterpreter())
+	                                      : DEFAULT_TRACE_DUMP;
+	auto records = CPUTraceBuffer::load(
+		FileOperations::expandTilde(string(tokens[2].getString())));
+	auto num = std::min<size_t>(count, records.size());
+	format(span<const CPUTraceBuffer::Record>(records).last(num), result);
+}
+
+void MSXCPU::TraceCmd::format(span<const CPUTraceBuffer::Record> records,
+                              TclObject& result) const
+{
+	auto& cpu = OUTER(MSXCPU, traceCmd);
+	unsigned z80Freq = cpu.z80->getFreq();
+	unsigned r800Freq = cpu.r800 ? cpu.r800->getFreq() : 0;
+	for (const auto& r : records) {
+		result.addListElement(CPUTraceBuffer::format(r, z80Freq, r800Freq));
+	}
+}
+
+string MSXCPU::TraceCmd::help(const vector<string>& /*tokens*/) const
+{
+	return "Binary CPU trace, records every executed instruction in a ring buffer.\n"
+	       "This is much faster than the 'cputrace' setting.\n"
+	       "  cpu_trace start ?<entries>?        start recording, the buffer keeps the\n"
+	       "                                     last <entries> (default 1048576)\n"
+	       "                                     instructions\n"
+	       "  cpu_trace stop                     stop recording, keep the buffer\n"
+	       "  cpu_trace status                   dict with recording/capacity/size/total\n"
+	       "  cpu_trace clear                    discard the recorded instructions\n"
+	       "  cpu_trace dump ?<count>?           last <count> (default 100) instructions\n"
+	       "                                     as text, oldest first\n"
+	       "  cpu_trace save <file>              save the buffer in binary format\n"
+	       "  cpu_trace decode <file> ?<count>?  the last <count> (default 100)\n"
+	       "                                     instructions of a saved file as text\n";
+}
+
+void MSXCPU::TraceCmd::tabCompletion(vector<string>& tokens) const
+{
+	if (tokens.size() == 2) {
+		static constexpr const char* const subCmds[] = {
+			"start", "stop", "status", "clear", "dump", "save", "decode",
+		};
+		completeString(tokens, subCmds);
+	} else if ((tokens.size() == 3) &&
+	           ((tokens[1] == "save") || (tokens[1] == "decode"))) {
+		completeFileName(tokens, userFileContext());
+	}
+}
+
+
 // class Debuggable
 
 constexpr const char* const CPU_REGS_DESC =
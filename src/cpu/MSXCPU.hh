@@ -1,6 +1,9 @@
 #ifndef MSXCPU_HH
 #define MSXCPU_HH
 
+#include "Command.hh"
+#include "CPUProfiler.hh"
+#include "CPUTraceBuffer.hh"
 #include "InfoTopic.hh"
 #include "SimpleDebuggable.hh"
 #include "Observer.hh"
@@ -39,6 +42,9 @@ public:
 	 */
 	void doReset(EmuTime::param time);
 
+	/** Time of the last reset, 'machine_info time' is relative to this. */
+	EmuTime::param getResetTime() const { return reference; }
+
 	/** Switch between Z80/R800. */
 	void setActiveCPU(CPUType cpu);
 
@@ -172,6 +178,11 @@ private:
 	MSXMotherBoard& motherboard;
 	BooleanSetting traceSetting;
 	TclCallback diHaltCallback;
+	CPUProfiler z80Profiler;
+	CPUProfiler r800Profiler; // only used when r800 != nullptr
+	bool profiling = false;
+	std::unique_ptr<CPUTraceBuffer> traceBuffer; // nullptr until first used
+	bool traceRecording = false;
 	const std::unique_ptr<CPUCore<Z80TYPE>> z80;
 	const std::unique_ptr<CPUCore<R800TYPE>> r800; // can be nullptr
 
@@ -199,6 +210,35 @@ private:
 	CPUFreqInfoTopic                        z80FreqInfo;  // always present
 	const std::unique_ptr<CPUFreqInfoTopic> r800FreqInfo; // can be nullptr
 
+	struct ProfileCmd final : Command {
+		explicit ProfileCmd(CommandController& commandController);
+		void execute(span<const TclObject> tokens,
+		             TclObject& result) override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	private:
+		void setProfiling(bool enabled);
+		void report(span<const TclObject> tokens, TclObject& result) const;
+		void exportFile(span<const TclObject> tokens, bool callgrind) const;
+	} profileCmd;
+
+	struct TraceCmd final : Command {
+		explicit TraceCmd(CommandController& commandController);
+		void execute(span<const TclObject> tokens,
+		             TclObject& result) override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	private:
+		void start(span<const TclObject> tokens);
+		void setRecording(bool enabled);
+		void status(TclObject& result) const;
+		void dump(span<const TclObject> tokens, TclObject& result) const;
+		void save(span<const TclObject> tokens) const;
+		void decode(span<const TclObject> tokens, TclObject& result) const;
+		void format(span<const CPUTraceBuffer::Record> records,
+		            TclObject& result) const;
+	} traceCmd;
+
 	struct Debuggable final : SimpleDebuggable {
 		explicit Debuggable(MSXMotherBoard& motherboard);
 		byte read(unsigned address) override;
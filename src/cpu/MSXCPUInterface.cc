@@ -25,6 +25,8 @@
 #include "ranges.hh"
 #include "stl.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
+#include <algorithm>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -42,11 +44,6 @@ static std::unique_ptr<ReadOnlySetting> breakedSetting;
 static unsigned breakedSettingCount = 0;
 
 
-// Bitfields used in the disallowReadCache and disallowWriteCache arrays
-constexpr byte SECONDARY_SLOT_BIT = 0x01;
-constexpr byte MEMORY_WATCH_BIT   = 0x02;
-constexpr byte GLOBAL_RW_BIT      = 0x04;
-
 std::ostream& operator<<(std::ostream& os, EnumTypeName<CacheLineCounters>)
 {
 	return os << "CacheLineCounters";
@@ -69,6 +66,8 @@ std::ostream& operator<<(std::ostream& os, EnumValueName<CacheLineCounters> evn)
 		"FillReadWrite",
 		"FillRead",
 		"FillWrite",
+		"WatchedLineRead",
+		"WatchedLineWrite",
 	};
 	return os << names[size_t(evn.e)];
 }
@@ -107,6 +106,7 @@ MSXCPUInterface::MSXCPUInterface(MSXMotherBoard& motherBoard_)
 	// initially allow all regions to be cached
 	memset(disallowReadCache,  0, sizeof(disallowReadCache));
 	memset(disallowWriteCache, 0, sizeof(disallowWriteCache));
+	invalidateWatchedLines(0, 0x10000);
 
 	initialPrimarySlots = motherBoard.getMachineConfig()->parseSlotMap();
 	// Note: SlotState is initialised at reset
@@ -242,6 +242,32 @@ void MSXCPUInterface::writeMemSlow(word address, byte value, EmuTime::param time
 	}
 }
 
+const byte* MSXCPUInterface::fillWatchedReadLine(unsigned high)
+{
+	word start = high << CacheLine::BITS;
+	const byte* line = visibleDevices[start >> 14]->getReadCacheLine(start);
+	if (!line) line = reinterpret_cast<const byte*>(1);
+	watchedReadLines[high] = line;
+	return line;
+}
+
+byte* MSXCPUInterface::fillWatchedWriteLine(unsigned high)
+{
+	word start = high << CacheLine::BITS;
+	byte* line = visibleDevices[start >> 14]->getWriteCacheLine(start);
+	if (!line) line = reinterpret_cast<byte*>(1);
+	watchedWriteLines[high] = line;
+	return line;
+}
+
+void MSXCPUInterface::invalidateWatchedLines(unsigned start, unsigned size)
+{
+	unsigned first = start / CacheLine::SIZE;
+	unsigned num = (size + CacheLine::SIZE - 1) / CacheLine::SIZE;
+	std::fill_n(watchedReadLines  + first, num, nullptr);
+	std::fill_n(watchedWriteLines + first, num, nullptr);
+}
+
 void MSXCPUInterface::setExpanded(int ps)
 {
 	if (expanded[ps] == 0) {
@@ -1067,6 +1093,33 @@ void MSXCPUInterface::MemoryDebug::write(unsigned address, byte value,
 	return interface.writeMem(address, value, time);
 }
 
+void MSXCPUInterface::MemoryDebug::readBlock(unsigned start, span<byte> output)
+{
+	// Copy whole cache lines where possible, only regions that are not
+	// cacheable need to go through peekMem().
+	auto& interface = OUTER(MSXCPUInterface, memoryDebug);
+	auto time = getMotherBoard().getCurrentTime();
+	size_t i = 0;
+	while (i < output.size()) {
+		unsigned address = start + unsigned(i);
+		unsigned offset = address & CacheLine::LOW;
+		size_t num = std::min<size_t>(output.size() - i, CacheLine::SIZE - offset);
+		auto* device = interface.visibleDevices[address >> 14];
+		if (const byte* line = device->getReadCacheLine(address & CacheLine::HIGH)) {
+			memcpy(&output[i], line + offset, num);
+		} else {
+			for (auto j : xrange(num)) {
+				output[i + j] = interface.peekMem(word(address + j), time);
+			}
+		}
+		i += num;
+	}
+	// The sub-slot register is not part of any cache line.
+	if (!output.empty() && ((start + output.size()) == 0x10000)) {
+		output.back() = interface.peekMem(0xFFFF, time);
+	}
+}
+
 
 // class SlottedMemoryDebug
 
@@ -38,7 +38,6 @@ struct CompareBreakpoints {
 	}
 };
 
-constexpr bool PROFILE_CACHELINES = false;
 enum CacheLineCounters {
 	NonCachedRead,
 	NonCachedWrite,
@@ -55,12 +54,14 @@ enum CacheLineCounters {
 	FillReadWrite,
 	FillRead,
 	FillWrite,
+	WatchedLineRead,
+	WatchedLineWrite,
 	NUM // must be last
 };
 std::ostream& operator<<(std::ostream& os, EnumTypeName<CacheLineCounters>);
 std::ostream& operator<<(std::ostream& os, EnumValueName<CacheLineCounters> evn);
 
-class MSXCPUInterface : public ProfileCounters<PROFILE_CACHELINES, CacheLineCounters>
+class MSXCPUInterface
 {
 public:
 	MSXCPUInterface(const MSXCPUInterface&) = delete;
@@ -210,6 +211,50 @@ public:
 		return visibleDevices[start >> 14]->getWriteCacheLine(start);
 	}
 
+	/**
+	 * Cache lines that contain a memory watchpoint are not cacheable (in
+	 * the CPU), so that each access can be checked. That would make all
+	 * accesses to such a line as slow as accesses to e.g. an IO-mapped
+	 * device, even if only a single byte in that line is watched.
+	 * These methods are a shortcut for those lines: when a line is only
+	 * excluded from the CPU cache because of watchpoints and the given
+	 * address itself is not watched, they return a pointer to the byte
+	 * in the (cacheable) memory of the visible device, so the CPU can
+	 * access it directly. Otherwise they return nullptr and the access
+	 * must go via readMem()/writeMem().
+	 */
+	inline const byte* getWatchedReadPtr(word address) {
+		unsigned high = address >> CacheLine::BITS;
+		if ((disallowReadCache[high] != MEMORY_WATCH_BIT) ||
+		    readWatchSet[high][address & CacheLine::LOW]) {
+			return nullptr;
+		}
+		const byte* line = watchedReadLines[high];
+		if (unlikely(line == nullptr)) {
+			line = fillWatchedReadLine(high);
+		}
+		if (uintptr_t(line) == 1) return nullptr;
+		tick(CacheLineCounters::WatchedLineRead);
+		return &line[address & CacheLine::LOW];
+	}
+	inline byte* getWatchedWritePtr(word address) {
+		unsigned high = address >> CacheLine::BITS;
+		if ((disallowWriteCache[high] != MEMORY_WATCH_BIT) ||
+		    writeWatchSet[high][address & CacheLine::LOW]) {
+			return nullptr;
+		}
+		byte* line = watchedWriteLines[high];
+		if (unlikely(line == nullptr)) {
+			line = fillWatchedWriteLine(high);
+		}
+		if (uintptr_t(line) == 1) return nullptr;
+		tick(CacheLineCounters::WatchedLineWrite);
+		return &line[address & CacheLine::LOW];
+	}
+	/** Must be called whenever the CPU cache lines in the given range
+	  * are invalidated (see MSXCPU). */
+	void invalidateWatchedLines(unsigned start, unsigned size);
+
 	/**
 	 * CPU uses this method to read 'extra' data from the databus
 	 * used in interrupt routines. In MSX this returns always 255.
@@ -246,6 +291,12 @@ public:
 	void unsetExpanded(int ps);
 	void testUnsetExpanded(int ps, std::vector<MSXDevice*> allowed) const;
 	inline bool isExpanded(int ps) const { return expanded[ps] != 0; }
+
+	/** The currently selected (primary/secondary) slot and the visible
+	  * device for the given page. */
+	byte getPrimarySlot(int page) const { return primarySlotState[page]; }
+	byte getSecondarySlot(int page) const { return secondarySlotState[page]; }
+	MSXDevice* getVisibleMSXDevice(int page) const { return visibleDevices[page]; }
 	void changeExpanded(bool newExpanded);
 
 	DummyDevice& getDummyDevice() { return *dummyDevice; }
@@ -296,12 +347,19 @@ public:
 	void setFastForward(bool fastForward_) { fastForward = fastForward_; }
 	bool isFastForward() const { return fastForward; }
 
+	/** Profile counter, see the 'profile' command. */
+	void tick(CacheLineCounters c) const { profileCounters.tick(c); }
+
 	template<typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
 private:
+	RuntimeProfileCounters<CacheLineCounters> profileCounters;
+
 	byte readMemSlow(word address, EmuTime::param time);
 	void writeMemSlow(word address, byte value, EmuTime::param time);
+	const byte* fillWatchedReadLine(unsigned high);
+	byte* fillWatchedWriteLine(unsigned high);
 
 	MSXDevice*& getDevicePtr(byte port, bool isIn);
 
@@ -333,6 +391,7 @@ private:
 		explicit MemoryDebug(MSXMotherBoard& motherBoard);
 		byte read(unsigned address, EmuTime::param time) override;
 		void write(unsigned address, byte value, EmuTime::param time) override;
+		void readBlock(unsigned start, span<byte> output) override;
 	} memoryDebug;
 
 	struct SlottedMemoryDebug final : SimpleDebuggable {
@@ -410,6 +469,16 @@ private:
 	byte disallowWriteCache[CacheLine::NUM];
 	std::bitset<CacheLine::SIZE> readWatchSet [CacheLine::NUM];
 	std::bitset<CacheLine::SIZE> writeWatchSet[CacheLine::NUM];
+	// Bitfields used in the disallowReadCache and disallowWriteCache arrays
+	static constexpr byte SECONDARY_SLOT_BIT = 0x01;
+	static constexpr byte MEMORY_WATCH_BIT   = 0x02;
+	static constexpr byte GLOBAL_RW_BIT      = 0x04;
+	// Cache lines of the visible devices, only used for lines that are
+	// not cacheable because of memory watchpoints (see getWatchedReadPtr()).
+	// nullptr means not yet filled, 1 means the device itself doesn't
+	// allow caching.
+	const byte* watchedReadLines [CacheLine::NUM];
+	byte*       watchedWriteLines[CacheLine::NUM];
 
 	struct GlobalRwInfo {
 		MSXDevice* device;
@@ -2,6 +2,7 @@
 #define DEBUGGABLE_HH
 
 #include "openmsx.hh"
+#include "span.hh"
 #include <string>
 
 namespace openmsx {
@@ -14,6 +15,24 @@ public:
 	virtual byte read(unsigned address) = 0;
 	virtual void write(unsigned address, byte value) = 0;
 
+	/** Read/write a range of consecutive addresses at once. This is
+	  * equivalent to calling read()/write() for each address (and that's
+	  * also what the default implementation does), but debuggables backed
+	  * by a buffer can override these to do it a lot faster.
+	  * The caller must make sure the complete range fits in the
+	  * debuggable (see getSize()).
+	  */
+	virtual void readBlock(unsigned start, span<byte> output) {
+		for (size_t i = 0; i < output.size(); ++i) {
+			output[i] = read(start + unsigned(i));
+		}
+	}
+	virtual void writeBlock(unsigned start, span<const byte> input) {
+		for (size_t i = 0; i < input.size(); ++i) {
+			write(start + unsigned(i), input[i]);
+		}
+	}
+
 protected:
 	Debuggable() = default;
 	~Debuggable() = default;
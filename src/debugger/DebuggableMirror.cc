@@ -0,0 +1,227 @@
+#include "DebuggableMirror.hh"
+#include "Debugger.hh"
+#include "Debuggable.hh"
+#include "EventDistributor.hh"
+#include "FinishFrameEvent.hh"
+#include "MSXException.hh"
+#include "checked_cast.hh"
+#include "ranges.hh"
+#include "stl.hh"
+#include "strCat.hh"
+#include "xrange.hh"
+#include "systemfuncs.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#if HAVE_SHM_OPEN
+#include "unistdp.hh"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace openmsx {
+
+namespace {
+
+struct Header {
+	char magic[16];
+	std::atomic<uint64_t> sequence;
+	uint64_t frame;
+	uint32_t totalSize;
+	uint32_t numEntries;
+};
+
+struct EntryHeader {
+	char name[DebuggableMirror::MAX_NAME_LEN + 1];
+	uint32_t offset;
+	uint32_t size;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the sequence counter is shared with other processes");
+static_assert(sizeof(Header) == 40);
+static_assert(sizeof(EntryHeader) == 64);
+
+constexpr char MAGIC[16] = {'o','p','e','n','M','S','X',' ','m','i','r','r','o','r',' ','1'};
+constexpr size_t DATA_ALIGN = 64;
+constexpr size_t MIN_SEGMENT_SIZE = 4096;
+
+constexpr size_t alignUp(size_t n, size_t align)
+{
+	return (n + align - 1) & ~(align - 1);
+}
+
+} // namespace
+
+DebuggableMirror::DebuggableMirror(
+		Debugger& debugger_, EventDistributor& eventDistributor_,
+		std::string segmentName_)
+	: debugger(&debugger_)
+	, eventDistributor(eventDistributor_)
+	, segmentName(std::move(segmentName_))
+{
+#if HAVE_SHM_OPEN
+	fd = shm_open(segmentName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd == -1) {
+		throw MSXException("Couldn't create shared memory segment ",
+		                   segmentName, ": ", strerror(errno));
+	}
+	try {
+		resize(MIN_SEGMENT_SIZE);
+	} catch (...) {
+		close(fd);
+		shm_unlink(segmentName.c_str());
+		throw;
+	}
+	auto* header = new (mem) Header();
+	memcpy(header->magic, MAGIC, sizeof(MAGIC));
+	header->totalSize = sizeof(Header);
+	header->numEntries = 0;
+
+	eventDistributor.registerEventListener(OPENMSX_FINISH_FRAME_EVENT, *this);
+#else
+	throw MSXException("Shared memory is not supported on this platform.");
+#endif
+}
+
+DebuggableMirror::~DebuggableMirror()
+{
+#if HAVE_SHM_OPEN
+	eventDistributor.unregisterEventListener(OPENMSX_FINISH_FRAME_EVENT, *this);
+	munmap(mem, mappedSize);
+	close(fd);
+	shm_unlink(segmentName.c_str());
+#endif
+}
+
+void DebuggableMirror::add(std::string_view name)
+{
+	if (contains(names, name)) return;
+	if (name.size() > MAX_NAME_LEN) {
+		throw MSXException("Debuggable name too long for the mirror: ", name);
+	}
+	names.emplace_back(name);
+	update();
+}
+
+void DebuggableMirror::remove(std::string_view name)
+{
+	auto it = ranges::find(names, name);
+	if (it == end(names)) {
+		throw MSXException("Debuggable is not mirrored: ", name);
+	}
+	names.erase(it);
+	update();
+}
+
+bool DebuggableMirror::layoutChanged() const
+{
+	// Debuggables can (dis)appear (e.g. when inserting a cartridge) or
+	// change size (e.g. when switching VDP mode), so re-check every time.
+	auto it = begin(layout);
+	for (const auto& name : names) {
+		auto* d = debugger->findDebuggable(name);
+		if (!d) continue;
+		if ((it == end(layout)) || (it->name != name) ||
+		    (it->size != d->getSize())) {
+			return true;
+		}
+		++it;
+	}
+	return it != end(layout);
+}
+
+void DebuggableMirror::rebuildLayout()
+{
+	std::vector<Entry> newLayout;
+	for (const auto& name : names) {
+		if (auto* d = debugger->findDebuggable(name)) {
+			newLayout.push_back({name, 0, d->getSize()});
+		}
+	}
+	size_t offset = alignUp(sizeof(Header) + newLayout.size() * sizeof(EntryHeader),
+	                        DATA_ALIGN);
+	for (auto& e : newLayout) {
+		e.offset = unsigned(offset);
+		offset = alignUp(offset + e.size, DATA_ALIGN);
+	}
+	if (offset > mappedSize) resize(std::max(offset, 2 * mappedSize));
+	layout = std::move(newLayout);
+
+	auto* header = reinterpret_cast<Header*>(mem);
+	auto* entries = reinterpret_cast<EntryHeader*>(mem + sizeof(Header));
+	for (auto i : xrange(layout.size())) {
+		auto& dst = entries[i];
+		memset(dst.name, 0, sizeof(dst.name));
+		memcpy(dst.name, layout[i].name.data(), layout[i].name.size());
+		dst.offset = layout[i].offset;
+		dst.size   = layout[i].size;
+	}
+	header->numEntries = uint32_t(layout.size());
+	header->totalSize = uint32_t(offset);
+}
+
+void DebuggableMirror::resize(size_t newSize)
+{
+#if HAVE_SHM_OPEN
+	// Only ever grow the segment: readers that still have the old (smaller)
+	// part mapped keep on working.
+	newSize = alignUp(newSize, MIN_SEGMENT_SIZE);
+	if (ftruncate(fd, newSize) == -1) {
+		throw MSXException("Couldn't resize shared memory segment: ",
+		                   strerror(errno));
+	}
+	void* newMem = mmap(nullptr, newSize, PROT_READ | PROT_WRITE,
+	                    MAP_SHARED, fd, 0);
+	if (newMem == MAP_FAILED) {
+		throw MSXException("Couldn't map shared memory segment: ",
+		                   strerror(errno));
+	}
+	if (mem) munmap(mem, mappedSize);
+	mem = static_cast<uint8_t*>(newMem);
+	mappedSize = newSize;
+#else
+	(void)newSize;
+#endif
+}
+
+void DebuggableMirror::update()
+{
+	if (!mem) return;
+	auto* header = reinterpret_cast<Header*>(mem);
+	auto seq = header->sequence.load(std::memory_order_relaxed);
+	header->sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	try {
+		if (layoutChanged()) rebuildLayout();
+	} catch (MSXException&) {
+		// Couldn't grow the segment, retry on the next update.
+		layout.clear();
+	}
+	header = reinterpret_cast<Header*>(mem); // may have been remapped
+	if (layout.empty()) header->numEntries = 0;
+	for (const auto& e : layout) {
+		auto* d = debugger->findDebuggable(e.name);
+		if (!d || (e.size == 0) || (d->getSize() != e.size)) continue;
+		d->readBlock(0, span<byte>{mem + e.offset, e.size});
+	}
+	header->frame = ++frame;
+
+	header->sequence.store(seq + 2, std::memory_order_release);
+}
+
+int DebuggableMirror::signalEvent(const std::shared_ptr<const Event>& event)
+{
+	// Only once per frame, also when there are multiple video sources.
+	auto& ffe = checked_cast<const FinishFrameEvent&>(*event);
+	if (ffe.getSource() == ffe.getSelectedSource()) {
+		update();
+	}
+	return 0;
+}
+
+} // namespace openmsx
@@ -0,0 +1,89 @@
+#ifndef DEBUGGABLEMIRROR_HH
+#define DEBUGGABLEMIRROR_HH
+
+#include "EventListener.hh"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openmsx {
+
+class Debugger;
+class EventDistributor;
+
+/** Copies the content of a selected set of debuggables into a (POSIX) shared
+ * memory segment at the end of each frame. External tools on the same host
+ * can map this segment and read the emulator state without any interaction
+ * with openMSX (no socket round trips, no Tcl commands).
+ *
+ * Segment layout (all integers are in host byte order):
+ *   char     magic[16]    "openMSX mirror 1"
+ *   uint64   sequence     odd while the segment is being updated
+ *   uint64   frame        number of updates so far
+ *   uint32   totalSize    size of the (used part of the) segment
+ *   uint32   numEntries
+ *   entry    entries[numEntries]
+ *   ...      data, each block starts at a 64-byte aligned offset
+ * with
+ *   entry:   char name[56] (zero-terminated), uint32 offset, uint32 size
+ *
+ * Readers should use the sequence counter as a seqlock: read it, copy the
+ * data they need, read it again and retry when the two values differ or
+ * when the value is odd. The segment only grows, so a reader that maps
+ * 'totalSize' bytes must re-map when that value increases.
+ */
+class DebuggableMirror final : private EventListener
+{
+public:
+	static constexpr size_t MAX_NAME_LEN = 55;
+
+	DebuggableMirror(const DebuggableMirror&) = delete;
+	DebuggableMirror& operator=(const DebuggableMirror&) = delete;
+
+	/** Creates the shared memory segment. Throws MSXException on error
+	  * (or when shared memory is not supported on this platform). */
+	DebuggableMirror(Debugger& debugger, EventDistributor& eventDistributor,
+	                 std::string segmentName);
+	~DebuggableMirror();
+
+	void add(std::string_view name);
+	void remove(std::string_view name);
+	[[nodiscard]] const std::vector<std::string>& getNames() const { return names; }
+	[[nodiscard]] const std::string& getSegmentName() const { return segmentName; }
+
+	/** Copy the current content of all mirrored debuggables. */
+	void update();
+
+	/** Used when the machine is replaced (reverse), the segment (and its
+	  * name) stays the same, only the source of the data changes. */
+	void setDebugger(Debugger& debugger_) { debugger = &debugger_; }
+
+private:
+	struct Entry {
+		std::string name;
+		unsigned offset;
+		unsigned size;
+	};
+
+	bool layoutChanged() const;
+	void rebuildLayout();
+	void resize(size_t newSize);
+
+	// EventListener
+	int signalEvent(const std::shared_ptr<const Event>& event) override;
+
+	Debugger* debugger;
+	EventDistributor& eventDistributor;
+	const std::string segmentName;
+	std::vector<std::string> names;
+	std::vector<Entry> layout; // only the debuggables that currently exist
+	uint8_t* mem = nullptr;
+	size_t mappedSize = 0;
+	uint64_t frame = 0;
+	int fd = -1;
+};
+
+} // namespace openmsx
+
+#endif
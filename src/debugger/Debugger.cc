@@ -1,5 +1,6 @@
 #include "Debugger.hh"
 #include "Debuggable.hh"
+#include "DebuggableMirror.hh"
 #include "ProbeBreakPoint.hh"
 #include "MSXMotherBoard.hh"
 #include "MSXCPU.hh"
@@ -7,6 +8,7 @@
 #include "BreakPoint.hh"
 #include "DebugCondition.hh"
 #include "MSXWatchIODevice.hh"
+#include "Reactor.hh"
 #include "TclArgParser.hh"
 #include "TclObject.hh"
 #include "CommandException.hh"
@@ -15,8 +17,8 @@
 #include "stl.hh"
 #include "StringOp.hh"
 #include "unreachable.hh"
+#include "unistdp.hh"
 #include "view.hh"
-#include "xrange.hh"
 #include <cassert>
 #include <memory>
 #include <stdexcept>
@@ -40,6 +42,7 @@ Debugger::Debugger(MSXMotherBoard& motherBoard_)
 
 Debugger::~Debugger()
 {
+	mirror.reset();
 	assert(!cpu);
 	assert(debuggables.empty());
 }
@@ -186,6 +189,14 @@ void Debugger::transfer(Debugger& other)
 		}
 	}
 
+	// Move the shared memory mirror, external tools keep on using the
+	// same segment.
+	assert(!mirror);
+	if (other.mirror) {
+		mirror = std::move(other.mirror);
+		mirror->setDebugger(*this);
+	}
+
 	// Breakpoints and conditions are (currently) global, so no need to
 	// copy those.
 }
@@ -247,7 +258,8 @@ void Debugger::Cmd::execute(
 		"set_condition",     [&]{ setCondition(tokens, result); },
 		"remove_condition",  [&]{ removeCondition(tokens, result); },
 		"list_conditions",   [&]{ listConditions(tokens, result); },
-		"probe",             [&]{ probe(tokens, result); });
+		"probe",             [&]{ probe(tokens, result); },
+		"mirror",            [&]{ mirror(tokens, result); });
 }
 
 void Debugger::Cmd::list(TclObject& result)
@@ -296,9 +308,7 @@ void Debugger::Cmd::readBlock(span<const TclObject> tokens, TclObject& result)
 	}
 
 	MemBuffer<byte> buf(num);
-	for (unsigned i = 0; i < num; ++i) {
-		buf[i] = device.read(addr + i);
-	}
+	device.readBlock(addr, span<byte>{buf.data(), num});
 	result = span<byte>{buf.data(), num};
 }
 
@@ -333,9 +343,7 @@ void Debugger::Cmd::writeBlock(span<const TclObject> tokens, TclObject& /*result
 		throw CommandException("Invalid size");
 	}
 
-	for (auto i : xrange(buf.size())) {
-		device.write(unsigned(addr + i), buf[i]);
-	}
+	device.writeBlock(addr, buf);
 }
 
 void Debugger::Cmd::setBreakPoint(span<const TclObject> tokens, TclObject& result)
@@ -698,6 +706,42 @@ void Debugger::Cmd::probeListBreakPoints(
 	result = res;
 }
 
+void Debugger::Cmd::mirror(span<const TclObject> tokens, TclObject& result)
+{
+	auto& m = debugger().mirror;
+	if (tokens.size() == 2) {
+		if (m) result.addListElements(m->getNames());
+		return;
+	}
+	string_view subCmd = tokens[2].getString();
+	if (subCmd == "segment") {
+		if (tokens.size() != 3) throw SyntaxError();
+		if (m) result = m->getSegmentName();
+	} else if ((subCmd == "add") || (subCmd == "remove")) {
+		checkNumArgs(tokens, 4, Prefix{3}, "debuggable");
+		string_view name = tokens[3].getString();
+		if (subCmd == "add") {
+			debugger().getDebuggable(name); // check existence
+			if (!m) {
+				auto& motherBoard = debugger().motherBoard;
+				m = std::make_unique<DebuggableMirror>(
+					debugger(),
+					motherBoard.getReactor().getEventDistributor(),
+					strCat("/openmsx-", int(getpid()), '-',
+					       motherBoard.getMachineID()));
+			}
+			m->add(name);
+			result = m->getSegmentName();
+		} else {
+			if (!m) throw CommandException("Debuggable is not mirrored: ", name);
+			m->remove(name);
+			if (m->getNames().empty()) m.reset();
+		}
+	} else {
+		throw SyntaxError();
+	}
+}
+
 string Debugger::Cmd::help(const vector<string>& tokens) const
 {
 	static const string generalHelp =
@@ -720,6 +764,7 @@ string Debugger::Cmd::help(const vector<string>& tokens) const
 		"    remove_condition  remove a certain condition\n"
 		"    list_conditions   list the active conditions\n"
 		"    probe             probe related subcommands\n"
+		"    mirror            mirror debuggables in shared memory\n"
 		"    cont              continue execution after break\n"
 		"    step              execute one instruction\n"
 		"    break             break CPU at current position\n"
@@ -860,6 +905,17 @@ string Debugger::Cmd::help(const vector<string>& tokens) const
 		"    set_bp <probe> [-once] [<cond>] [<cmd>]  set a breakpoint on the given probe\n"
 		"    remove_bp <id>                           remove the given breakpoint\n"
 		"    list_bp                                  returns a list of breakpoints that are set on probes\n";
+	static const string mirrorHelp =
+		"debug mirror [add|remove <name>]\n"
+		"debug mirror segment\n"
+		"  Copy the content of the given debuggable to a shared memory "
+		"segment at the end of every frame, so that external tools on the "
+		"same host can read it without sending commands to openMSX. The "
+		"'add' subcommand returns the name of the segment, 'segment' "
+		"returns it as well (or an empty string when nothing is mirrored). "
+		"Without arguments it returns the list of mirrored debuggables.\n"
+		"  See the Console Command Reference for the layout of the "
+		"segment.\n";
 	static const string contHelp =
 		"debug cont\n"
 		"  Continue execution after CPU was breaked.\n";
@@ -925,6 +981,8 @@ string Debugger::Cmd::help(const vector<string>& tokens) const
 		return listCondHelp;
 	} else if (tokens[1] == "probe") {
 		return probeHelp;
+	} else if (tokens[1] == "mirror") {
+		return mirrorHelp;
 	} else if (tokens[1] == "cont") {
 		return contHelp;
 	} else if (tokens[1] == "step") {
@@ -972,7 +1030,7 @@ void Debugger::Cmd::tabCompletion(vector<string>& tokens) const
 	static constexpr const char* const otherCmds[] = {
 		"disasm", "set_bp", "remove_bp", "set_watchpoint",
 		"remove_watchpoint", "set_condition", "remove_condition",
-		"probe",
+		"probe", "mirror",
 	};
 	switch (tokens.size()) {
 	case 2: {
@@ -1006,6 +1064,11 @@ void Debugger::Cmd::tabCompletion(vector<string>& tokens) const
 					"remove_bp", "list_bp",
 				};
 				completeString(tokens, subCmds);
+			} else if (tokens[1] == "mirror") {
+				static constexpr const char* const subCmds[] = {
+					"add", "remove", "segment",
+				};
+				completeString(tokens, subCmds);
 			}
 		}
 		break;
@@ -1017,6 +1080,11 @@ void Debugger::Cmd::tabCompletion(vector<string>& tokens) const
 				debugger().probes,
 				[](auto* p) { return p->getName(); }));
 			completeString(tokens, probeNames);
+		} else if ((tokens[1] == "mirror") && (tokens[2] == "add")) {
+			completeString(tokens, view::keys(debugger().debuggables));
+		} else if ((tokens[1] == "mirror") && (tokens[2] == "remove") &&
+		           debugger().mirror) {
+			completeString(tokens, debugger().mirror->getNames());
 		}
 		break;
 	}
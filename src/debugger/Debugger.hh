@@ -15,6 +15,7 @@ namespace openmsx {
 
 class MSXMotherBoard;
 class Debuggable;
+class DebuggableMirror;
 class ProbeBase;
 class ProbeBreakPoint;
 class MSXCPU;
@@ -99,6 +100,7 @@ private:
 		void probeSetBreakPoint(span<const TclObject> tokens, TclObject& result);
 		void probeRemoveBreakPoint(span<const TclObject> tokens, TclObject& result);
 		void probeListBreakPoints(span<const TclObject> tokens, TclObject& result);
+		void mirror(span<const TclObject> tokens, TclObject& result);
 	} cmd;
 
 	struct NameFromProbe {
@@ -110,6 +112,7 @@ private:
 	hash_map<std::string, Debuggable*, XXHasher> debuggables;
 	hash_set<ProbeBase*, NameFromProbe, XXHasher> probes;
 	std::vector<std::unique_ptr<ProbeBreakPoint>> probeBreakPoints; // unordered
+	std::unique_ptr<DebuggableMirror> mirror; // created on first use
 	MSXCPU* cpu = nullptr;
 };
 
@@ -255,10 +255,17 @@ void AfterCommand::afterTime(span<const TclObject> tokens, TclObject& result)
 	MSXMotherBoard* motherBoard = reactor.getMotherBoard();
 	if (!motherBoard) return;
 	double time = getTime(getInterpreter(), tokens[2]);
+	result = addAfterTime(*motherBoard, time, tokens[3]);
+}
+
+string AfterCommand::addAfterTime(
+	MSXMotherBoard& motherBoard, double seconds, const TclObject& command)
+{
 	auto cmd = std::make_unique<AfterTimeCmd>(
-		motherBoard->getScheduler(), *this, tokens[3], time);
-	result = cmd->getId();
+		motherBoard.getScheduler(), *this, command, seconds);
+	string id = cmd->getId();
 	afterCmds.push_back(move(cmd));
+	return id;
 }
 
 void AfterCommand::afterRealTime(span<const TclObject> tokens, TclObject& result)
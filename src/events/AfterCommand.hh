@@ -13,6 +13,7 @@ class Reactor;
 class EventDistributor;
 class CommandController;
 class AfterCmd;
+class MSXMotherBoard;
 
 class AfterCommand final : public Command, private EventListener
 {
@@ -28,6 +29,11 @@ public:
 	std::string help(const std::vector<std::string>& tokens) const override;
 	void tabCompletion(std::vector<std::string>& tokens) const override;
 
+	/** Same as 'after time <seconds> <command>' on the given machine.
+	  * @return The id of the new after command. */
+	std::string addAfterTime(MSXMotherBoard& motherBoard, double seconds,
+	                         const TclObject& command);
+
 private:
 	template<typename PRED> void executeMatches(PRED pred);
 	template<EventType T> void executeEvents();
@@ -0,0 +1,71 @@
+#include "BinaryCliCommParser.hh"
+#include "endian.hh"
+#include <cstring>
+
+namespace openmsx {
+
+BinaryCliCommParser::BinaryCliCommParser(Callback callback_)
+	: callback(std::move(callback_))
+	, error(false)
+{
+}
+
+bool BinaryCliCommParser::parse(const char* buf, size_t n)
+{
+	if (error) return false;
+	buffer.append(buf, n);
+
+	size_t pos = 0;
+	while ((buffer.size() - pos) >= 4) {
+		auto len = Endian::read_UA_L32(&buffer[pos]);
+		if ((len < (HEADER_SIZE - 4)) || (len > MAX_FRAME_SIZE)) {
+			error = true;
+			return false;
+		}
+		if ((buffer.size() - pos - 4) < len) break; // incomplete frame
+		if (!parseFrame(std::string_view(&buffer[pos + 4], len))) {
+			error = true;
+			return false;
+		}
+		pos += 4 + len;
+	}
+	buffer.erase(0, pos);
+	return true;
+}
+
+bool BinaryCliCommParser::parseFrame(std::string_view frame)
+{
+	auto type = uint8_t(frame[0]);
+	auto id = Endian::read_UA_L32(&frame[1]);
+	frame.remove_prefix(1 + 4);
+	switch (type) {
+	case COMMAND:
+		callback(id, frame, span<const uint8_t>(nullptr, size_t(0)));
+		return true;
+	case COMMAND_WITH_DATA: {
+		if (frame.size() < 4) return false;
+		auto cmdLen = Endian::read_UA_L32(frame.data());
+		frame.remove_prefix(4);
+		if (frame.size() < cmdLen) return false;
+		auto* data = reinterpret_cast<const uint8_t*>(frame.data() + cmdLen);
+		callback(id, frame.substr(0, cmdLen),
+		         span<const uint8_t>(data, frame.size() - cmdLen));
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+std::string BinaryCliCommParser::makeFrame(
+	uint8_t type, uint32_t id, std::string_view payload)
+{
+	std::string result(HEADER_SIZE + payload.size(), '\0');
+	Endian::write_UA_L32(&result[0], uint32_t(1 + 4 + payload.size()));
+	result[4] = char(type);
+	Endian::write_UA_L32(&result[5], id);
+	memcpy(&result[HEADER_SIZE], payload.data(), payload.size());
+	return result;
+}
+
+} // namespace openmsx
@@ -0,0 +1,71 @@
+#ifndef BINARYCLICOMMPARSER_HH
+#define BINARYCLICOMMPARSER_HH
+
+#include "span.hh"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace openmsx {
+
+/** Parser for the binary (length-prefixed) variant of the control protocol.
+ *
+ * Each frame (in both directions) has this layout (all integers are
+ * little-endian):
+ *   uint32  length of the rest of the frame (so 5 + size of the payload)
+ *   uint8   frame type
+ *   uint32  request id, chosen by the client and echoed in the reply
+ *   ...     payload
+ *
+ * Request types (client -> openMSX):
+ *   COMMAND:           the payload is a Tcl command
+ *   COMMAND_WITH_DATA: the payload is a uint32 command length, the Tcl
+ *                      command and raw data. The command is split into
+ *                      words as a Tcl list (no substitutions) and the data
+ *                      is passed as an extra (last) argument, a bytearray.
+ * Reply types (openMSX -> client):
+ *   REPLY_OK:          the command succeeded, payload is the result (UTF-8)
+ *   REPLY_OK_BINARY:   the command succeeded, payload is the result as raw
+ *                      bytes (e.g. from 'debug read_block')
+ *   REPLY_NOK:         the command failed, payload is the error message
+ *   LOG:               (id is 0) payload is "<level>\0<message>"
+ *   UPDATE:            (id is 0) payload is "<type>\0<machine>\0<name>\0<value>"
+ */
+class BinaryCliCommParser
+{
+public:
+	enum RequestType : uint8_t { COMMAND = 0, COMMAND_WITH_DATA = 1 };
+	enum ReplyType : uint8_t {
+		REPLY_OK = 0, REPLY_OK_BINARY = 1, REPLY_NOK = 2, LOG = 3, UPDATE = 4
+	};
+	static constexpr size_t HEADER_SIZE = 4 + 1 + 4;
+	static constexpr size_t MAX_FRAME_SIZE = 256 * 1024 * 1024;
+
+	/** For COMMAND requests 'data' is an empty span with a nullptr. */
+	using Callback = std::function<void(
+		uint32_t id, std::string_view command, span<const uint8_t> data)>;
+
+	explicit BinaryCliCommParser(Callback callback);
+
+	/** Process the next part of the input stream. Returns false when the
+	  * input is malformed, it's not possible to resynchronize on the stream
+	  * after that, so the connection should be closed.
+	  */
+	bool parse(const char* buf, size_t n);
+
+	/** Construct a frame (header + payload). */
+	[[nodiscard]] static std::string makeFrame(
+		uint8_t type, uint32_t id, std::string_view payload);
+
+private:
+	bool parseFrame(std::string_view frame);
+
+	Callback callback;
+	std::string buffer; // received, but not yet processed data
+	bool error;
+};
+
+} // namespace openmsx
+
+#endif
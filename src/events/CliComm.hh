@@ -28,6 +28,7 @@ public:
 		EXTENSION,
 		SOUNDDEVICE,
 		CONNECTOR,
+		BATCH,
 		NUM_UPDATES // must be last
 	};
 
@@ -84,7 +85,8 @@ public:
 	static span<const char* const> getUpdateStrings() {
 		static constexpr const char* const updateStr[NUM_UPDATES] = {
 			"led", "setting", "setting-info", "hardware", "plug",
-			"media", "status", "extension", "sounddevice", "connector"
+			"media", "status", "extension", "sounddevice", "connector",
+			"batch"
 		};
 		return updateStr;
 	}
@@ -17,6 +17,7 @@
 #include "openmsx.hh"
 #include "ranges.hh"
 #include "unistdp.hh"
+#include "xrange.hh"
 #include <cassert>
 #include <iostream>
 
@@ -34,9 +35,12 @@ namespace openmsx {
 class CliCommandEvent final : public Event
 {
 public:
-	CliCommandEvent(string command_, const CliConnection* id_)
+	CliCommandEvent(string command_, const CliConnection* id_,
+	                uint32_t requestId_ = 0, string data_ = {},
+	                bool hasData_ = false)
 		: Event(OPENMSX_CLICOMMAND_EVENT)
-		, command(std::move(command_)), id(id_)
+		, command(std::move(command_)), data(std::move(data_))
+		, id(id_), requestId(requestId_), hasData(hasData_)
 	{
 	}
 	const string& getCommand() const
@@ -47,6 +51,16 @@ public:
 	{
 		return id;
 	}
+	uint32_t getRequestId() const
+	{
+		return requestId;
+	}
+	/** Raw data that should be passed as extra argument to the command
+	  * (only for the binary protocol). */
+	const string* getData() const
+	{
+		return hasData ? &data : nullptr;
+	}
 	TclObject toTclList() const override
 	{
 		return makeTclList("CliCmd", getCommand());
@@ -58,7 +72,10 @@ public:
 	}
 private:
 	const string command;
+	const string data;
 	const CliConnection* id;
+	const uint32_t requestId;
+	const bool hasData;
 };
 
 
@@ -67,8 +84,14 @@ private:
 CliConnection::CliConnection(CommandController& commandController_,
                              EventDistributor& eventDistributor_)
 	: parser([this](const std::string& cmd) { execute(cmd); })
+	, binaryParser([this](uint32_t id, std::string_view cmd, span<const uint8_t> data) {
+		execute(string(cmd), id, data);
+	})
 	, commandController(commandController_)
 	, eventDistributor(eventDistributor_)
+	, binaryInput(false)
+	, binaryOutput(false)
+	, binaryRequested(false)
 {
 	ranges::fill(updateEnabled, false);
 
@@ -83,6 +106,11 @@ CliConnection::~CliConnection()
 void CliConnection::log(CliComm::LogLevel level, std::string_view message)
 {
 	auto levelStr = CliComm::getLevelStrings();
+	if (binaryOutput) {
+		output(BinaryCliCommParser::makeFrame(BinaryCliCommParser::LOG, 0,
+			strCat(levelStr[level], '\0', message)));
+		return;
+	}
 	output(strCat("<log level=\"", levelStr[level], "\">",
 	              XMLElement::XMLEscape(message), "</log>\n"));
 }
@@ -93,6 +121,11 @@ void CliConnection::update(CliComm::UpdateType type, std::string_view machine,
 	if (!getUpdateEnable(type)) return;
 
 	auto updateStr = CliComm::getUpdateStrings();
+	if (binaryOutput) {
+		output(BinaryCliCommParser::makeFrame(BinaryCliCommParser::UPDATE, 0,
+			strCat(updateStr[type], '\0', machine, '\0', name, '\0', value)));
+		return;
+	}
 	string tmp = strCat("<update type=\"", updateStr[type], '\"');
 	if (!machine.empty()) {
 		strAppend(tmp, " machine=\"", machine, '\"');
@@ -117,7 +150,9 @@ void CliConnection::start()
 
 void CliConnection::end()
 {
-	output("</openmsx-output>\n");
+	if (!binaryOutput) {
+		output("</openmsx-output>\n");
+	}
 	close();
 
 	poller.abort();
@@ -127,29 +162,93 @@ void CliConnection::end()
 	}
 }
 
-void CliConnection::execute(const string& command)
+bool CliConnection::parse(const char* buf, size_t n)
+{
+	if (binaryInput) {
+		return binaryParser.parse(buf, n);
+	}
+	parser.parse(buf, n);
+	return true;
+}
+
+void CliConnection::switchToBinary()
 {
-	eventDistributor.distributeEvent(
-		std::make_shared<CliCommandEvent>(command, this));
+	binaryInput = true;
+	binaryRequested = true;
 }
 
-static string reply(const string& message, bool status)
+void CliConnection::execute(string command, uint32_t id, span<const uint8_t> data)
+{
+	auto hasData = data.data() != nullptr; // see BinaryCliCommParser
+	eventDistributor.distributeEvent(std::make_shared<CliCommandEvent>(
+		std::move(command), this, id,
+		string(reinterpret_cast<const char*>(data.data()), data.size()),
+		hasData));
+}
+
+static string xmlReply(std::string_view message, bool status)
 {
 	return strCat("<reply result=\"", (status ? "ok" : "nok"), "\">",
 	              XMLElement::XMLEscape(message), "</reply>\n");
 }
 
+void CliConnection::reply(uint32_t id, const TclObject& result)
+{
+	if (!binaryOutput) {
+		output(xmlReply(result.getString(), true));
+	} else if (result.isByteArray()) {
+		// send raw bytes, avoids the conversion to (and in the client
+		// from) a Tcl string
+		auto bin = result.getBinary();
+		output(BinaryCliCommParser::makeFrame(
+			BinaryCliCommParser::REPLY_OK_BINARY, id,
+			std::string_view(reinterpret_cast<const char*>(bin.data()),
+			                 bin.size())));
+	} else {
+		output(BinaryCliCommParser::makeFrame(
+			BinaryCliCommParser::REPLY_OK, id, result.getString()));
+	}
+}
+
+void CliConnection::replyError(uint32_t id, string message)
+{
+	if (!binaryOutput) {
+		output(xmlReply(message, false));
+	} else {
+		output(BinaryCliCommParser::makeFrame(
+			BinaryCliCommParser::REPLY_NOK, id, message));
+	}
+}
+
 int CliConnection::signalEvent(const std::shared_ptr<const Event>& event)
 {
 	auto& commandEvent = checked_cast<const CliCommandEvent&>(*event);
 	if (commandEvent.getId() == this) {
+		auto id = commandEvent.getRequestId();
 		try {
-			string result(commandController.executeCommand(
-				commandEvent.getCommand(), this).getString());
-			output(reply(result, true));
+			if (auto* data = commandEvent.getData()) {
+				// Pass the data as extra (last) argument. Build the
+				// command as a list (instead of a string) so that the
+				// data is not parsed (and possibly mangled) by Tcl.
+				auto& interp = commandController.getInterpreter();
+				TclObject command(commandEvent.getCommand());
+				TclObject words;
+				for (auto i : xrange(command.getListLength(interp))) {
+					words.addListElement(command.getListIndex(interp, i));
+				}
+				words.addListElement(span<const uint8_t>(
+					reinterpret_cast<const uint8_t*>(data->data()),
+					data->size()));
+				reply(id, commandController.executeCommand(words, this));
+			} else {
+				reply(id, commandController.executeCommand(
+					commandEvent.getCommand(), this));
+			}
 		} catch (CommandException& e) {
-			string result = std::move(e).getMessage() + '\n';
-			output(reply(result, false));
+			replyError(id, std::move(e).getMessage() + '\n');
+		}
+		if (binaryRequested.exchange(false)) {
+			binaryOutput = true;
 		}
 	}
 	return 0;
@@ -183,7 +282,7 @@ void StdioConnection::run()
 		char buf[BUF_SIZE];
 		int n = read(STDIN_FILENO, buf, sizeof(buf));
 		if (n > 0) {
-			parser.parse(buf, n);
+			if (!parse(buf, n)) break;
 		} else if (n < 0) {
 			break;
 		}
@@ -273,7 +372,7 @@ void PipeConnection::run()
 			if (!GetOverlappedResult(pipeHandle, &overlapped, &bytesRead, TRUE)) {
 				break; // Pipe broke
 			}
-			parser.parse(buf, bytesRead);
+			if (!parse(buf, bytesRead)) break;
 		} else if (wait == WAIT_OBJECT_0) {
 			break; // Shutdown
 		} else {
@@ -352,7 +451,7 @@ void SocketConnection::run()
 		char buf[BUF_SIZE];
 		int n = sock_recv(sd, buf, BUF_SIZE);
 		if (n > 0) {
-			parser.parse(buf, n);
+			if (!parse(buf, n)) break;
 		} else if (n < 0) {
 			break;
 		}
@@ -6,7 +6,10 @@
 #include "Socket.hh"
 #include "CliComm.hh"
 #include "AdhocCliCommParser.hh"
+#include "BinaryCliCommParser.hh"
 #include "Poller.hh"
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -15,6 +18,7 @@ namespace openmsx {
 
 class CommandController;
 class EventDistributor;
+class TclObject;
 
 class CliConnection : public CliListener, private EventListener
 {
@@ -26,6 +30,12 @@ public:
 		return updateEnabled[type];
 	}
 
+	/** Switch to the binary protocol (see BinaryCliCommParser). The reply
+	  * on the command that requested the switch is still sent in XML, all
+	  * later input and output uses the binary framing.
+	  */
+	void switchToBinary();
+
 	/** Starts the helper thread.
 	  * Called when this CliConnection is added to GlobalCliComm (and
 	  * after it's allowed to respond to external commands).
@@ -58,13 +68,22 @@ protected:
 	  */
 	void startOutput();
 
+	/** Process data received from the client (called from the helper
+	  * thread). Returns false when the connection should be closed.
+	  */
+	bool parse(const char* buf, size_t n);
+
 	AdhocCliCommParser parser;
+	BinaryCliCommParser binaryParser;
 	Poller poller;
 
 private:
 	virtual void run() = 0;
 
-	void execute(const std::string& command);
+	void execute(std::string command, uint32_t id = 0,
+	             span<const uint8_t> data = span<const uint8_t>(nullptr, size_t(0)));
+	void reply(uint32_t id, const TclObject& result);
+	void replyError(uint32_t id, std::string message);
 
 	// CliListener
 	void log(CliComm::LogLevel level, std::string_view message) override;
@@ -80,6 +99,14 @@ private:
 	std::thread thread;
 
 	bool updateEnabled[CliComm::NUM_UPDATES];
+
+	// Input is parsed in the helper thread, output happens in the main
+	// thread (but log() can be called from any thread). Input switches to
+	// binary before the reply on the switch-command is sent, output right
+	// after it.
+	std::atomic<bool> binaryInput;
+	std::atomic<bool> binaryOutput;
+	std::atomic<bool> binaryRequested;
 };
 
 class StdioConnection final : public CliConnection
@@ -25,11 +25,14 @@ void EventDistributor::registerEventListener(
 {
 	std::lock_guard<std::mutex> lock(mutex);
 	auto& priorityMap = listeners[type];
+	auto newMap = priorityMap ? std::make_shared<PriorityMap>(*priorityMap)
+	                          : std::make_shared<PriorityMap>();
 	// a listener may only be registered once for each type
-	assert(!contains(view::values(priorityMap), &listener));
+	assert(!contains(view::values(*newMap), &listener));
 	// insert at highest position that keeps listeners sorted on priority
-	auto it = ranges::upper_bound(priorityMap, priority, LessTupleElement<0>());
-	priorityMap.insert(it, {priority, &listener});
+	auto it = ranges::upper_bound(*newMap, priority, LessTupleElement<0>());
+	newMap->insert(it, {priority, &listener});
+	priorityMap = std::move(newMap);
 }
 
 void EventDistributor::unregisterEventListener(
@@ -37,8 +40,16 @@ void EventDistributor::unregisterEventListener(
 {
 	std::lock_guard<std::mutex> lock(mutex);
 	auto& priorityMap = listeners[type];
-	priorityMap.erase(rfind_if_unguarded(priorityMap,
+	assert(priorityMap);
+	auto newMap = std::make_shared<PriorityMap>(*priorityMap);
+	newMap->erase(rfind_if_unguarded(*newMap,
 		[&](auto& v) { return v.second == &listener; }));
+	if (newMap->empty()) {
+		priorityMap.reset();
+	} else {
+		priorityMap = std::move(newMap);
+	}
+	++unregisterCount;
 }
 
 void EventDistributor::distributeEvent(const EventPtr& event)
@@ -51,7 +62,7 @@ void EventDistributor::distributeEvent(const EventPtr& event)
 	//       queue the event?
 	assert(event);
 	std::unique_lock<std::mutex> lock(mutex);
-	if (!listeners[event->getType()].empty()) {
+	if (listeners[event->getType()]) {
 		scheduledEvents.push_back(event);
 		// must release lock, otherwise there's a deadlock:
 		//   thread 1: Reactor::deleteMotherBoard()
@@ -66,7 +77,8 @@ void EventDistributor::distributeEvent(const EventPtr& event)
 
 bool EventDistributor::isRegistered(EventType type, EventListener* listener) const
 {
-	return contains(view::values(listeners[type]), listener);
+	const auto& priorityMap = listeners[type];
+	return priorityMap && contains(view::values(*priorityMap), listener);
 }
 
 void EventDistributor::deliverEvents()
@@ -86,18 +98,25 @@ void EventDistributor::deliverEvents()
 	// unsubscribe from the ols MSXEventDistributor. This really should be
 	// done before we exit this method.
 	while (!scheduledEvents.empty()) {
-		EventQueue eventsCopy;
-		swap(eventsCopy, scheduledEvents);
+		// Swap with a queue that keeps its capacity, so that in steady
+		// state no memory is allocated here.
+		assert(deliveringEvents.empty());
+		swap(deliveringEvents, scheduledEvents);
 
-		for (auto& event : eventsCopy) {
+		for (auto& event : deliveringEvents) {
 			auto type = event->getType();
-			auto priorityMapCopy = listeners[type];
+			auto priorityMap = listeners[type]; // only copies the pointer
+			if (!priorityMap) continue; // unregistered after scheduling
+			unsigned count = unregisterCount;
 			lock.unlock();
 			auto blockPriority = unsigned(-1); // allow all
-			for (const auto& [priority, listener] : priorityMapCopy) {
+			for (const auto& [priority, listener] : *priorityMap) {
 				// It's possible delivery to one of the previous
 				// Listeners unregistered the current Listener.
-				if (!isRegistered(type, listener)) continue;
+				if (unregisterCount != count) {
+					std::lock_guard<std::mutex> lock2(mutex);
+					if (!isRegistered(type, listener)) continue;
+				}
 
 				if (priority >= blockPriority) break;
 
@@ -108,6 +127,7 @@ void EventDistributor::deliverEvents()
 			}
 			lock.lock();
 		}
+		deliveringEvents.clear();
 	}
 }
 
@@ -2,6 +2,7 @@
 #define EVENTDISTRIBUTOR_HH
 
 #include "Event.hh"
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -73,9 +74,14 @@ private:
 	Reactor& reactor;
 
 	using PriorityMap = std::vector<std::pair<Priority, EventListener*>>; // sorted on priority
-	PriorityMap listeners[NUM_EVENT_TYPES];
+	// Copy-on-write (nullptr when there are no listeners): (un)registering
+	// replaces the whole map, so deliverEvents() can keep on using the map
+	// it started with, without making a copy per event.
+	std::shared_ptr<const PriorityMap> listeners[NUM_EVENT_TYPES];
+	std::atomic<unsigned> unregisterCount{0};
 	using EventQueue = std::vector<EventPtr>;
 	EventQueue scheduledEvents;
+	EventQueue deliveringEvents; // only a member to reuse its storage
 	std::mutex mutex; // lock datastructures
 	std::mutex cvMutex; // lock condition_variable
 	std::condition_variable condition;
@@ -83,13 +83,17 @@ void GlobalCliComm::log(LogLevel level, std::string_view message)
 void GlobalCliComm::update(UpdateType type, std::string_view name, std::string_view value)
 {
 	assert(type < NUM_UPDATES);
-	if (auto v = lookup(prevValues[type], name)) {
-		if (*v == value) {
-			return;
+	// Batch results are not a state that can change, so always send them
+	// (also when a client reuses an id and gets the same result).
+	if (type != BATCH) {
+		if (auto v = lookup(prevValues[type], name)) {
+			if (*v == value) {
+				return;
+			}
+			*v = value;
+		} else {
+			prevValues[type].emplace_noDuplicateCheck(name, value);
 		}
-		*v = value;
-	} else {
-		prevValues[type].emplace_noDuplicateCheck(name, value);
 	}
 	updateHelper(type, {}, name, value);
 }
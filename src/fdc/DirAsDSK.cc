@@ -257,13 +257,14 @@ static string msxToHostName(const char* msxName)
 
 DirAsDSK::DirAsDSK(DiskChanger& diskChanger_, CliComm& cliComm_,
                    const Filename& hostDir_, SyncMode syncMode_,
-                   BootSectorType bootSectorType)
+                   BootSectorType bootSectorType, bool useHostNotifications)
 	: SectorBasedDisk(hostDir_)
 	, diskChanger(diskChanger_)
 	, cliComm(cliComm_)
 	, hostDir(hostDir_.getResolved() + '/')
 	, syncMode(syncMode_)
 	, lastAccess(EmuTime::zero())
+	, hostWatcher(useHostNotifications)
 	, nofSectors((diskChanger_.isDoubleSidedDrive() ? 2 : 1) * SECTORS_PER_TRACK * NUM_TRACKS)
 	, nofSectorsPerFat((((3 * nofSectors) / (2 * SECTORS_PER_CLUSTER)) + SECTOR_SIZE - 1) / SECTOR_SIZE)
 	, firstSector2ndFAT(FIRST_FAT_SECTOR + nofSectorsPerFat)
@@ -319,6 +320,7 @@ DirAsDSK::DirAsDSK(DiskChanger& diskChanger_, CliComm& cliComm_,
 	assert(mapDirs.empty());
 
 	// Import the host filesystem.
+	hostWatcher.reset();
 	syncWithHost();
 }
 
@@ -340,7 +342,7 @@ void DirAsDSK::checkCaches()
 		// Happens when dirasdisk is used in virtual_drive.
 		needSync = true;
 	}
-	if (needSync) {
+	if (needSync && hostWatcher.hasChanges()) {
 		flushCaches();
 	}
 }
@@ -364,8 +366,19 @@ void DirAsDSK::readSectorImpl(size_t sector, SectorBuffer& buf)
 			// Happens when dirasdisk is used in virtual_drive.
 			needSync = true;
 		}
-		if (needSync) {
-			syncWithHost();
+		// Without host change notifications hasChanges() always
+		// returns true, then we have to rescan the whole host
+		// directory to find changes.
+		if (needSync && hostWatcher.hasChanges()) {
+			auto changedPaths = hostWatcher.getChangedPaths();
+			// Reset before the sync, so that we don't miss changes
+			// that happen while we're scanning.
+			hostWatcher.reset();
+			if (changedPaths) {
+				syncChangedHostFiles(*changedPaths);
+			} else {
+				syncWithHost();
+			}
 			flushCaches(); // e.g. sha1sum
 			// Let the diskdrive report the disk has been ejected.
 			// E.g. a turbor machine uses this to flush its
@@ -395,6 +408,69 @@ void DirAsDSK::syncWithHost()
 	addNewHostFiles({}, firstDirSector);
 }
 
+void DirAsDSK::syncChangedHostFiles(const vector<string>& changedPaths)
+{
+	// Like syncWithHost(), but only for the given host files (as reported
+	// by the host OS), in the same order: removed, modified, new.
+	vector<string> hostNames; // relative to 'hostDir'
+	for (const auto& path : changedPaths) {
+		if (StringOp::startsWith(path, hostDir)) {
+			hostNames.push_back(path.substr(hostDir.size()));
+		}
+	}
+
+	for (const auto& hostName : hostNames) {
+		DirIndex dirIdx = findHostFileInDSK(hostName);
+		if ((dirIdx.sector != unsigned(-1)) &&
+		    (msxDir(dirIdx).attrib & MSXDirEntry::ATT_DIRECTORY) &&
+		    FileOperations::isDirectory(hostDir + hostName)) {
+			// A (still existing) host directory itself changed,
+			// e.g. it got replaced by another directory. Its
+			// content may be different, so rescan everything.
+			syncWithHost();
+			return;
+		}
+	}
+	for (const auto& hostName : hostNames) {
+		DirIndex dirIdx = findHostFileInDSK(hostName);
+		if (dirIdx.sector != unsigned(-1)) checkDeletedHostFile(dirIdx);
+	}
+	for (const auto& hostName : hostNames) {
+		DirIndex dirIdx = findHostFileInDSK(hostName);
+		if (dirIdx.sector != unsigned(-1)) checkModifiedHostFile(dirIdx);
+	}
+	for (const auto& hostName : hostNames) {
+		if (checkFileUsedInDSK(hostName)) continue;
+		// E.g. a temporary file that was already removed again.
+		if (!FileOperations::exists(hostDir + hostName)) continue;
+		auto pos = hostName.rfind('/');
+		auto hostSubDir = (pos == string::npos) ? string{}
+		                                        : hostName.substr(0, pos + 1);
+		unsigned msxDirSector = firstDirSector;
+		if (!hostSubDir.empty()) {
+			DirIndex dirIdx = findHostFileInDSK(
+				hostSubDir.substr(0, hostSubDir.size() - 1));
+			if (dirIdx.sector == unsigned(-1)) {
+				// Parent directory not (yet) mapped. If it's
+				// new as well, adding it also adds this file.
+				continue;
+			}
+			unsigned cluster = msxDir(dirIdx).startCluster;
+			if (!(msxDir(dirIdx).attrib & MSXDirEntry::ATT_DIRECTORY) ||
+			    (cluster < FIRST_CLUSTER) || (cluster >= maxCluster)) {
+				continue;
+			}
+			msxDirSector = clusterToSector(cluster);
+		}
+		try {
+			addNewHostEntry(hostSubDir, hostName.substr(hostSubDir.size()),
+			                msxDirSector);
+		} catch (MSXException& e) {
+			cliComm.printWarning(e.getMessage());
+		}
+	}
+}
+
 void DirAsDSK::checkDeletedHostFiles()
 {
 	// This handles both host files and directories.
@@ -411,20 +487,25 @@ void DirAsDSK::checkDeletedHostFiles()
 			// mapDirs. Ignore it.
 			continue;
 		}
-		string fullHostName = hostDir + mapDir.hostName;
-		bool isMSXDirectory = (msxDir(dirIdx).attrib &
-		                       MSXDirEntry::ATT_DIRECTORY) != 0;
-		FileOperations::Stat fst;
-		if ((!FileOperations::getStat(fullHostName, fst)) ||
-		    (FileOperations::isDirectory(fst) != isMSXDirectory)) {
-			// TODO also check access permission
-			// Error stat-ing file, or directory/file type is not
-			// the same on the msx and host side (e.g. a host file
-			// has been removed and a host directory with the same
-			// name has been created). In both cases delete the msx
-			// entry (if needed it will be recreated soon).
-			deleteMSXFile(dirIdx);
-		}
+		checkDeletedHostFile(dirIdx);
+	}
+}
+
+void DirAsDSK::checkDeletedHostFile(DirIndex dirIndex)
+{
+	string fullHostName = hostDir + mapDirs[dirIndex].hostName;
+	bool isMSXDirectory = (msxDir(dirIndex).attrib &
+	                       MSXDirEntry::ATT_DIRECTORY) != 0;
+	FileOperations::Stat fst;
+	if ((!FileOperations::getStat(fullHostName, fst)) ||
+	    (FileOperations::isDirectory(fst) != isMSXDirectory)) {
+		// TODO also check access permission
+		// Error stat-ing file, or directory/file type is not
+		// the same on the msx and host side (e.g. a host file
+		// has been removed and a host directory with the same
+		// name has been created). In both cases delete the msx
+		// entry (if needed it will be recreated soon).
+		deleteMSXFile(dirIndex);
 	}
 }
 
@@ -499,31 +580,37 @@ void DirAsDSK::checkModifiedHostFiles()
 			// See comment in checkDeletedHostFiles().
 			continue;
 		}
-		string fullHostName = hostDir + mapDir.hostName;
-		bool isMSXDirectory = (msxDir(dirIdx).attrib &
-		                       MSXDirEntry::ATT_DIRECTORY) != 0;
-		FileOperations::Stat fst;
-		if (FileOperations::getStat(fullHostName, fst) &&
-		    (FileOperations::isDirectory(fst) == isMSXDirectory)) {
-			// Detect changes in host file.
-			// Heuristic: we use filesize and modification time to detect
-			// changes in file content.
-			//  TODO do we need both filesize and mtime or is mtime alone
-			//       enough?
-			// We ignore time/size changes in directories,
-			// typically such a change indicates one of the files
-			// in that directory is changed/added/removed. But such
-			// changes are handled elsewhere.
-			if (!isMSXDirectory &&
-			    ((mapDir.mtime    != fst.st_mtime) ||
-			     (mapDir.filesize != size_t(fst.st_size)))) {
-				importHostFile(dirIdx, fst);
-			}
-		} else {
-			// Only very rarely happens (because checkDeletedHostFiles()
-			// checked this just recently).
-			deleteMSXFile(dirIdx);
+		checkModifiedHostFile(dirIdx);
+	}
+}
+
+void DirAsDSK::checkModifiedHostFile(DirIndex dirIndex)
+{
+	const auto& mapDir = mapDirs[dirIndex];
+	string fullHostName = hostDir + mapDir.hostName;
+	bool isMSXDirectory = (msxDir(dirIndex).attrib &
+	                       MSXDirEntry::ATT_DIRECTORY) != 0;
+	FileOperations::Stat fst;
+	if (FileOperations::getStat(fullHostName, fst) &&
+	    (FileOperations::isDirectory(fst) == isMSXDirectory)) {
+		// Detect changes in host file.
+		// Heuristic: we use filesize and modification time to detect
+		// changes in file content.
+		//  TODO do we need both filesize and mtime or is mtime alone
+		//       enough?
+		// We ignore time/size changes in directories,
+		// typically such a change indicates one of the files
+		// in that directory is changed/added/removed. But such
+		// changes are handled elsewhere.
+		if (!isMSXDirectory &&
+		    ((mapDir.mtime    != fst.st_mtime) ||
+		     (mapDir.filesize != size_t(fst.st_size)))) {
+			importHostFile(dirIndex, fst);
 		}
+	} else {
+		// Only very rarely happens (because checkDeletedHostFiles()
+		// checked this just recently).
+		deleteMSXFile(dirIndex);
 	}
 }
 
@@ -687,6 +774,10 @@ void DirAsDSK::addNewHostFiles(const string& hostSubDir, unsigned msxDirSector)
 	assert(!StringOp::startsWith(hostSubDir, '/'));
 	assert(hostSubDir.empty() || StringOp::endsWith(hostSubDir, '/'));
 
+	// Start watching before reading the directory, so that we also get
+	// notified about changes that happen while we're reading it.
+	hostWatcher.addDirectory(hostDir + hostSubDir);
+
 	vector<string> hostNames;
 	{
 		ReadDir dir(hostDir + hostSubDir);
@@ -699,29 +790,35 @@ void DirAsDSK::addNewHostFiles(const string& hostSubDir, unsigned msxDirSector)
 
 	for (auto& hostName : hostNames) {
 		try {
-			if (StringOp::startsWith(hostName, '.')) {
-				// skip '.' and '..'
-				// also skip hidden files on unix
-				continue;
-			}
-			string fullHostName = strCat(hostDir, hostSubDir, hostName);
-			FileOperations::Stat fst;
-			if (!FileOperations::getStat(fullHostName, fst)) {
-				throw MSXException("Error accessing ", fullHostName);
-			}
-			if (FileOperations::isDirectory(fst)) {
-				addNewDirectory(hostSubDir, hostName, msxDirSector, fst);
-			} else if (FileOperations::isRegularFile(fst)) {
-				addNewHostFile(hostSubDir, hostName, msxDirSector, fst);
-			} else {
-				throw MSXException("Not a regular file: ", fullHostName);
-			}
+			addNewHostEntry(hostSubDir, hostName, msxDirSector);
 		} catch (MSXException& e) {
 			cliComm.printWarning(e.getMessage());
 		}
 	}
 }
 
+void DirAsDSK::addNewHostEntry(const string& hostSubDir, const string& hostName,
+                               unsigned msxDirSector)
+{
+	if (StringOp::startsWith(hostName, '.')) {
+		// skip '.' and '..'
+		// also skip hidden files on unix
+		return;
+	}
+	string fullHostName = strCat(hostDir, hostSubDir, hostName);
+	FileOperations::Stat fst;
+	if (!FileOperations::getStat(fullHostName, fst)) {
+		throw MSXException("Error accessing ", fullHostName);
+	}
+	if (FileOperations::isDirectory(fst)) {
+		addNewDirectory(hostSubDir, hostName, msxDirSector, fst);
+	} else if (FileOperations::isRegularFile(fst)) {
+		addNewHostFile(hostSubDir, hostName, msxDirSector, fst);
+	} else {
+		throw MSXException("Not a regular file: ", fullHostName);
+	}
+}
+
 void DirAsDSK::addNewDirectory(const string& hostSubDir, const string& hostName,
                                unsigned msxDirSector, FileOperations::Stat& fst)
 {
@@ -3,6 +3,7 @@
 
 #include "SectorBasedDisk.hh"
 #include "DiskImageUtils.hh"
+#include "DirWatcher.hh"
 #include "FileOperations.hh"
 #include "EmuTime.hh"
 #include "hash_map.hh"
@@ -21,7 +22,7 @@ public:
 public:
 	DirAsDSK(DiskChanger& diskChanger, CliComm& cliComm,
 	         const Filename& hostDir, SyncMode syncMode,
-	         BootSectorType bootSectorType);
+	         BootSectorType bootSectorType, bool useHostNotifications);
 
 	// SectorBasedDisk
 	void readSectorImpl (size_t sector,       SectorBuffer& buf) override;
@@ -69,11 +70,15 @@ private:
 	void writeDIREntry(DirIndex dirIndex, DirIndex dirDirIndex,
 	                   const MSXDirEntry& newEntry);
 	void syncWithHost();
+	void syncChangedHostFiles(const std::vector<std::string>& changedPaths);
 	void checkDeletedHostFiles();
+	void checkDeletedHostFile(DirIndex dirIndex);
 	void deleteMSXFile(DirIndex dirIndex);
 	void deleteMSXFilesInDir(unsigned msxDirSector);
 	void freeFATChain(unsigned cluster);
 	void addNewHostFiles(const std::string& hostSubDir, unsigned msxDirSector);
+	void addNewHostEntry(const std::string& hostSubDir, const std::string& hostName,
+	                     unsigned msxDirSector);
 	void addNewDirectory(const std::string& hostSubDir, const std::string& hostName,
 	                     unsigned msxDirSector, FileOperations::Stat& fst);
 	void addNewHostFile(const std::string& hostSubDir, const std::string& hostName,
@@ -88,6 +93,7 @@ private:
 	bool checkMSXFileExists(const std::string& msxfilename,
 	                        unsigned msxDirSector);
 	void checkModifiedHostFiles();
+	void checkModifiedHostFile(DirIndex dirIndex);
 	void setMSXTimeStamp(DirIndex dirIndex, FileOperations::Stat& fst);
 	void importHostFile(DirIndex dirIndex, FileOperations::Stat& fst);
 	void exportToHost(DirIndex dirIndex, DirIndex dirDirIndex);
@@ -128,6 +134,11 @@ private:
 
 	EmuTime lastAccess; // last time there was a sector read/write
 
+	// Monitors the host directory (and its subdirectories) for changes.
+	// When this is active we can skip the (expensive) full rescan of the
+	// host directory when nothing changed.
+	DirWatcher hostWatcher;
+
 	// For each directory entry that has a mapped host file/directory we
 	// store the name, last modification time and size of the corresponding
 	// host file/dir.
@@ -31,6 +31,12 @@ DiskFactory::DiskFactory(Reactor& reactor_)
 		DirAsDSK::BOOTSECTOR_DOS2, EnumSetting<DirAsDSK::BootSectorType>::Map{
 			{"DOS1", DirAsDSK::BOOTSECTOR_DOS1},
 			{"DOS2", DirAsDSK::BOOTSECTOR_DOS2}})
+	, hostNotificationsSetting(
+		reactor.getCommandController(), "DirAsDSKnotify",
+		"use change notifications from the host OS (when available) "
+		"instead of periodically rescanning the host directory for "
+		"dir-as-dsk, only has effect for newly inserted disks",
+		true)
 {
 }
 
@@ -49,7 +55,8 @@ std::unique_ptr<Disk> DiskFactory::createDisk(
 			reactor.getCliComm(),
 			filename,
 			syncDirAsDSKSetting.getEnum(),
-			bootSectorSetting.getEnum());
+			bootSectorSetting.getEnum(),
+			hostNotificationsSetting.getBoolean());
 	} catch (MSXException&) {
 		// DirAsDSK didn't work, no problem
 	}
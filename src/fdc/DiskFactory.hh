@@ -2,6 +2,7 @@
 #define DISKFACTORY_HH
 
 #include "DirAsDSK.hh"
+#include "BooleanSetting.hh"
 #include "EnumSetting.hh"
 #include <string>
 
@@ -22,6 +23,7 @@ private:
 	Reactor& reactor;
 	EnumSetting<DirAsDSK::SyncMode> syncDirAsDSKSetting;
 	EnumSetting<DirAsDSK::BootSectorType> bootSectorSetting;
+	BooleanSetting hostNotificationsSetting;
 };
 
 } // namespace openmsx
@@ -2,12 +2,37 @@
 #include "EmptyDiskPatch.hh"
 #include "IPSPatch.hh"
 #include "DiskExceptions.hh"
+#include "ProfileCounters.hh"
 #include "sha1.hh"
 #include "xrange.hh"
 #include <memory>
+#include <string_view>
 
 namespace openmsx {
 
+enum class DiskCounters {
+	ReadSector,
+	WriteSector,
+	FlushCaches,
+	NUM // must be last
+};
+static std::ostream& operator<<(std::ostream& os, EnumTypeName<DiskCounters>)
+{
+	return os << "DiskCounters";
+}
+static std::ostream& operator<<(std::ostream& os, EnumValueName<DiskCounters> evn)
+{
+	std::string_view names[size_t(DiskCounters::NUM)] = {
+		"ReadSector",
+		"WriteSector",
+		"FlushCaches",
+	};
+	return os << names[size_t(evn.e)];
+}
+
+// Shared by all disk images.
+static RuntimeProfileCounters<DiskCounters> profileCounters("disk");
+
 SectorAccessibleDisk::SectorAccessibleDisk()
 	: patch(std::make_unique<EmptyDiskPatch>(*this))
 {
@@ -25,6 +50,7 @@ void SectorAccessibleDisk::readSector(size_t sector, SectorBuffer& buf)
 	    (getNbSectors() <= sector)) {
 		throw NoSuchSectorException("No such sector");
 	}
+	profileCounters.tick(DiskCounters::ReadSector);
 	try {
 		// in the end this calls readSectorImpl()
 		patch->copyBlock(sector * sizeof(buf), buf.raw, sizeof(buf));
@@ -41,6 +67,7 @@ void SectorAccessibleDisk::writeSector(size_t sector, const SectorBuffer& buf)
 	if (!isDummyDisk() && (getNbSectors() <= sector)) {
 		throw NoSuchSectorException("No such sector");
 	}
+	profileCounters.tick(DiskCounters::WriteSector);
 	try {
 		writeSectorImpl(sector, buf);
 	} catch (MSXException& e) {
@@ -145,6 +172,7 @@ void SectorAccessibleDisk::checkCaches()
 
 void SectorAccessibleDisk::flushCaches()
 {
+	profileCounters.tick(DiskCounters::FlushCaches);
 	sha1cache.clear();
 }
 
@@ -1,7 +1,9 @@
 #include "CompressedFileAdapter.hh"
 #include "FileException.hh"
+#include "SeekableInflate.hh"
 #include "hash_set.hh"
 #include "xxhash.hh"
+#include <algorithm>
 #include <cstring>
 
 using std::string;
@@ -18,7 +20,7 @@ static hash_set<std::shared_ptr<CompressedFileAdapter::Decompressed>,
 
 
 CompressedFileAdapter::CompressedFileAdapter(std::unique_ptr<FileBase> file_)
-	: file(std::move(file_)), pos(0)
+	: file(std::move(file_)), streamChecked(false), pos(0)
 {
 }
 
@@ -49,11 +51,50 @@ void CompressedFileAdapter::decompress()
 	}
 
 	// close original file after succesful decompress
+	stream.reset();
 	file.reset();
 }
 
+bool CompressedFileAdapter::getStreamInfo(FileBase& /*file*/, StreamInfo& /*info*/)
+{
+	return false;
+}
+
+bool CompressedFileAdapter::openStream()
+{
+	if (stream) return true;
+	if (decompressed || streamChecked) return false;
+	streamChecked = true;
+
+	// If another adapter already decompressed this file, share that.
+	if (decompressCache.find(getURL()) != end(decompressCache)) return false;
+
+	StreamInfo info;
+	if (!getStreamInfo(*file, info)) return false;
+	auto data = file->mmap();
+	// A size modulo 2^32 that's smaller than the compressed data means
+	// the real size is at least 4GB.
+	auto size = info.sizeKnown ? info.size
+	                           : std::max(info.size, data.size());
+	if (size < STREAM_THRESHOLD) return false;
+	if (data.size() < info.dataOffset) {
+		throw FileException("Error while decompressing: unexpected end of file.");
+	}
+	stream = std::make_unique<SeekableInflate>(
+		span<const uint8_t>(data.data() + info.dataOffset,
+		                    data.size() - info.dataOffset),
+		info.size, info.sizeKnown);
+	streamOriginalName = std::move(info.originalName);
+	return true;
+}
+
 void CompressedFileAdapter::read(void* buffer, size_t num)
 {
+	if (openStream()) {
+		stream->read(pos, buffer, num);
+		pos += num;
+		return;
+	}
 	decompress();
 	if (decompressed->size < (pos + num)) {
 		throw FileException("Read beyond end of file");
@@ -81,6 +122,7 @@ void CompressedFileAdapter::munmap()
 
 size_t CompressedFileAdapter::getSize()
 {
+	if (openStream()) return stream->getSize();
 	decompress();
 	return decompressed->size;
 }
@@ -112,6 +154,7 @@ string CompressedFileAdapter::getURL() const
 
 string CompressedFileAdapter::getOriginalName()
 {
+	if (openStream()) return streamOriginalName;
 	decompress();
 	return decompressed->originalName;
 }
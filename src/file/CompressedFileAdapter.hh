@@ -4,9 +4,12 @@
 #include "FileBase.hh"
 #include "MemBuffer.hh"
 #include <memory>
+#include <string>
 
 namespace openmsx {
 
+class SeekableInflate;
+
 class CompressedFileAdapter : public FileBase
 {
 public:
@@ -17,6 +20,18 @@ public:
 		std::string cachedURL;
 		time_t cachedModificationDate;
 	};
+	/** Location of the raw deflate stream in the compressed file. */
+	struct StreamInfo {
+		size_t dataOffset;
+		size_t size; // decompressed size
+		std::string originalName;
+		bool sizeKnown = true; // false: 'size' is only known modulo 2^32
+	};
+
+	/** Files with a decompressed size of at least this many bytes are
+	  * not decompressed as a whole, instead the data is decompressed on
+	  * demand (see SeekableInflate). Except for mmap(). */
+	static constexpr size_t STREAM_THRESHOLD = 16 * 1024 * 1024;
 
 	void read(void* buffer, size_t num) final override;
 	void write(const void* buffer, size_t num) final override;
@@ -36,12 +51,19 @@ protected:
 	explicit CompressedFileAdapter(std::unique_ptr<FileBase> file);
 	~CompressedFileAdapter() override;
 	virtual void decompress(FileBase& file, Decompressed& decompressed) = 0;
+	/** Fill in 'info' and return true when the compressed file consists of
+	  * a single raw deflate stream with known decompressed size. */
+	virtual bool getStreamInfo(FileBase& file, StreamInfo& info);
 
 private:
 	void decompress();
+	bool openStream();
 
 	std::unique_ptr<FileBase> file;
 	std::shared_ptr<Decompressed> decompressed;
+	std::unique_ptr<SeekableInflate> stream;
+	std::string streamOriginalName;
+	bool streamChecked;
 	size_t pos;
 };
 
@@ -0,0 +1,129 @@
+#include "DirWatcher.hh"
+#include "FileOperations.hh"
+#include "stl.hh"
+#include "systemfuncs.hh"
+
+#if HAVE_INOTIFY_INIT1
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace openmsx {
+
+DirWatcher::DirWatcher(bool enable)
+	: fd(-1), changed(true), unknownChanges(true)
+{
+#if HAVE_INOTIFY_INIT1
+	if (enable) {
+		fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	}
+#else
+	(void)enable;
+#endif
+}
+
+DirWatcher::~DirWatcher()
+{
+	disable();
+}
+
+void DirWatcher::disable()
+{
+#if HAVE_INOTIFY_INIT1
+	if (fd != -1) {
+		close(fd);
+		fd = -1;
+	}
+#endif
+	watches.clear();
+	changed = true;
+	unknownChanges = true;
+}
+
+void DirWatcher::reset()
+{
+	changed = false;
+	unknownChanges = (fd == -1);
+	changedPaths.clear();
+}
+
+std::optional<std::vector<std::string>> DirWatcher::getChangedPaths() const
+{
+	if (unknownChanges) return {};
+	return changedPaths;
+}
+
+void DirWatcher::addDirectory(const std::string& directory)
+{
+#if HAVE_INOTIFY_INIT1
+	if (fd == -1) return;
+	constexpr uint32_t mask =
+		IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+		IN_DELETE_SELF | IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM |
+		IN_MOVED_TO | IN_ONLYDIR;
+	int wd = inotify_add_watch(fd, directory.c_str(), mask);
+	if (wd == -1) {
+		// E.g. the limit on the number of watches is reached. We can
+		// no longer guarantee to see all changes, so fall back to
+		// polling.
+		disable();
+		return;
+	}
+	// Adding the same directory again gives the same descriptor.
+	watches[wd] = directory;
+#else
+	(void)directory;
+#endif
+}
+
+bool DirWatcher::hasChanges()
+{
+#if HAVE_INOTIFY_INIT1
+	if (fd == -1) return true;
+
+	alignas(struct inotify_event) char buf[4096];
+	while (true) {
+		auto len = read(fd, buf, sizeof(buf));
+		if (len > 0) {
+			changed = true;
+			for (ssize_t i = 0; i < len; /**/) {
+				auto* event = reinterpret_cast<const inotify_event*>(&buf[i]);
+				i += sizeof(inotify_event) + event->len;
+				if (event->mask & IN_IGNORED) {
+					// watch removed (directory deleted)
+					watches.erase(event->wd);
+				} else if (event->len) {
+					// an entry of a watched directory
+					auto* dir = lookup(watches, event->wd);
+					if (!dir) {
+						unknownChanges = true;
+						continue;
+					}
+					auto path = FileOperations::join(*dir, event->name);
+					if (!contains(changedPaths, path)) {
+						changedPaths.push_back(std::move(path));
+					}
+				} else if (event->mask & (IN_Q_OVERFLOW | IN_MOVE_SELF)) {
+					// Events were lost, or a watched directory
+					// moved (then the paths we know are wrong).
+					// Changes on a directory itself (e.g.
+					// IN_DELETE_SELF) are also reported as a
+					// change of an entry in its parent.
+					unknownChanges = true;
+				}
+			}
+		} else if ((len == -1) && (errno == EINTR)) {
+			continue;
+		} else if ((len == -1) && (errno == EAGAIN)) {
+			break; // no more pending events
+		} else {
+			disable();
+			return true;
+		}
+	}
+#endif
+	return changed;
+}
+
+} // namespace openmsx
@@ -0,0 +1,79 @@
+#ifndef DIRWATCHER_HH
+#define DIRWATCHER_HH
+
+#include "hash_map.hh"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+/**
+ * Detects changes in (a set of) host directories.
+ * On platforms that support it (ATM only Linux via inotify) the host OS
+ * notifies us about changes, so that the user doesn't have to rescan the
+ * directories to find out whether something changed. When such a mechanism
+ * is not available (or it stopped working, e.g. because the system limit on
+ * the number of watches was reached) this class conservatively reports that
+ * there might be changes. So the user should then fall back to polling.
+ * Apart from whether something changed, it also tracks which entries of the
+ * watched directories changed, so that the user can update only those.
+ *
+ * Note: watching a directory is not recursive, each (sub)directory that
+ * should be monitored must be added individually.
+ */
+class DirWatcher
+{
+public:
+	DirWatcher(const DirWatcher&) = delete;
+	DirWatcher& operator=(const DirWatcher&) = delete;
+
+	/** When 'enable' is false, no notification mechanism is used, so
+	  * hasChanges() always returns true.
+	  */
+	explicit DirWatcher(bool enable);
+	~DirWatcher();
+
+	/** Is the notification mechanism working? If not, hasChanges()
+	  * always returns true.
+	  */
+	bool isActive() const { return fd != -1; }
+
+	/** Start monitoring the given directory (it's OK to add the same
+	  * directory multiple times). Deleted directories are automatically
+	  * removed from the set of watched directories.
+	  */
+	void addDirectory(const std::string& directory);
+
+	/** Did something (possibly) change in one of the watched directories
+	  * since the last call to reset()? This does not reset the state.
+	  */
+	bool hasChanges();
+
+	/** Forget about all changes reported so far.
+	  */
+	void reset();
+
+	/** The full paths of the entries (files or subdirectories) of the
+	  * watched directories that were created, deleted, renamed or
+	  * modified since the last call to reset(). Each path is reported
+	  * at most once. The result is empty when that's not known (e.g.
+	  * no notification mechanism, or the host OS dropped events), then
+	  * the user must rescan all directories. Call hasChanges() first to
+	  * pick up the pending events.
+	  */
+	std::optional<std::vector<std::string>> getChangedPaths() const;
+
+private:
+	void disable();
+
+	hash_map<int, std::string> watches; // watch descriptor -> directory
+	std::vector<std::string> changedPaths;
+	int fd;
+	bool changed;
+	bool unknownChanges; // changes for which there's no path
+};
+
+} // namespace openmsx
+
+#endif
@@ -1,6 +1,7 @@
 #include "GZFileAdapter.hh"
 #include "ZlibInflate.hh"
 #include "FileException.hh"
+#include "endian.hh"
 
 namespace openmsx {
 
@@ -62,4 +63,17 @@ void GZFileAdapter::decompress(FileBase& f, Decompressed& d)
 	d.size = zlib.inflate(d.buf);
 }
 
+bool GZFileAdapter::getStreamInfo(FileBase& f, StreamInfo& info)
+{
+	auto data = f.mmap();
+	if (data.size() < 8) return false;
+	ZlibInflate zlib(data);
+	if (!skipHeader(zlib, info.originalName)) return false;
+	info.dataOffset = zlib.getInputPos();
+	// The gzip trailer stores the decompressed size modulo 2^32.
+	info.size = Endian::read_UA_L32(data.data() + data.size() - 4);
+	info.sizeKnown = false;
+	return true;
+}
+
 } // namespace openmsx
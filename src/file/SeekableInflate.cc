@@ -0,0 +1,294 @@
+#include "SeekableInflate.hh"
+#include "FileException.hh"
+#include "hash_map.hh"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <list>
+#include <mutex>
+
+namespace openmsx {
+
+constexpr size_t SPAN = 1024 * 1024; // minimal distance between access points
+constexpr size_t WINSIZE = 32768;    // size of the deflate history window
+
+// Decompressed chunks, shared by all SeekableInflate objects. Files can be
+// read from different threads (e.g. the laserdisc decoder), so all access
+// to the cache goes via 'cacheMutex'. The chunks themselves are shared_ptrs,
+// a chunk that is evicted while another thread still copies from it stays
+// alive till that copy is done.
+struct ChunkKey {
+	const SeekableInflate* owner;
+	size_t index;
+
+	bool operator==(const ChunkKey& other) const {
+		return (owner == other.owner) && (index == other.index);
+	}
+};
+struct ChunkKeyHash {
+	size_t operator()(const ChunkKey& key) const {
+		return std::hash<const void*>()(key.owner) ^ (key.index * 0x9E3779B9);
+	}
+};
+struct CachedChunk {
+	ChunkKey key;
+	std::shared_ptr<const MemBuffer<uint8_t>> data;
+	size_t size;
+};
+using ChunkList = std::list<CachedChunk>; // most recently used in front
+static std::mutex cacheMutex;
+static ChunkList chunkCache;
+static hash_map<ChunkKey, ChunkList::iterator, ChunkKeyHash> chunkIndex;
+static size_t cachedSize = 0;
+static size_t cacheLimit = 64 * 1024 * 1024;
+
+// all helpers below must be called with 'cacheMutex' locked
+static void removeFromCache(ChunkList::iterator it)
+{
+	cachedSize -= it->size;
+	chunkIndex.erase(it->key);
+	chunkCache.erase(it);
+}
+
+static void shrinkCache()
+{
+	// Always keep the most recently used chunk.
+	while ((cachedSize > cacheLimit) && (chunkCache.size() > 1)) {
+		removeFromCache(std::prev(end(chunkCache)));
+	}
+}
+
+static std::shared_ptr<const MemBuffer<uint8_t>> addToCache(
+	const SeekableInflate* owner, size_t index,
+	MemBuffer<uint8_t>&& data, size_t size)
+{
+	auto chunk = std::make_shared<const MemBuffer<uint8_t>>(std::move(data));
+	ChunkKey key{owner, index};
+	if (auto* it = lookup(chunkIndex, key)) {
+		// can't happen ATM (each object is used by one thread)
+		removeFromCache(*it);
+	}
+	chunkCache.push_front({key, chunk, size});
+	chunkIndex.emplace(key, begin(chunkCache));
+	cachedSize += size;
+	shrinkCache();
+	return chunk;
+}
+
+void SeekableInflate::setCacheLimit(size_t bytes)
+{
+	std::lock_guard lock(cacheMutex);
+	cacheLimit = bytes;
+	shrinkCache();
+}
+
+
+SeekableInflate::SeekableInflate(
+		span<const uint8_t> input_, size_t size_, bool sizeKnown_)
+	: input(input_), size(size_)
+	, builderInit(false), indexComplete(false), sizeKnown(sizeKnown_)
+{
+	if (input.size() > std::numeric_limits<decltype(builder.avail_in)>::max()) {
+		throw FileException(
+			"Error while decompressing: input file too big");
+	}
+	points.push_back({0, 0, 0, {}});
+}
+
+SeekableInflate::~SeekableInflate()
+{
+	if (builderInit) {
+		inflateEnd(&builder);
+	}
+	std::lock_guard lock(cacheMutex);
+	for (auto it = begin(chunkCache); it != end(chunkCache); /**/) {
+		auto next = std::next(it);
+		if (it->key.owner == this) removeFromCache(it);
+		it = next;
+	}
+}
+
+void SeekableInflate::read(size_t offset, void* buffer, size_t num)
+{
+	if (sizeKnown && (size < (offset + num))) {
+		throw FileException("Read beyond end of file");
+	}
+	auto* out = static_cast<uint8_t*>(buffer);
+	while (num) {
+		while (!indexComplete && (points.back().out <= offset)) {
+			extendIndex();
+		}
+		if (points.back().out <= offset) {
+			// stream was shorter than announced
+			throw FileException("Read beyond end of file");
+		}
+		auto it = std::upper_bound(begin(points), end(points), offset,
+			[](size_t o, const AccessPoint& p) { return o < p.out; });
+		auto index = size_t(it - begin(points)) - 1;
+		auto chunk = getChunk(index);
+		auto chunkSize = points[index + 1].out - points[index].out;
+		auto chunkOffset = offset - points[index].out;
+		auto n = std::min(num, chunkSize - chunkOffset);
+		memcpy(out, chunk->data() + chunkOffset, n);
+		out += n;
+		offset += n;
+		num -= n;
+	}
+}
+
+std::shared_ptr<const MemBuffer<uint8_t>> SeekableInflate::getChunk(size_t index)
+{
+	{
+		std::lock_guard lock(cacheMutex);
+		if (auto* it = lookup(chunkIndex, ChunkKey{this, index})) {
+			// move to front
+			chunkCache.splice(begin(chunkCache), chunkCache, *it);
+			return (*it)->data;
+		}
+	}
+	// decompress without holding the lock
+	auto len = points[index + 1].out - points[index].out;
+	MemBuffer<uint8_t> buf;
+	decompressChunk(index, buf, len);
+	std::lock_guard lock(cacheMutex);
+	return addToCache(this, index, std::move(buf), len);
+}
+
+// Decompress the next chunk (after points.back()) and add a new access point
+// at the end of it.
+void SeekableInflate::extendIndex()
+{
+	if (!builderInit) {
+		builder.zalloc = nullptr;
+		builder.zfree  = nullptr;
+		builder.opaque = nullptr;
+		builder.next_in  = const_cast<uint8_t*>(input.data());
+		builder.avail_in = uInt(input.size());
+		int initErr = inflateInit2(&builder, -MAX_WBITS);
+		if (initErr != Z_OK) {
+			throw FileException(
+				"Error initializing inflate struct: ", zError(initErr));
+		}
+		builderInit = true;
+	}
+
+	size_t capacity = 2 * SPAN;
+	MemBuffer<uint8_t> buf(capacity);
+	size_t len = 0;
+	bool last = false;
+	while (true) {
+		if (len == capacity) {
+			capacity *= 2;
+			buf.resize(capacity);
+		}
+		builder.next_out = buf.data() + len;
+		builder.avail_out = uInt(capacity - len);
+		// Z_BLOCK: stop at the end of each deflate block
+		int err = ::inflate(&builder, Z_BLOCK);
+		len = capacity - builder.avail_out;
+		if (err == Z_STREAM_END) {
+			last = true;
+			break;
+		}
+		if ((err == Z_BUF_ERROR) && (builder.avail_out == 0)) {
+			continue; // output buffer full
+		}
+		if (err != Z_OK) {
+			throw FileException("Error while decompressing: ",
+				(err == Z_BUF_ERROR) ? "unexpected end of file."
+				                     : zError(err));
+		}
+		bool blockEnd = (builder.data_type & 128) &&
+		               !(builder.data_type & 64);
+		if (blockEnd && (len >= SPAN)) break;
+	}
+
+	auto start = points.back().out;
+	checkSize(start + len, last);
+	if (!last) {
+		AccessPoint p{start + len,
+		              size_t(builder.next_in - input.data()),
+		              builder.data_type & 7,
+		              MemBuffer<uint8_t>(WINSIZE)};
+		memcpy(p.window.data(), buf.data() + len - WINSIZE, WINSIZE);
+		points.push_back(std::move(p));
+	} else {
+		inflateEnd(&builder);
+		builderInit = false;
+		indexComplete = true;
+		if (len == 0) {
+			// points.back() becomes the end marker
+			size = start;
+			return;
+		}
+		points.push_back({start + len, size_t(builder.next_in - input.data()), 0, {}});
+		size = start + len;
+	}
+	// the chunk is likely needed right away
+	buf.resize(len);
+	std::lock_guard lock(cacheMutex);
+	addToCache(this, points.size() - 2, std::move(buf), len);
+}
+
+// 'end' is the amount of data decompressed so far, 'last' is true when
+// that's the whole stream.
+void SeekableInflate::checkSize(size_t end, bool last)
+{
+	if (sizeKnown) return;
+	// Only the lower 32 bits of the size are known, the stream must have
+	// been (a multiple of) 4GB larger.
+	uint64_t newSize = size;
+	while (newSize < end) newSize += uint64_t(1) << 32;
+	if (newSize > std::numeric_limits<size_t>::max()) {
+		throw FileException(
+			"Error while decompressing: input file too big");
+	}
+	size = size_t(newSize);
+	if (last) {
+		if (size != end) {
+			throw FileException(
+				"Error while decompressing: wrong size in trailer.");
+		}
+		sizeKnown = true;
+	}
+}
+
+void SeekableInflate::decompressChunk(
+	size_t index, MemBuffer<uint8_t>& output, size_t len)
+{
+	const auto& p = points[index];
+	z_stream s;
+	s.zalloc = nullptr;
+	s.zfree  = nullptr;
+	s.opaque = nullptr;
+	s.next_in  = const_cast<uint8_t*>(input.data() + p.in);
+	s.avail_in = uInt(input.size() - p.in);
+	int initErr = inflateInit2(&s, -MAX_WBITS);
+	if (initErr != Z_OK) {
+		throw FileException(
+			"Error initializing inflate struct: ", zError(initErr));
+	}
+	if (p.bits) {
+		inflatePrime(&s, p.bits, input[p.in - 1] >> (8 - p.bits));
+	}
+	if (!p.window.empty()) {
+		inflateSetDictionary(&s, p.window.data(), uInt(WINSIZE));
+	}
+
+	output.resize(len);
+	s.next_out = output.data();
+	s.avail_out = uInt(len);
+	int err;
+	do {
+		err = ::inflate(&s, Z_NO_FLUSH);
+	} while ((err == Z_OK) && (s.avail_out != 0));
+	inflateEnd(&s);
+	if (s.avail_out != 0) {
+		throw FileException("Error while decompressing: ",
+			(err == Z_STREAM_END || err == Z_BUF_ERROR)
+				? "unexpected end of file." : zError(err));
+	}
+}
+
+} // namespace openmsx
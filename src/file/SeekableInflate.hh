@@ -0,0 +1,89 @@
+#ifndef SEEKABLEINFLATE_HH
+#define SEEKABLEINFLATE_HH
+
+#include "MemBuffer.hh"
+#include "span.hh"
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <zlib.h>
+
+namespace openmsx {
+
+/** Random access in a (raw) deflate stream, without decompressing the whole
+ * stream up front.
+ *
+ * This is based on the ideas of 'zran.c' from the zlib examples: while
+ * decompressing the stream for the first time, the complete decompressor
+ * state is remembered at regular intervals (at a deflate block boundary,
+ * roughly every 1MB of output). Later a read anywhere in the stream only
+ * needs to decompress from the nearest preceding access point. This index is
+ * built lazily, only as far as needed for the reads done so far.
+ *
+ * The data between two access points is called a chunk. Recently used chunks
+ * are kept in memory. The total memory used for these chunks (shared by all
+ * SeekableInflate objects) is bounded by setCacheLimit(). That cache is
+ * thread-safe, but a single SeekableInflate object should only be used by
+ * one thread.
+ */
+class SeekableInflate
+{
+public:
+	SeekableInflate(const SeekableInflate&) = delete;
+	SeekableInflate& operator=(const SeekableInflate&) = delete;
+
+	/** @param input The compressed data, must remain valid during the
+	  *              lifetime of this object.
+	  * @param size The size of the decompressed data (e.g. from the zip
+	  *             header).
+	  * @param sizeKnown False when 'size' is only the size modulo 2^32
+	  *                  (that's all the gzip trailer stores). It's checked
+	  *                  once the end of the stream is reached.
+	  */
+	SeekableInflate(span<const uint8_t> input, size_t size, bool sizeKnown);
+	~SeekableInflate();
+
+	/** The decompressed size. This doesn't decompress anything. When
+	  * the size is only known modulo 2^32 this is the smallest size that
+	  * matches that and the data decompressed so far, so it's too small
+	  * for a stream of 4GB or more until that was read up to its end.
+	  */
+	[[nodiscard]] size_t getSize() const { return size; }
+
+	/** Read 'num' bytes starting at (decompressed) position 'offset'.
+	  * @throws FileException on read beyond end or on corrupt input.
+	  */
+	void read(size_t offset, void* buffer, size_t num);
+
+	/** Set the maximum amount of memory (in bytes) used to cache
+	  * decompressed chunks. */
+	static void setCacheLimit(size_t bytes);
+
+private:
+	struct AccessPoint {
+		size_t out; // position in the decompressed data
+		size_t in;  // position in the compressed data
+		int bits;   // number of bits (1-7) still needed from input[in - 1]
+		MemBuffer<uint8_t> window; // last 32kB of output, empty for 1st point
+	};
+
+	[[nodiscard]] std::shared_ptr<const MemBuffer<uint8_t>> getChunk(size_t index);
+	void extendIndex();
+	void checkSize(size_t end, bool last);
+	void decompressChunk(size_t index, MemBuffer<uint8_t>& output, size_t len);
+
+	const span<const uint8_t> input;
+	size_t size;
+
+	// points[i] is the start of chunk 'i'. Once the index is complete the
+	// last element marks the end of the stream (it's not a chunk).
+	std::vector<AccessPoint> points;
+	z_stream builder; // to (incrementally) build the index
+	bool builderInit;
+	bool indexComplete;
+	bool sizeKnown;
+};
+
+} // namespace openmsx
+
+#endif
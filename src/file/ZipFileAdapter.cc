@@ -9,16 +9,17 @@ ZipFileAdapter::ZipFileAdapter(std::unique_ptr<FileBase> file_)
 {
 }
 
-void ZipFileAdapter::decompress(FileBase& f, Decompressed& d)
+// Parse the local file header, returns the "general purpose bit flag".
+static unsigned parseHeader(ZlibInflate& zlib, unsigned& origSize,
+                            std::string& originalName)
 {
-	ZlibInflate zlib(f.mmap());
-
 	if (zlib.get32LE() != 0x04034B50) {
 		throw FileException("Invalid ZIP file");
 	}
 
-	// skip "version needed to extract" and "general purpose bit flag"
-	zlib.skip(2 + 2);
+	// skip "version needed to extract"
+	zlib.skip(2);
+	unsigned flags = zlib.get16LE(); // general purpose bit flag
 
 	// compression method
 	if (zlib.get16LE() != 0x0008) {
@@ -29,13 +30,32 @@ void ZipFileAdapter::decompress(FileBase& f, Decompressed& d)
 	//      "crc32",              "compressed size"
 	zlib.skip(2 + 2 + 4 + 4);
 
-	unsigned origSize = zlib.get32LE(); // uncompressed size
+	origSize = zlib.get32LE(); // uncompressed size
 	unsigned filenameLen = zlib.get16LE(); // filename length
 	unsigned extraFieldLen = zlib.get16LE(); // extra field length
-	d.originalName = zlib.getString(filenameLen); // original filename
+	originalName = zlib.getString(filenameLen); // original filename
 	zlib.skip(extraFieldLen); // skip "extra field"
+	return flags;
+}
 
+void ZipFileAdapter::decompress(FileBase& f, Decompressed& d)
+{
+	ZlibInflate zlib(f.mmap());
+	unsigned origSize;
+	parseHeader(zlib, origSize, d.originalName);
 	d.size = zlib.inflate(d.buf, origSize);
 }
 
+bool ZipFileAdapter::getStreamInfo(FileBase& f, StreamInfo& info)
+{
+	ZlibInflate zlib(f.mmap());
+	unsigned origSize;
+	unsigned flags = parseHeader(zlib, origSize, info.originalName);
+	// bit 3: sizes are stored in a data descriptor after the data
+	if (flags & 0x08) return false;
+	info.dataOffset = zlib.getInputPos();
+	info.size = origSize;
+	return true;
+}
+
 } // namespace openmsx
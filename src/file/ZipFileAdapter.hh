@@ -12,6 +12,7 @@ public:
 
 private:
 	void decompress(FileBase& file, Decompressed& decompressed) override;
+	bool getStreamInfo(FileBase& file, StreamInfo& info) override;
 };
 
 } // namespace openmsx
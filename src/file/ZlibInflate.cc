@@ -18,6 +18,7 @@ ZlibInflate::ZlibInflate(span<uint8_t> input)
 	s.opaque = nullptr;
 	s.next_in  = const_cast<uint8_t*>(input.data());
 	s.avail_in = inputLen;
+	inputStart = input.data();
 	wasInit = false;
 }
 
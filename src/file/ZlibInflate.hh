@@ -22,10 +22,14 @@ public:
 	std::string getString(size_t len);
 	std::string getCString();
 
+	/** Number of (compressed) input bytes consumed so far. */
+	size_t getInputPos() const { return s.next_in - inputStart; }
+
 	size_t inflate(MemBuffer<uint8_t>& output, size_t sizeHint = 65536);
 
 private:
 	z_stream s;
+	const uint8_t* inputStart;
 	bool wasInit;
 };
 
@@ -4,6 +4,7 @@
 #include "DeviceConfig.hh"
 #include "CliComm.hh"
 #include "HDImageCLI.hh"
+#include "HDOverlay.hh"
 #include "MSXMotherBoard.hh"
 #include "Reactor.hh"
 #include "Display.hh"
@@ -14,6 +15,7 @@
 #include "serialize.hh"
 #include "tiger.hh"
 #include "xrange.hh"
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -59,8 +61,7 @@ HD::HD(const DeviceConfig& config)
 		file.truncate(size_t(config.getChildDataAsInt("size")) * 1024 * 1024);
 		filesize = file.getSize();
 	}
-	tigerTree = std::make_unique<TigerTree>(
-		*this, filesize, filename.getResolved());
+	createTigerTree();
 
 	(*hdInUse)[id] = true;
 	hdCommand = std::make_unique<HDCommand>(
@@ -84,15 +85,101 @@ HD::~HD()
 
 void HD::switchImage(const Filename& newFilename)
 {
+	// An overlay only makes sense in combination with its base image.
+	overlay.reset();
 	file = File(newFilename);
 	filename = newFilename;
 	filesize = file.getSize();
-	tigerTree = std::make_unique<TigerTree>(*this, filesize,
-			filename.getResolved());
+	createTigerTree();
+	flushCaches();
 	motherBoard.getMSXCliComm().update(CliComm::MEDIA, getName(),
 	                                   filename.getResolved());
 }
 
+void HD::attachOverlay(const Filename& overlayName)
+{
+	auto newOverlay = std::make_unique<HDOverlay>(
+		overlayName, getNbSectorsImpl());
+	// From now on the base image is never written anymore (the overlay
+	// takes all writes), but keep opening it the normal way so that
+	// compressed images are still decompressed.
+	file = File(filename);
+	overlay = std::move(newOverlay);
+	createTigerTree();
+	flushCaches();
+}
+
+void HD::detachOverlay()
+{
+	if (!overlay) return;
+	overlay.reset();
+	file = File(filename);
+	createTigerTree();
+	flushCaches();
+}
+
+void HD::commitOverlay()
+{
+	if (!overlay) {
+		throw MSXException("No overlay attached");
+	}
+	// Write via 'file' itself (not via a 2nd File object on the same
+	// image), otherwise its buffer could still hold the old content of
+	// these sectors when it's read again after the overlay is cleared.
+	//
+	// This is also allowed while the MSX is running: commands are only
+	// executed in between emulation steps, and the content of the disk
+	// as seen by the MSX (base image + overlay) doesn't change.
+	if (file.isReadOnly()) {
+		throw MSXException("Harddisk image is read-only: ",
+		                   filename.getResolved());
+	}
+	SectorBuffer buf;
+	overlay->forEachSector([&](size_t sector) {
+		overlay->readSector(sector, buf);
+		file.seek(sector * sizeof(buf));
+		file.write(&buf, sizeof(buf));
+	});
+	file.flush();
+	overlay->clear();
+	// The content (as seen by the MSX) didn't change, so all hashes
+	// remain valid. Only update the timestamp of the cached hashes.
+	tigerTree->notifyChange(0, 0, getModificationDate());
+}
+
+void HD::discardOverlay()
+{
+	if (!overlay) {
+		throw MSXException("No overlay attached");
+	}
+	overlay->forEachSector([&](size_t sector) {
+		tigerTree->notifyChange(sector * sizeof(SectorBuffer),
+		                        sizeof(SectorBuffer), 0);
+	});
+	overlay->clear();
+	tigerTree->notifyChange(0, 0, getModificationDate());
+	flushCaches();
+}
+
+void HD::createTigerTree()
+{
+	// Cached hashes are looked up by name. With an overlay attached the
+	// content differs from the base image, so use the name of the
+	// overlay file instead.
+	const auto& ttName = overlay ? overlay->getFilename().getResolved()
+	                             : filename.getResolved();
+	tigerTree = std::make_unique<TigerTree>(*this, filesize, ttName);
+}
+
+time_t HD::getModificationDate()
+{
+	auto time = file.getModificationDate();
+	if (overlay) {
+		time = std::max(time, overlay->getModificationDate());
+	}
+	return time;
+}
+
 size_t HD::getNbSectorsImpl() const
 {
 	return filesize / sizeof(SectorBuffer);
@@ -100,26 +187,34 @@ size_t HD::getNbSectorsImpl() const
 
 void HD::readSectorImpl(size_t sector, SectorBuffer& buf)
 {
+	if (overlay && overlay->contains(sector)) {
+		overlay->readSector(sector, buf);
+		return;
+	}
 	file.seek(sector * sizeof(buf));
 	file.read(&buf, sizeof(buf));
 }
 
 void HD::writeSectorImpl(size_t sector, const SectorBuffer& buf)
 {
-	file.seek(sector * sizeof(buf));
-	file.write(&buf, sizeof(buf));
+	if (overlay) {
+		overlay->writeSector(sector, buf);
+	} else {
+		file.seek(sector * sizeof(buf));
+		file.write(&buf, sizeof(buf));
+	}
 	tigerTree->notifyChange(sector * sizeof(buf), sizeof(buf),
-	                        file.getModificationDate());
+	                        getModificationDate());
 }
 
 bool HD::isWriteProtectedImpl() const
 {
-	return file.isReadOnly();
+	return !overlay && file.isReadOnly();
 }
 
 Sha1Sum HD::getSha1SumImpl(FilePool& filePool)
 {
-	if (hasPatches()) {
+	if (hasPatches() || overlay) {
 		return SectorAccessibleDisk::getSha1SumImpl(filePool);
 	}
 	return filePool.getSha1Sum(file);
@@ -175,7 +270,7 @@ uint8_t* HD::getData(size_t offset, size_t size)
 
 bool HD::isCacheStillValid(time_t& cacheTime)
 {
-	time_t fileTime = file.getModificationDate();
+	time_t fileTime = getModificationDate();
 	bool result = fileTime == cacheTime;
 	cacheTime = fileTime;
 	return result;
@@ -208,6 +303,7 @@ int HD::insertDisk(std::string_view newFilename)
 
 // version 1: initial version
 // version 2: replaced 'checksum'(=sha1) with 'tthsum`
+// version 3: added 'overlay'
 template<typename Archive>
 void HD::serialize(Archive& ar, unsigned version)
 {
@@ -239,6 +335,15 @@ void HD::serialize(Archive& ar, unsigned version)
 		}
 	}
 
+	if (ar.versionAtLeast(version, 3)) {
+		Filename ovl = overlay ? overlay->getFilename() : Filename();
+		ar.serialize("overlay", ovl);
+		if (ar.isLoader() && !ovl.empty() && file.is_open()) {
+			ovl.updateAfterLoadState();
+			attachOverlay(ovl);
+		}
+	}
+
 	// store/check checksum
 	if (file.is_open()) {
 		bool mismatch = false;
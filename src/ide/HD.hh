@@ -15,6 +15,7 @@ namespace openmsx {
 
 class MSXMotherBoard;
 class HDCommand;
+class HDOverlay;
 class DeviceConfig;
 
 class HD : public SectorAccessibleDisk, public DiskContainer
@@ -28,6 +29,19 @@ public:
 	const Filename& getImageName() const { return filename; }
 	void switchImage(const Filename& filename);
 
+	/** Copy-on-write overlay support. While an overlay is attached, all
+	  * writes go to the overlay file and the base image is opened
+	  * read-only.
+	  */
+	const HDOverlay* getOverlay() const { return overlay.get(); }
+	void attachOverlay(const Filename& overlayName);
+	void detachOverlay();
+	/** Write all sectors in the overlay to the base image, and then
+	  * empty the overlay. */
+	void commitOverlay();
+	/** Throw away all sectors in the overlay. */
+	void discardOverlay();
+
 	std::string getTigerTreeHash();
 
 	template<typename Archive>
@@ -54,6 +68,8 @@ private:
 	bool isCacheStillValid(time_t& time) override;
 
 	void showProgress(size_t position, size_t maxPosition);
+	void createTigerTree();
+	time_t getModificationDate();
 
 	MSXMotherBoard& motherBoard;
 	std::string name;
@@ -64,6 +80,8 @@ private:
 	Filename filename;
 	size_t filesize;
 
+	std::unique_ptr<HDOverlay> overlay; // can be nullptr
+
 	static constexpr unsigned MAX_HD = 26;
 	using HDInUse = std::bitset<MAX_HD>;
 	std::shared_ptr<HDInUse> hdInUse;
@@ -73,7 +91,7 @@ private:
 };
 
 REGISTER_BASE_CLASS(HD, "HD");
-SERIALIZE_CLASS_VERSION(HD, 2);
+SERIALIZE_CLASS_VERSION(HD, 3);
 
 } // namespace openmsx
 
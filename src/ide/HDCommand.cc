@@ -1,9 +1,11 @@
 #include "HDCommand.hh"
 #include "HD.hh"
+#include "HDOverlay.hh"
 #include "FileContext.hh"
 #include "FileException.hh"
 #include "CommandException.hh"
 #include "BooleanSetting.hh"
+#include "MSXException.hh"
 #include "TclObject.hh"
 
 namespace openmsx {
@@ -35,6 +37,8 @@ void HDCommand::execute(span<const TclObject> tokens, TclObject& result,
 			TclObject options = makeTclList("readonly");
 			result.addListElement(options);
 		}
+	} else if (tokens[1] == "overlay") {
+		executeOverlay(tokens, result);
 	} else if ((tokens.size() == 2) ||
 	           ((tokens.size() == 3) && tokens[1] == "insert")) {
 		if (powerSetting.getBoolean()) {
@@ -67,22 +71,105 @@ void HDCommand::execute(span<const TclObject> tokens, TclObject& result,
 	}
 }
 
-string HDCommand::help(const vector<string>& /*tokens*/) const
+void HDCommand::executeOverlay(span<const TclObject> tokens, TclObject& result)
 {
+	if (tokens.size() == 2) {
+		if (auto* overlay = hd.getOverlay()) {
+			result.addListElement(overlay->getFilename().getResolved());
+			result.addListElement(int(overlay->getNumDirtySectors()));
+		}
+		return;
+	}
+	const auto& subCmd = tokens[2];
+	if (subCmd == "commit") {
+		// doesn't change the content of the disk, so also allowed
+		// while the MSX is running
+		checkNumArgs(tokens, 3, Prefix{3}, nullptr);
+		try {
+			hd.commitOverlay();
+		} catch (MSXException& e) {
+			throw CommandException("Can't commit overlay: ",
+			                       e.getMessage());
+		}
+		return;
+	}
+	if (powerSetting.getBoolean()) {
+		throw CommandException(
+			"Can only change the hard disk overlay when MSX is "
+			"powered down.");
+	}
+	if (subCmd == "attach") {
+		checkNumArgs(tokens, 4, "filename");
+		try {
+			hd.attachOverlay(Filename(string(tokens[3].getString()),
+			                          userFileContext()));
+		} catch (MSXException& e) {
+			throw CommandException("Can't attach overlay: ",
+			                       e.getMessage());
+		}
+	} else if (subCmd == "detach") {
+		checkNumArgs(tokens, 3, Prefix{3}, nullptr);
+		hd.detachOverlay();
+	} else if (subCmd == "discard") {
+		checkNumArgs(tokens, 3, Prefix{3}, nullptr);
+		try {
+			hd.discardOverlay();
+		} catch (MSXException& e) {
+			throw CommandException("Can't discard overlay: ",
+			                       e.getMessage());
+		}
+	} else {
+		throw CommandException(
+			"Invalid subcommand, expected one of "
+			"'attach', 'detach', 'commit', 'discard'.");
+	}
+}
+
+string HDCommand::help(const vector<string>& tokens) const
+{
+	if ((tokens.size() >= 2) && (tokens[1] == "overlay")) {
+		return strCat(
+			hd.getName(), " overlay                 : show the "
+			"attached overlay file and the number of sectors in it\n",
+			hd.getName(), " overlay attach <file>   : redirect all "
+			"writes to the given overlay file, the hard disk image "
+			"itself is no longer modified\n",
+			hd.getName(), " overlay detach          : stop using the "
+			"overlay (the overlay file is kept)\n",
+			hd.getName(), " overlay commit          : write the "
+			"content of the overlay to the hard disk image and empty "
+			"the overlay\n",
+			hd.getName(), " overlay discard         : throw away all "
+			"changes in the overlay\n");
+	}
 	return hd.getName() + ": change the hard disk image for this hard disk drive\n";
 }
 
 void HDCommand::tabCompletion(vector<string>& tokens) const
 {
+	if ((tokens.size() >= 2) && (tokens[1] == "overlay")) {
+		if (tokens.size() == 3) {
+			static constexpr const char* const subCmds[] = {
+				"attach", "detach", "commit", "discard",
+			};
+			completeString(tokens, subCmds);
+		} else if ((tokens.size() == 4) && (tokens[2] == "attach")) {
+			completeFileName(tokens, userFileContext());
+		}
+		return;
+	}
 	vector<const char*> extra;
 	if (tokens.size() < 3) {
-		extra = { "insert" };
+		extra = { "insert", "overlay" };
 	}
 	completeFileName(tokens, userFileContext(), extra);
 }
 
 bool HDCommand::needRecord(span<const TclObject> tokens) const
 {
+	if ((tokens.size() == 2) && (tokens[1] == "overlay")) {
+		return false; // only a query
+	}
 	return tokens.size() > 1;
 }
 
@@ -26,6 +26,8 @@ public:
 	void tabCompletion(std::vector<std::string>& tokens) const override;
 	bool needRecord(span<const TclObject> tokens) const override;
 private:
+	void executeOverlay(span<const TclObject> tokens, TclObject& result);
+
 	HD& hd;
 	const BooleanSetting& powerSetting;
 };
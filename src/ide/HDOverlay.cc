@@ -0,0 +1,100 @@
+#include "HDOverlay.hh"
+#include "MSXException.hh"
+#include "endian.hh"
+#include <cassert>
+#include <cstring>
+
+namespace openmsx {
+
+struct OverlayHeader {
+	char magic[16];
+	Endian::L64 numSectors;
+};
+static_assert(sizeof(OverlayHeader) <= HDOverlay::SECTOR_SIZE);
+
+constexpr char OVERLAY_MAGIC[16] = {
+	'o', 'p', 'e', 'n', 'M', 'S', 'X', ' ',
+	'H', 'D', ' ', 'o', 'v', 'l', ' ', '1',
+};
+
+HDOverlay::HDOverlay(Filename filename_, size_t numSectors_)
+	: file(filename_, File::CREATE)
+	, filename(std::move(filename_))
+	, numSectors(numSectors_)
+	, bitmap(((numSectors + 8 * SECTOR_SIZE - 1) / (8 * SECTOR_SIZE)) * SECTOR_SIZE)
+	, numDirty(0)
+{
+	if (file.isReadOnly()) {
+		throw MSXException("Overlay file is read-only: ",
+		                   filename.getResolved());
+	}
+	SectorBuffer buf;
+	if (file.getSize() == 0) {
+		// newly created
+		memset(&buf, 0, sizeof(buf));
+		auto& header = *reinterpret_cast<OverlayHeader*>(buf.raw);
+		memcpy(header.magic, OVERLAY_MAGIC, sizeof(OVERLAY_MAGIC));
+		header.numSectors = numSectors;
+		file.write(&buf, sizeof(buf));
+		file.write(bitmap.data(), bitmap.size());
+		return;
+	}
+
+	if (file.getSize() < getDataOffset()) {
+		throw MSXException("Invalid overlay file: ",
+		                   filename.getResolved());
+	}
+	file.read(&buf, sizeof(buf));
+	const auto& header = *reinterpret_cast<const OverlayHeader*>(buf.raw);
+	if (memcmp(header.magic, OVERLAY_MAGIC, sizeof(OVERLAY_MAGIC)) != 0) {
+		throw MSXException("Not an openMSX harddisk overlay file: ",
+		                   filename.getResolved());
+	}
+	if (header.numSectors != numSectors) {
+		throw MSXException(
+			"Overlay file ", filename.getResolved(), " was created "
+			"for a harddisk image of a different size.");
+	}
+	file.read(bitmap.data(), bitmap.size());
+	forEachSector([&](size_t sector) {
+		if (sector < numSectors) {
+			++numDirty;
+		} else {
+			throw MSXException("Corrupt overlay file: ",
+			                   filename.getResolved());
+		}
+	});
+}
+
+void HDOverlay::readSector(size_t sector, SectorBuffer& buf)
+{
+	assert(contains(sector));
+	file.seek(getDataOffset() + sector * SECTOR_SIZE);
+	file.read(&buf, sizeof(buf));
+}
+
+void HDOverlay::writeSector(size_t sector, const SectorBuffer& buf)
+{
+	assert(sector < numSectors);
+	file.seek(getDataOffset() + sector * SECTOR_SIZE);
+	file.write(&buf, sizeof(buf));
+	if (!contains(sector)) {
+		// Only mark the sector as present after the data is written.
+		auto& b = bitmap[sector / 8];
+		b |= 1 << (sector % 8);
+		file.seek(SECTOR_SIZE + sector / 8);
+		file.write(&b, 1);
+		++numDirty;
+	}
+}
+
+void HDOverlay::clear()
+{
+	memset(bitmap.data(), 0, bitmap.size());
+	file.seek(SECTOR_SIZE);
+	file.write(bitmap.data(), bitmap.size());
+	file.truncate(getDataOffset());
+	numDirty = 0;
+}
+
+} // namespace openmsx
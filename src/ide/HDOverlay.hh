@@ -0,0 +1,79 @@
+#ifndef HDOVERLAY_HH
+#define HDOVERLAY_HH
+
+#include "DiskImageUtils.hh"
+#include "File.hh"
+#include "Filename.hh"
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+namespace openmsx {
+
+/** Copy-on-write overlay for a harddisk image.
+ *
+ * All writes go to a separate (sidecar) file, the base image itself is
+ * never modified. This allows to share a single (read-only) base image
+ * between many openMSX instances, and to cheaply throw away all changes.
+ *
+ * The overlay file consists of:
+ *  - A header (one sector): a magic string and the number of sectors in
+ *    the base image.
+ *  - A bitmap with one bit per sector, a set bit indicates the sector is
+ *    stored in the overlay. Padded to a multiple of the sector size.
+ *  - The data area: sector 'n' is stored at a fixed offset 'n' sectors
+ *    from the start of this area. Sectors that were never written are
+ *    never touched, so on most host filesystems the file stays sparse.
+ */
+class HDOverlay
+{
+public:
+	static constexpr size_t SECTOR_SIZE = sizeof(SectorBuffer);
+
+	/** Open an existing overlay file or create a new (empty) one.
+	  * @throws MSXException when the file can't be opened or when it
+	  *         was created for a base image with a different size.
+	  */
+	HDOverlay(Filename filename, size_t numSectors);
+
+	const Filename& getFilename() const { return filename; }
+
+	/** Is the given sector stored in the overlay? */
+	bool contains(size_t sector) const {
+		return (bitmap[sector / 8] >> (sector % 8)) & 1;
+	}
+	size_t getNumDirtySectors() const { return numDirty; }
+
+	void readSector (size_t sector,       SectorBuffer& buf);
+	void writeSector(size_t sector, const SectorBuffer& buf);
+
+	/** Call the given function for every sector in the overlay. */
+	template<typename FUNC> void forEachSector(FUNC func) const {
+		for (size_t i = 0; i < bitmap.size(); ++i) {
+			if (!bitmap[i]) continue;
+			for (unsigned j = 0; j < 8; ++j) {
+				if (bitmap[i] & (1 << j)) func(8 * i + j);
+			}
+		}
+	}
+
+	/** Forget all sectors in the overlay (and free the disk space). */
+	void clear();
+
+	time_t getModificationDate() { return file.getModificationDate(); }
+
+private:
+	size_t getDataOffset() const {
+		return SECTOR_SIZE + bitmap.size();
+	}
+
+	File file;
+	const Filename filename;
+	const size_t numSectors;
+	std::vector<uint8_t> bitmap; // padded to a multiple of SECTOR_SIZE
+	size_t numDirty;
+};
+
+} // namespace openmsx
+
+#endif
@@ -1,13 +1,17 @@
 #include "OggReader.hh"
 #include "MSXException.hh"
+#include "RawFrame.hh"
 #include "yuv2rgb.hh"
 #include "likely.hh"
 #include "CliComm.hh"
 #include "MemoryOps.hh"
 #include "ranges.hh"
 #include "stl.hh"
+#include "strCat.hh"
 #include "stringsp.hh" // for strncasecmp
 #include "view.hh"
+#include "xrange.hh"
+#include <algorithm>
 #include <cstring> // for memcpy, memcmp
 #include <cstdlib> // for atoi
 #include <cctype> // for isspace
@@ -42,10 +46,19 @@ Frame::~Frame()
 	MemoryOps::freeAligned(buffer[2].data);
 }
 
+static bool sameFormat(const PixelFormat& a, const PixelFormat& b)
+{
+	return (a.getBytesPerPixel() == b.getBytesPerPixel()) &&
+	       (a.getRmask() == b.getRmask()) &&
+	       (a.getGmask() == b.getGmask()) &&
+	       (a.getBmask() == b.getBmask());
+}
+
 
 OggReader::OggReader(const Filename& filename, CliComm& cli_)
 	: cli(cli_)
 	, file(filename)
+	, indexFile(filename)
 {
 	audioSerial = -1;
 	videoSerial = -1;
@@ -68,6 +81,7 @@ OggReader::OggReader(const Filename& filename, CliComm& cli_)
 	vorbis_comment_init(&vc);
 
 	ogg_sync_init(&sync);
+	ogg_sync_init(&indexSync);
 
 	state = PLAYING;
 	fileOffset = 0;
@@ -201,6 +215,8 @@ OggReader::OggReader(const Filename& filename, CliComm& cli_)
 	th_setup_free(tsi);
 	th_info_clear(&ti);
 	th_comment_clear(&tc);
+
+	thread = std::thread([this]() { run(); });
 }
 
 void OggReader::cleanup()
@@ -223,17 +239,102 @@ void OggReader::cleanup()
 	}
 
 	ogg_sync_clear(&sync);
+	ogg_sync_clear(&indexSync);
 }
 
 OggReader::~OggReader()
 {
+	{
+		std::lock_guard lock(mutex);
+		stop = true;
+	}
+	cond.notify_all();
+	thread.join();
 	cleanup();
 }
 
+template<typename... Args>
+void OggReader::warn(Args&&... args)
+{
+	// CliComm may only be used from the main thread
+	std::lock_guard lock(mutex);
+	warnings.push_back(strCat(std::forward<Args>(args)...));
+}
+
+void OggReader::flushWarnings()
+{
+	for (const auto& w : warnings) {
+		cli.printWarning(w);
+	}
+	warnings.clear();
+}
+
+void OggReader::run()
+{
+	std::unique_lock lock(mutex);
+	while (!stop) {
+		if (seekPending) {
+			auto frame = seekFrame;
+			auto sample = seekSample;
+			lock.unlock();
+			try {
+				doSeek(frame, sample);
+			} catch (MSXException& e) {
+				warn("Error while seeking in ogg file: ", e.getMessage());
+			}
+			lock.lock();
+			seekPending = false;
+			endOfStream = false;
+			cond.notify_all();
+		} else if (!endOfStream &&
+		           (wantMore || ((frameList.size() < MAX_FRAMES) &&
+		                         (audioList.size() < MAX_AUDIO)))) {
+			lock.unlock();
+			bool more = false;
+			try {
+				more = nextPacket();
+			} catch (MSXException& e) {
+				warn("Error while reading ogg file: ", e.getMessage());
+			}
+			lock.lock();
+			++packetCount;
+			if (!more) endOfStream = true;
+			if (wantMore || endOfStream) cond.notify_all();
+		} else if (!indexDone) {
+			lock.unlock();
+			try {
+				indexStep();
+			} catch (MSXException&) {
+				// Bisection is used for seeking instead. The
+				// index is incomplete, so it can't be extended
+				// later on (see doSeek()).
+				videoIndex.clear();
+				audioIndex.clear();
+				indexDone = true;
+				indexFailed = true;
+			}
+			lock.lock();
+		} else {
+			cond.wait(lock);
+		}
+	}
+}
+
+bool OggReader::waitForDecoder(std::unique_lock<std::mutex>& lock)
+{
+	auto count = packetCount;
+	wantMore = true;
+	cond.notify_all();
+	cond.wait(lock, [&] { return endOfStream || (packetCount != count); });
+	wantMore = false;
+	return packetCount != count;
+}
+
 /** Vorbis only records the ogg position (in no. of samples) once per ogg
  * page. After seeking we have already decoded some audio before we encounter
  * the exact position we are at. Fixup the positions and discard any unwanted
- * audio. This function expects vorbisPos to be set correctly.
+ * audio. This function expects vorbisPos to be set correctly and 'mutex' to
+ * be locked.
  */
 void OggReader::vorbisFoundPosition()
 {
@@ -245,7 +346,7 @@ void OggReader::vorbisFoundPosition()
 
 	// last is now the first vorbis audio decoded
 	if (last > currentSample) {
-		cli.printWarning("missing part of audio stream");
+		warnings.emplace_back("missing part of audio stream");
 	}
 
 	if (vorbisPos > currentSample) {
@@ -361,16 +462,14 @@ void OggReader::readVorbis(ogg_packet* packet)
 
 	while (pos < decoded)  {
 		// Find memory to copy PCM into
-		if (recycleAudioList.empty()) {
-			auto audio = std::make_unique<AudioFragment>();
-			audio->length = 0;
-			recycleAudioList.push_back(std::move(audio));
+		if (!partialAudio) {
+			partialAudio = getFreeAudio();
 		}
-		auto& audio = recycleAudioList.front();
+		auto& audio = partialAudio;
 		if (audio->length == 0) {
 			audio->position = vorbisPos;
 		} else {
-			// first element was already partially filled
+			// fragment was already partially filled
 		}
 
 		// Copy PCM
@@ -396,7 +495,13 @@ void OggReader::readVorbis(ogg_packet* packet)
 		}
 
 		if (audio->length == AudioFragment::MAX_SAMPLES || last) {
-			audioList.push_back(recycleAudioList.pop_front());
+			std::lock_guard lock(mutex);
+			if (seekPending) {
+				// will be discarded anyway
+				recycleAudio(std::move(partialAudio));
+			} else {
+				audioList.push_back(std::move(partialAudio));
+			}
 		}
 	}
 
@@ -405,10 +510,13 @@ void OggReader::readVorbis(ogg_packet* packet)
 	if (packet->granulepos != -1) {
 		if (vorbisPos == AudioFragment::UNKNOWN_POS) {
 			vorbisPos = packet->granulepos;
-			vorbisFoundPosition();
+			std::lock_guard lock(mutex);
+			if (!seekPending) {
+				vorbisFoundPosition();
+			}
 		} else {
 			if (vorbisPos != size_t(packet->granulepos)) {
-				cli.printWarning(
+				warn(
 					"vorbis audio out of sync, expected ",
 					vorbisPos, ", got ", packet->granulepos);
 				vorbisPos = packet->granulepos;
@@ -517,37 +625,44 @@ void OggReader::readTheora(ogg_packet* packet)
 		return;
 	}
 
-	if (packet->bytes == 0 && frameList.empty()) {
-		// No use passing empty packets (which represent dup frame)
-		// before we've read any frame.
-		return;
+	if (packet->bytes == 0) {
+		std::lock_guard lock(mutex);
+		if (frameList.empty()) {
+			// No use passing empty packets (which represent dup
+			// frame) before we've read any frame.
+			return;
+		}
 	}
 
 	keyFrame = size_t(-1);
 
 	int rc = th_decode_packetin(theora, packet, nullptr);
 	switch (rc) {
-	case TH_DUPFRAME:
-		if (frameList.empty()) {
-			cli.printWarning("Theora error: dup frame encountered "
-					 "without preceding frame");
+	case TH_DUPFRAME: {
+		std::lock_guard lock(mutex);
+		if (seekPending) {
+			// frameList is about to be emptied
+		} else if (frameList.empty()) {
+			warnings.emplace_back("Theora error: dup frame encountered "
+			                      "without preceding frame");
 		} else {
 			frameList.back()->length++;
 		}
 		break;
+	}
 	case TH_EIMPL:
-		cli.printWarning("Theora error: not capable of reading this");
+		warn("Theora error: not capable of reading this");
 		break;
 	case TH_EFAULT:
-		cli.printWarning("Theora error: API not used correctly");
+		warn("Theora error: API not used correctly");
 		break;
 	case TH_EBADPACKET:
-		cli.printWarning("Theora error: bad packet");
+		warn("Theora error: bad packet");
 		break;
 	case 0:
 		break;
 	default:
-		cli.printWarning("Theora error: unknown error ", rc);
+		warn("Theora error: unknown error ", rc);
 		break;
 	}
 
@@ -567,13 +682,7 @@ void OggReader::readTheora(ogg_packet* packet)
 
 	currentFrame = frameno + 1;
 
-	std::unique_ptr<Frame> frame;
-	if (recycleFrameList.empty()) {
-		frame = std::make_unique<Frame>(yuv);
-	} else {
-		frame = std::move(recycleFrameList.back());
-		recycleFrameList.pop_back();
-	}
+	auto frame = getFreeFrame(yuv);
 
 	int y_size  = yuv[0].height * yuv[0].stride;
 	int uv_size = yuv[1].height * yuv[1].stride;
@@ -581,6 +690,21 @@ void OggReader::readTheora(ogg_packet* packet)
 	memcpy(frame->buffer[1].data, yuv[1].data, uv_size);
 	memcpy(frame->buffer[2].data, yuv[2].data, uv_size);
 
+	// Also do the color space conversion in this thread, getFrameNo()
+	// then only has to copy the pixels.
+	if (frame->rgb) {
+		yuv2rgb::convert(frame->buffer, *frame->rgb);
+		frame->hasRgb = true;
+	} else {
+		frame->hasRgb = false;
+	}
+
+	std::lock_guard lock(mutex);
+	if (seekPending) {
+		recycleFrameList.push_back(std::move(frame));
+		return;
+	}
+
 	// At lot of frames have framenumber -1, only some have the correct
 	// frame number. We continue counting from the previous known
 	// postion
@@ -588,7 +712,7 @@ void OggReader::readTheora(ogg_packet* packet)
 	if (last && (last->no != size_t(-1))) {
 		if ((frameno != size_t(-1)) &&
 		    (frameno != last->no + last->length)) {
-			cli.printWarning("Theora frame sequence wrong");
+			warnings.emplace_back("Theora frame sequence wrong");
 		} else {
 			frameno = last->no + last->length;
 		}
@@ -611,15 +735,49 @@ void OggReader::readTheora(ogg_packet* packet)
 	frameList.push_back(std::move(frame));
 }
 
+std::unique_ptr<Frame> OggReader::getFreeFrame(const th_ycbcr_buffer& yuv)
+{
+	std::unique_ptr<Frame> frame;
+	PixelFormat format;
+	bool convert;
+	{
+		std::lock_guard lock(mutex);
+		if (!recycleFrameList.empty()) {
+			frame = std::move(recycleFrameList.back());
+			recycleFrameList.pop_back();
+		}
+		format = outputFormat;
+		convert = hasOutputFormat;
+	}
+	if (!frame) {
+		frame = std::make_unique<Frame>(yuv);
+	}
+	if (convert && (!frame->rgb ||
+	                !sameFormat(frame->rgb->getPixelFormat(), format))) {
+		frame->rgb = std::make_unique<RawFrame>(format, 640, 480);
+	}
+	return frame;
+}
+
 void OggReader::getFrameNo(RawFrame& rawFrame, size_t frameno)
 {
+	std::unique_lock lock(mutex);
+	flushWarnings();
+	if (!hasOutputFormat ||
+	    !sameFormat(outputFormat, rawFrame.getPixelFormat())) {
+		// From now on the decoder thread also converts to RGB, in the
+		// current format (the renderer or pixel format may change).
+		outputFormat = rawFrame.getPixelFormat();
+		hasOutputFormat = true;
+	}
+
 	Frame* frame;
 	while (true) {
 		// If there are no frames or the frames we have read
 		// does not include a proper frame number, just read
 		// more data
 		if (frameList.empty() || (frameList[0]->no == size_t(-1))) {
-			if (!nextPacket()) {
+			if (!waitForDecoder(lock)) {
 				return;
 			}
 			continue;
@@ -664,12 +822,46 @@ void OggReader::getFrameNo(RawFrame& rawFrame, size_t frameno)
 		}
 
 		// ..add read some new ones
-		if (!nextPacket()) {
+		if (!waitForDecoder(lock)) {
 			return;
 		}
 	}
 
-	yuv2rgb::convert(frame->buffer, rawFrame);
+	// Frames may have been removed, so the decoder can continue. The
+	// selected frame stays in frameList (only this thread removes frames)
+	// and its pixels are no longer modified, so copy them without lock.
+	cond.notify_all();
+	bool useRgb = frame->hasRgb &&
+	              (frame->rgb->getHeight() == rawFrame.getHeight()) &&
+	              sameFormat(frame->rgb->getPixelFormat(),
+	                         rawFrame.getPixelFormat());
+	lock.unlock();
+
+	if (useRgb) {
+		auto& rgb = *frame->rgb;
+		unsigned bytes = rgb.getPixelFormat().getBytesPerPixel();
+		for (auto y : xrange(rgb.getHeight())) {
+			unsigned width = rgb.getLineWidthDirect(y);
+			memcpy(rawFrame.getLinePtrDirect<char>(y),
+			       rgb.getLinePtrDirect<char>(y), width * bytes);
+			rawFrame.setLineWidth(y, width);
+		}
+	} else {
+		yuv2rgb::convert(frame->buffer, rawFrame);
+	}
+}
+
+std::unique_ptr<AudioFragment> OggReader::getFreeAudio()
+{
+	{
+		std::lock_guard lock(mutex);
+		if (!recycleAudioList.empty()) {
+			return recycleAudioList.pop_front();
+		}
+	}
+	auto audio = std::make_unique<AudioFragment>();
+	audio->length = 0;
+	return audio;
 }
 
 void OggReader::recycleAudio(std::unique_ptr<AudioFragment> audio)
@@ -680,10 +872,13 @@ void OggReader::recycleAudio(std::unique_ptr<AudioFragment> audio)
 
 const AudioFragment* OggReader::getAudio(size_t sample)
 {
+	std::unique_lock lock(mutex);
+	flushWarnings();
+
 	// Read while position is unknown
 	while (audioList.empty() ||
 	       audioList.front()->position == AudioFragment::UNKNOWN_POS) {
-		if (!nextPacket()) {
+		if (!waitForDecoder(lock)) {
 			return nullptr;
 		}
 	}
@@ -695,6 +890,7 @@ const AudioFragment* OggReader::getAudio(size_t sample)
 			// Dispose if this, more than 1 second old
 			recycleAudio(std::move(*it));
 			it = audioList.erase(it);
+			cond.notify_all();
 		} else if (audio->position + audio->length <= sample) {
 			++it;
 		} else {
@@ -710,7 +906,7 @@ const AudioFragment* OggReader::getAudio(size_t sample)
 		if (it == end(audioList)) {
 			size_t size = audioList.size();
 			while (size == audioList.size()) {
-				if (!nextPacket()) {
+				if (!waitForDecoder(lock)) {
 					return nullptr;
 				}
 			}
@@ -752,15 +948,15 @@ bool OggReader::nextPacket()
 		int serial = ogg_page_serialno(&page);
 		if (serial == audioSerial) {
 			if (ogg_stream_pagein(&vorbisStream, &page)) {
-				cli.printWarning("Failed to submit vorbis page");
+				warn("Failed to submit vorbis page");
 			}
 		} else if (serial == videoSerial) {
 			if (ogg_stream_pagein(&theoraStream, &page)) {
-				cli.printWarning("Failed to submit theora page");
+				warn("Failed to submit theora page");
 			}
 		} else if (serial != skeletonSerial) {
-			cli.printWarning("Unexpected stream with serial ",
-			                 serial, " in ogg file");
+			warn("Unexpected stream with serial ",
+			     serial, " in ogg file");
 		}
 	}
 }
@@ -790,7 +986,7 @@ bool OggReader::nextPage(ogg_page* page)
 		fileOffset += chunk;
 
 		if (ogg_sync_wrote(&sync, long(chunk)) == -1) {
-			cli.printWarning("Internal error: ogg_sync_wrote failed");
+			warn("Internal error: ogg_sync_wrote failed");
 		}
 	}
 
@@ -933,34 +1129,155 @@ size_t OggReader::findOffset(size_t frame, size_t sample)
 	return bisection(keyFrame, sample, maxOffset, maxSamples, maxFrames);
 }
 
-bool OggReader::seek(size_t frame, size_t samples)
+void OggReader::indexStep()
 {
-	// Remove all queued frames
-	recycleFrameList.insert(end(recycleFrameList),
-		std::move_iterator(begin(frameList)),
-		std::move_iterator(end  (frameList)));
-	frameList.clear();
+	constexpr size_t CHUNK = 64 * 1024;
 
-	// Remove all queued audio
-	if (!recycleAudioList.empty()) {
-		recycleAudioList.front()->length = 0;
+	// first index the pages that are already in the sync buffer
+	ogg_page page;
+	while (true) {
+		long ret = ogg_sync_pageseek(&indexSync, &page);
+		if (ret == 0) break; // need more data
+		if (ret < 0) {
+			// skipped bytes, not a page
+			indexPageOffset += -ret;
+			continue;
+		}
+
+		auto granule = ogg_page_granulepos(&page);
+		if (granule != -1) {
+			int serial = ogg_page_serialno(&page);
+			if (serial == videoSerial) {
+				size_t intra = granule & ((size_t(1) << granuleShift) - 1);
+				size_t key = granule >> granuleShift;
+				videoIndex.push_back({indexPageOffset, key + intra, key});
+			} else if (serial == audioSerial) {
+				audioIndex.push_back({indexPageOffset, size_t(granule)});
+			}
+		}
+		indexPageOffset += ret;
 	}
-	for (auto& a : audioList) {
-		recycleAudio(std::move(a));
+
+	indexFileSize = indexFile.getSize();
+	if (indexReadOffset >= indexFileSize) {
+		indexDone = true;
+		return;
+	}
+	auto chunk = std::min(CHUNK, indexFileSize - indexReadOffset);
+	char* buffer = ogg_sync_buffer(&indexSync, long(chunk));
+	indexFile.read(buffer, chunk);
+	ogg_sync_wrote(&indexSync, long(chunk));
+	indexReadOffset += chunk;
+}
+
+size_t OggReader::findOffsetIndexed(size_t frame, size_t sample)
+{
+	// Same result as findOffset(), but without reading from the file.
+	totalFrames = videoIndex.back().frame;
+
+	// If we're close to beginning, don't bother searching for it,
+	// just start at the beginning (arbitrary boundary of 1 second).
+	if (sample < getSampleRate() || frame <= 30) {
+		keyFrame = 1;
+		return 0;
 	}
-	audioList.clear();
 
-	fileOffset = findOffset(frame, samples);
+	auto maxSamples = audioIndex.back().sample;
+	if ((sample > maxSamples) || (frame > totalFrames)) {
+		sample = maxSamples;
+		frame = totalFrames;
+	}
+
+	// The granule position of a page is the one of the last packet that
+	// ends on that page. So the last page that ends before the requested
+	// frame gives a key frame that is at or before the one of that frame,
+	// and that key frame starts after the page that precedes it.
+	auto byFrame = [](const VideoPage& p, size_t f) { return p.frame < f; };
+	auto v = std::lower_bound(begin(videoIndex), end(videoIndex), frame, byFrame);
+	keyFrame = (v == begin(videoIndex)) ? 1 : std::prev(v)->keyFrame;
+	v = std::lower_bound(begin(videoIndex), end(videoIndex), keyFrame, byFrame);
+	size_t videoOffset = (v == begin(videoIndex)) ? 0 : std::prev(v)->offset;
+
+	auto bySample = [](const AudioPage& p, size_t s) { return p.sample < s; };
+	auto a = std::lower_bound(begin(audioIndex), end(audioIndex), sample, bySample);
+	size_t audioOffset = (a == begin(audioIndex)) ? 0 : std::prev(a)->offset;
+
+	return std::min(videoOffset, audioOffset);
+}
+
+void OggReader::restartIndex()
+{
+	videoIndex.clear();
+	audioIndex.clear();
+	ogg_sync_reset(&indexSync);
+	indexFile.seek(0);
+	indexReadOffset = 0;
+	indexPageOffset = 0;
+	indexDone = false;
+	indexFailed = false;
+}
+
+void OggReader::doSeek(size_t frame, size_t sample)
+{
+	if (indexDone) {
+		auto size = file.getSize();
+		if (indexFailed) {
+			// Indexing stopped half-way, only try again (from
+			// the start) when the file has changed since then.
+			if (size != indexFileSize) restartIndex();
+		} else if (size != indexReadOffset) {
+			// The file has grown, index the new part in the
+			// background. Till then use bisection.
+			indexDone = false;
+		}
+	}
+	if (indexDone && !videoIndex.empty() && !audioIndex.empty()) {
+		fileSize = file.getSize();
+		fileOffset = findOffsetIndexed(frame, sample);
+	} else {
+		fileOffset = findOffset(frame, sample);
+	}
 	file.seek(fileOffset);
 
 	ogg_sync_reset(&sync);
 
 	vorbisPos = AudioFragment::UNKNOWN_POS;
 	currentFrame = frame;
-	currentSample = samples;
+	currentSample = sample;
 
 	vorbis_synthesis_restart(&vd);
+	if (partialAudio) {
+		partialAudio->length = 0;
+	}
+}
 
+void OggReader::recycleQueues()
+{
+	// Remove all queued frames
+	recycleFrameList.insert(end(recycleFrameList),
+		std::move_iterator(begin(frameList)),
+		std::move_iterator(end  (frameList)));
+	frameList.clear();
+
+	// Remove all queued audio
+	for (auto& a : audioList) {
+		recycleAudio(std::move(a));
+	}
+	audioList.clear();
+}
+
+bool OggReader::seek(size_t frame, size_t samples)
+{
+	// The actual seek is done by the decoder thread (it owns the decoder
+	// state), wait for it so that e.g. getFrames() is up-to-date.
+	std::unique_lock lock(mutex);
+	recycleQueues();
+	seekFrame = frame;
+	seekSample = samples;
+	seekPending = true;
+	cond.notify_all();
+	cond.wait(lock, [&] { return !seekPending; });
+	flushWarnings();
 	return true;
 }
 
@@ -2,12 +2,17 @@
 #define OGGREADER_HH
 
 #include "File.hh"
+#include "PixelFormat.hh"
 #include "circular_buffer.hh"
 #include <ogg/ogg.h>
 #include <vorbis/codec.h>
 #include <theora/theoradec.h>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <list>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -32,10 +37,24 @@ struct Frame
 	~Frame();
 
 	th_ycbcr_buffer buffer;
+	// the same image converted to RGB (see OggReader::outputFormat),
+	// only valid when 'hasRgb' is set
+	std::unique_ptr<RawFrame> rgb;
 	size_t no;
 	int length;
+	bool hasRgb = false;
 };
 
+/** Decoding of the ogg file (theora video, vorbis audio and conversion to RGB)
+ * is done in a separate thread, which decodes ahead of the position that is
+ * requested by the LaserdiscPlayer (bounded by MAX_FRAMES/MAX_AUDIO). The
+ * public methods are called from the main thread, they only wait for the
+ * decoder when the requested data isn't available yet.
+ *
+ * To seek, an index of the ogg pages (file offset plus frame number or
+ * sample number) is built in the background. Until that index is complete,
+ * seeking is done by bisection of the file.
+ */
 class OggReader
 {
 public:
@@ -57,6 +76,28 @@ public:
 	size_t getChapter(int chapterNo) const;
 
 private:
+	// Queue limits for decoding ahead. The decoder continues past these
+	// when the main thread is waiting for data that is not in the queue.
+	static constexpr size_t MAX_FRAMES = 16;
+	static constexpr size_t MAX_AUDIO = 64; // fragments (~3s at 44.1kHz)
+
+	struct VideoPage { size_t offset; size_t frame; size_t keyFrame; };
+	struct AudioPage { size_t offset; size_t sample; };
+
+	// main thread, with 'mutex' locked
+	bool waitForDecoder(std::unique_lock<std::mutex>& lock);
+	void flushWarnings();
+
+	// decoder thread
+	void run();
+	void doSeek(size_t frame, size_t sample);
+	template<typename... Args> void warn(Args&&... args);
+	void indexStep();
+	void restartIndex();
+	size_t findOffsetIndexed(size_t frame, size_t sample);
+	std::unique_ptr<Frame> getFreeFrame(const th_ycbcr_buffer& yuv);
+	std::unique_ptr<AudioFragment> getFreeAudio();
+
 	void cleanup();
 	void readTheora(ogg_packet* packet);
 	void theoraHeaderPage(ogg_page* page, th_info& ti, th_comment& tc,
@@ -67,6 +108,7 @@ private:
 	bool nextPage(ogg_page* page);
 	bool nextPacket();
 	void recycleAudio(std::unique_ptr<AudioFragment> audio);
+	void recycleQueues();
 	void vorbisFoundPosition();
 	size_t frameNo(ogg_packet* packet);
 
@@ -76,6 +118,7 @@ private:
 
 	CliComm& cli;
 	File file;
+	File indexFile; // separate file position for building the index
 
 	enum State {
 		PLAYING,
@@ -86,6 +129,7 @@ private:
 
 	// ogg state
 	ogg_sync_state sync;
+	ogg_sync_state indexSync;
 	ogg_stream_state vorbisStream, theoraStream;
 	int audioSerial;
 	int videoSerial;
@@ -101,9 +145,6 @@ private:
 	int granuleShift;
 	size_t totalFrames;
 
-	cb_queue<std::unique_ptr<Frame>> frameList;
-	std::vector<std::unique_ptr<Frame>> recycleFrameList;
-
 	// audio
 	int audioHeaders;
 	vorbis_info vi;
@@ -112,10 +153,44 @@ private:
 	vorbis_block vb;
 	size_t currentSample;
 	size_t vorbisPos;
+	std::unique_ptr<AudioFragment> partialAudio; // not yet in audioList
+
+	// Page index
+	std::vector<VideoPage> videoIndex;
+	std::vector<AudioPage> audioIndex;
+	size_t indexReadOffset = 0; // bytes passed to 'indexSync'
+	size_t indexPageOffset = 0; // offset of the next page
+	size_t indexFileSize = 0;   // file size seen by the last indexStep()
+	bool indexDone = false;
+	bool indexFailed = false;   // index was abandoned after an error
+
+	// The members above are only used by the decoder thread (or by the
+	// main thread before that thread is started). The ones below are
+	// shared, they're protected by 'mutex'.
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::thread thread;
 
+	cb_queue<std::unique_ptr<Frame>> frameList;
+	std::vector<std::unique_ptr<Frame>> recycleFrameList;
 	std::list<std::unique_ptr<AudioFragment>> audioList;
 	cb_queue<std::unique_ptr<AudioFragment>> recycleAudioList;
 
+	// Format of the RGB frames made by the decoder thread, copied from
+	// the RawFrame that is passed to getFrameNo() (updated when that
+	// format changes).
+	PixelFormat outputFormat;
+	bool hasOutputFormat = false;
+
+	std::vector<std::string> warnings; // printed by the main thread
+	size_t seekFrame = 0;
+	size_t seekSample = 0;
+	size_t packetCount = 0;   // number of packets decoded so far
+	bool seekPending = false;
+	bool wantMore = false;    // main thread is waiting for more data
+	bool endOfStream = false; // decoder reached the end of the file
+	bool stop = false;
+
 	// Metadata
 	std::vector<size_t> stopFrames;
 	std::vector<std::pair<int, size_t>> chapters;
@@ -37,187 +37,150 @@ namespace openmsx::yuv2rgb {
  * G = 1.164 * Y - 0.813 * V - 0.391 * U + 135.576
  * B = 1.164 * Y             + 2.018 * U - 276.836
  */
-static inline void yuv2rgb_sse2(
-	const uint8_t* u_ , const uint8_t* v_,
-	const uint8_t* y0_, const uint8_t* y1_,
-	uint32_t* out0_, uint32_t* out1_)
+// Contribution of 8 U and V samples (zero-extended to 16 bit) to the R, G
+// and B components. Each of these is shared by 2x2 output pixels.
+struct ChromaSSE2 { __m128i r, g, b; };
+
+static inline ChromaSSE2 chromaSSE2(__m128i u, __m128i v)
 {
-	// This routine calculates 32x2 RGBA pixels. Each output pixel uses a
-	// unique corresponding input Y value, but a group of 2x2 ouput pixels
-	// shares the same U and V input value.
-	auto* u    = reinterpret_cast<const __m128i*>(u_);
-	auto* v    = reinterpret_cast<const __m128i*>(v_);
-	auto* y0   = reinterpret_cast<const __m128i*>(y0_);
-	auto* y1   = reinterpret_cast<const __m128i*>(y1_);
-	auto* out0 = reinterpret_cast<      __m128i*>(out0_);
-	auto* out1 = reinterpret_cast<      __m128i*>(out1_);
-
-	// constants
-	const __m128i ZERO    = _mm_setzero_si128();
-	const __m128i ALPHA   = _mm_set1_epi16(    -1); // 0xFFFF
 	const __m128i RED_V   = _mm_set1_epi16(   102); // 102/64 =  1.59
 	const __m128i GREEN_U = _mm_set1_epi16(   -25); // -25/64 = -0.39
 	const __m128i GREEN_V = _mm_set1_epi16(   -52); // -52/64 = -0.81
 	const __m128i BLUE_U  = _mm_set1_epi16(   129); // 129/64 =  2.02
-	const __m128i COEF_Y  = _mm_set1_epi16(    74); //  74/64 =  1.16
 	const __m128i CNST_R  = _mm_set1_epi16(  -223); // -222.921
 	const __m128i CNST_G  = _mm_set1_epi16(   136); //  135.576
 	const __m128i CNST_B  = _mm_set1_epi16(  -277); // -276.836
+
+	__m128i mr = _mm_srai_epi16(_mm_mullo_epi16(v, RED_V), 6);
+	__m128i sg = _mm_mullo_epi16(v, GREEN_V);
+	__m128i tg = _mm_mullo_epi16(u, GREEN_U);
+	__m128i mg = _mm_srai_epi16(_mm_adds_epi16(sg, tg), 6);
+	__m128i mb = _mm_srli_epi16(_mm_mullo_epi16(u, BLUE_U), 6); // logical shift
+	return {_mm_adds_epi16(mr, CNST_R),
+	        _mm_adds_epi16(mg, CNST_G),
+	        _mm_adds_epi16(mb, CNST_B)};
+}
+
+// Combines 16 Y samples with the matching chroma values. The result are 16
+// R, G and B components of 8 bit, in pixel order.
+static inline void lumaSSE2(__m128i y, const ChromaSSE2& c,
+                            __m128i& r, __m128i& g, __m128i& b)
+{
+	const __m128i COEF_Y  = _mm_set1_epi16(    74); //  74/64 =  1.16
 	const __m128i Y_MASK  = _mm_set1_epi16(0x00FF);
 
-	// left
-	__m128i u0f  = _mm_load_si128(u);
-	__m128i v0f  = _mm_load_si128(v);
-	__m128i u07  = _mm_unpacklo_epi8(u0f, ZERO);
-	__m128i v07  = _mm_unpacklo_epi8(v0f, ZERO);
-	__m128i mr07 = _mm_srai_epi16(_mm_mullo_epi16(v07, RED_V), 6);
-	__m128i sg07 = _mm_mullo_epi16(v07, GREEN_V);
-	__m128i tg07 = _mm_mullo_epi16(u07, GREEN_U);
-	__m128i mg07 = _mm_srai_epi16(_mm_adds_epi16(sg07, tg07), 6);
-	__m128i mb07 = _mm_srli_epi16(_mm_mullo_epi16(u07, BLUE_U), 6); // logical shift
-	__m128i dr07 = _mm_adds_epi16(mr07, CNST_R);
-	__m128i dg07 = _mm_adds_epi16(mg07, CNST_G);
-	__m128i db07 = _mm_adds_epi16(mb07, CNST_B);
-
-	// block top,left
-	__m128i y00_0f    = _mm_load_si128(y0 + 0);
-	__m128i y00_even  = _mm_and_si128(y00_0f, Y_MASK);
-	__m128i y00_odd   = _mm_srli_epi16(y00_0f, 8);
-	__m128i dy00_even = _mm_srai_epi16(_mm_mullo_epi16(y00_even, COEF_Y), 6);
-	__m128i dy00_odd  = _mm_srai_epi16(_mm_mullo_epi16(y00_odd,  COEF_Y), 6);
-	__m128i r00_even  = _mm_adds_epi16(dr07, dy00_even);
-	__m128i g00_even  = _mm_adds_epi16(dg07, dy00_even);
-	__m128i b00_even  = _mm_adds_epi16(db07, dy00_even);
-	__m128i r00_odd   = _mm_adds_epi16(dr07, dy00_odd);
-	__m128i g00_odd   = _mm_adds_epi16(dg07, dy00_odd);
-	__m128i b00_odd   = _mm_adds_epi16(db07, dy00_odd);
-	__m128i r00_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(r00_even, r00_even),
-	                                      _mm_packus_epi16(r00_odd,  r00_odd));
-	__m128i g00_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(g00_even, g00_even),
-	                                      _mm_packus_epi16(g00_odd,  g00_odd));
-	__m128i b00_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(b00_even, b00_even),
-	                                      _mm_packus_epi16(b00_odd,  b00_odd));
-	__m128i br00_07   = _mm_unpacklo_epi8(b00_0f, r00_0f);
-	__m128i br00_8f   = _mm_unpackhi_epi8(b00_0f, r00_0f);
-	__m128i ga00_07   = _mm_unpacklo_epi8(g00_0f, ALPHA);
-	__m128i ga00_8f   = _mm_unpackhi_epi8(g00_0f, ALPHA);
-	__m128i bgra00_03 = _mm_unpacklo_epi8(br00_07, ga00_07);
-	__m128i bgra00_47 = _mm_unpackhi_epi8(br00_07, ga00_07);
-	__m128i bgra00_8b = _mm_unpacklo_epi8(br00_8f, ga00_8f);
-	__m128i bgra00_cf = _mm_unpackhi_epi8(br00_8f, ga00_8f);
-	_mm_store_si128(out0 + 0, bgra00_03);
-	_mm_store_si128(out0 + 1, bgra00_47);
-	_mm_store_si128(out0 + 2, bgra00_8b);
-	_mm_store_si128(out0 + 3, bgra00_cf);
-
-	// block bottom,left
-	__m128i y10_0f    = _mm_load_si128(y1 + 0);
-	__m128i y10_even  = _mm_and_si128(y10_0f, Y_MASK);
-	__m128i y10_odd   = _mm_srli_epi16(y10_0f, 8);
-	__m128i dy10_even = _mm_srai_epi16(_mm_mullo_epi16(y10_even, COEF_Y), 6);
-	__m128i dy10_odd  = _mm_srai_epi16(_mm_mullo_epi16(y10_odd,  COEF_Y), 6);
-	__m128i r10_even  = _mm_adds_epi16(dr07, dy10_even);
-	__m128i g10_even  = _mm_adds_epi16(dg07, dy10_even);
-	__m128i b10_even  = _mm_adds_epi16(db07, dy10_even);
-	__m128i r10_odd   = _mm_adds_epi16(dr07, dy10_odd);
-	__m128i g10_odd   = _mm_adds_epi16(dg07, dy10_odd);
-	__m128i b10_odd   = _mm_adds_epi16(db07, dy10_odd);
-	__m128i r10_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(r10_even, r10_even),
-	                                      _mm_packus_epi16(r10_odd,  r10_odd));
-	__m128i g10_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(g10_even, g10_even),
-	                                      _mm_packus_epi16(g10_odd,  g10_odd));
-	__m128i b10_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(b10_even, b10_even),
-	                                      _mm_packus_epi16(b10_odd,  b10_odd));
-	__m128i br10_07   = _mm_unpacklo_epi8(b10_0f, r10_0f);
-	__m128i br10_8f   = _mm_unpackhi_epi8(b10_0f, r10_0f);
-	__m128i ga10_07   = _mm_unpacklo_epi8(g10_0f, ALPHA);
-	__m128i ga10_8f   = _mm_unpackhi_epi8(g10_0f, ALPHA);
-	__m128i bgra10_03 = _mm_unpacklo_epi8(br10_07, ga10_07);
-	__m128i bgra10_47 = _mm_unpackhi_epi8(br10_07, ga10_07);
-	__m128i bgra10_8b = _mm_unpacklo_epi8(br10_8f, ga10_8f);
-	__m128i bgra10_cf = _mm_unpackhi_epi8(br10_8f, ga10_8f);
-	_mm_store_si128(out1 + 0, bgra10_03);
-	_mm_store_si128(out1 + 1, bgra10_47);
-	_mm_store_si128(out1 + 2, bgra10_8b);
-	_mm_store_si128(out1 + 3, bgra10_cf);
-
-	// right
-	__m128i u8f  = _mm_unpackhi_epi8(u0f, ZERO);
-	__m128i v8f  = _mm_unpackhi_epi8(v0f, ZERO);
-	__m128i mr8f = _mm_srai_epi16(_mm_mullo_epi16(v8f, RED_V), 6);
-	__m128i sg8f = _mm_mullo_epi16(v8f, GREEN_V);
-	__m128i tg8f = _mm_mullo_epi16(u8f, GREEN_U);
-	__m128i mg8f = _mm_srai_epi16(_mm_adds_epi16(sg8f, tg8f), 6);
-	__m128i mb8f = _mm_srli_epi16(_mm_mullo_epi16(u8f, BLUE_U), 6); // logical shift
-	__m128i dr8f = _mm_adds_epi16(mr8f, CNST_R);
-	__m128i dg8f = _mm_adds_epi16(mg8f, CNST_G);
-	__m128i db8f = _mm_adds_epi16(mb8f, CNST_B);
-
-	// block top,right
-	__m128i y01_0f    = _mm_load_si128(y0 + 1);
-	__m128i y01_even  = _mm_and_si128(y01_0f, Y_MASK);
-	__m128i y01_odd   = _mm_srli_epi16(y01_0f, 8);
-	__m128i dy01_even = _mm_srai_epi16(_mm_mullo_epi16(y01_even, COEF_Y), 6);
-	__m128i dy01_odd  = _mm_srai_epi16(_mm_mullo_epi16(y01_odd,  COEF_Y), 6);
-	__m128i r01_even  = _mm_adds_epi16(dr8f, dy01_even);
-	__m128i g01_even  = _mm_adds_epi16(dg8f, dy01_even);
-	__m128i b01_even  = _mm_adds_epi16(db8f, dy01_even);
-	__m128i r01_odd   = _mm_adds_epi16(dr8f, dy01_odd);
-	__m128i g01_odd   = _mm_adds_epi16(dg8f, dy01_odd);
-	__m128i b01_odd   = _mm_adds_epi16(db8f, dy01_odd);
-	__m128i r01_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(r01_even, r01_even),
-	                                      _mm_packus_epi16(r01_odd,  r01_odd));
-	__m128i g01_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(g01_even, g01_even),
-	                                      _mm_packus_epi16(g01_odd,  g01_odd));
-	__m128i b01_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(b01_even, b01_even),
-	                                      _mm_packus_epi16(b01_odd,  b01_odd));
-	__m128i br01_07   = _mm_unpacklo_epi8(b01_0f, r01_0f);
-	__m128i br01_8f   = _mm_unpackhi_epi8(b01_0f, r01_0f);
-	__m128i ga01_07   = _mm_unpacklo_epi8(g01_0f, ALPHA);
-	__m128i ga01_8f   = _mm_unpackhi_epi8(g01_0f, ALPHA);
-	__m128i bgra01_03 = _mm_unpacklo_epi8(br01_07, ga01_07);
-	__m128i bgra01_47 = _mm_unpackhi_epi8(br01_07, ga01_07);
-	__m128i bgra01_8b = _mm_unpacklo_epi8(br01_8f, ga01_8f);
-	__m128i bgra01_cf = _mm_unpackhi_epi8(br01_8f, ga01_8f);
-	_mm_store_si128(out0 + 4, bgra01_03);
-	_mm_store_si128(out0 + 5, bgra01_47);
-	_mm_store_si128(out0 + 6, bgra01_8b);
-	_mm_store_si128(out0 + 7, bgra01_cf);
-
-	// block bottom,right
-	__m128i y11_0f    = _mm_load_si128(y1 + 1);
-	__m128i y11_even  = _mm_and_si128(y11_0f, Y_MASK);
-	__m128i y11_odd   = _mm_srli_epi16(y11_0f, 8);
-	__m128i dy11_even = _mm_srai_epi16(_mm_mullo_epi16(y11_even, COEF_Y), 6);
-	__m128i dy11_odd  = _mm_srai_epi16(_mm_mullo_epi16(y11_odd,  COEF_Y), 6);
-	__m128i r11_even  = _mm_adds_epi16(dr8f, dy11_even);
-	__m128i g11_even  = _mm_adds_epi16(dg8f, dy11_even);
-	__m128i b11_even  = _mm_adds_epi16(db8f, dy11_even);
-	__m128i r11_odd   = _mm_adds_epi16(dr8f, dy11_odd);
-	__m128i g11_odd   = _mm_adds_epi16(dg8f, dy11_odd);
-	__m128i b11_odd   = _mm_adds_epi16(db8f, dy11_odd);
-	__m128i r11_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(r11_even, r11_even),
-	                                      _mm_packus_epi16(r11_odd,  r11_odd));
-	__m128i g11_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(g11_even, g11_even),
-	                                      _mm_packus_epi16(g11_odd,  g11_odd));
-	__m128i b11_0f    = _mm_unpackhi_epi8(_mm_packus_epi16(b11_even, b11_even),
-	                                      _mm_packus_epi16(b11_odd,  b11_odd));
-	__m128i br11_07   = _mm_unpacklo_epi8(b11_0f, r11_0f);
-	__m128i br11_8f   = _mm_unpackhi_epi8(b11_0f, r11_0f);
-	__m128i ga11_07   = _mm_unpacklo_epi8(g11_0f, ALPHA);
-	__m128i ga11_8f   = _mm_unpackhi_epi8(g11_0f, ALPHA);
-	__m128i bgra11_03 = _mm_unpacklo_epi8(br11_07, ga11_07);
-	__m128i bgra11_47 = _mm_unpackhi_epi8(br11_07, ga11_07);
-	__m128i bgra11_8b = _mm_unpacklo_epi8(br11_8f, ga11_8f);
-	__m128i bgra11_cf = _mm_unpackhi_epi8(br11_8f, ga11_8f);
-	_mm_store_si128(out1 + 4, bgra11_03);
-	_mm_store_si128(out1 + 5, bgra11_47);
-	_mm_store_si128(out1 + 6, bgra11_8b);
-	_mm_store_si128(out1 + 7, bgra11_cf);
+	__m128i y_even  = _mm_and_si128(y, Y_MASK);
+	__m128i y_odd   = _mm_srli_epi16(y, 8);
+	__m128i dy_even = _mm_srai_epi16(_mm_mullo_epi16(y_even, COEF_Y), 6);
+	__m128i dy_odd  = _mm_srai_epi16(_mm_mullo_epi16(y_odd,  COEF_Y), 6);
+	__m128i r_even  = _mm_adds_epi16(c.r, dy_even);
+	__m128i g_even  = _mm_adds_epi16(c.g, dy_even);
+	__m128i b_even  = _mm_adds_epi16(c.b, dy_even);
+	__m128i r_odd   = _mm_adds_epi16(c.r, dy_odd);
+	__m128i g_odd   = _mm_adds_epi16(c.g, dy_odd);
+	__m128i b_odd   = _mm_adds_epi16(c.b, dy_odd);
+	r = _mm_unpackhi_epi8(_mm_packus_epi16(r_even, r_even),
+	                      _mm_packus_epi16(r_odd,  r_odd));
+	g = _mm_unpackhi_epi8(_mm_packus_epi16(g_even, g_even),
+	                      _mm_packus_epi16(g_odd,  g_odd));
+	b = _mm_unpackhi_epi8(_mm_packus_epi16(b_even, b_even),
+	                      _mm_packus_epi16(b_odd,  b_odd));
 }
 
+// Stores 16 pixels as 0xAARRGGBB (same layout as the generic code below).
+struct StoreSSE2_32
+{
+	explicit StoreSSE2_32(const PixelFormat& /*format*/) {}
+
+	inline void operator()(uint32_t* out_, __m128i r, __m128i g, __m128i b) const
+	{
+		const __m128i ALPHA = _mm_set1_epi16(-1); // 0xFFFF
+		auto* out = reinterpret_cast<__m128i*>(out_);
+		__m128i br07 = _mm_unpacklo_epi8(b, r);
+		__m128i br8f = _mm_unpackhi_epi8(b, r);
+		__m128i ga07 = _mm_unpacklo_epi8(g, ALPHA);
+		__m128i ga8f = _mm_unpackhi_epi8(g, ALPHA);
+		_mm_store_si128(out + 0, _mm_unpacklo_epi8(br07, ga07));
+		_mm_store_si128(out + 1, _mm_unpackhi_epi8(br07, ga07));
+		_mm_store_si128(out + 2, _mm_unpacklo_epi8(br8f, ga8f));
+		_mm_store_si128(out + 3, _mm_unpackhi_epi8(br8f, ga8f));
+	}
+};
+
+// Stores 16 pixels in an arbitrary 16bpp format, same result as
+// PixelFormat::map().
+struct StoreSSE2_16
+{
+	explicit StoreSSE2_16(const PixelFormat& format)
+		: rLoss (_mm_cvtsi32_si128(format.getRloss()))
+		, gLoss (_mm_cvtsi32_si128(format.getGloss()))
+		, bLoss (_mm_cvtsi32_si128(format.getBloss()))
+		, rShift(_mm_cvtsi32_si128(format.getRshift()))
+		, gShift(_mm_cvtsi32_si128(format.getGshift()))
+		, bShift(_mm_cvtsi32_si128(format.getBshift()))
+		, aMask (_mm_set1_epi16(format.getAmask()))
+	{
+	}
+
+	inline __m128i map(__m128i r, __m128i g, __m128i b) const
+	{
+		__m128i pr = _mm_sll_epi16(_mm_srl_epi16(r, rLoss), rShift);
+		__m128i pg = _mm_sll_epi16(_mm_srl_epi16(g, gLoss), gShift);
+		__m128i pb = _mm_sll_epi16(_mm_srl_epi16(b, bLoss), bShift);
+		return _mm_or_si128(_mm_or_si128(pr, pg), _mm_or_si128(pb, aMask));
+	}
+
+	inline void operator()(uint16_t* out_, __m128i r, __m128i g, __m128i b) const
+	{
+		const __m128i ZERO = _mm_setzero_si128();
+		auto* out = reinterpret_cast<__m128i*>(out_);
+		_mm_store_si128(out + 0, map(_mm_unpacklo_epi8(r, ZERO),
+		                             _mm_unpacklo_epi8(g, ZERO),
+		                             _mm_unpacklo_epi8(b, ZERO)));
+		_mm_store_si128(out + 1, map(_mm_unpackhi_epi8(r, ZERO),
+		                             _mm_unpackhi_epi8(g, ZERO),
+		                             _mm_unpackhi_epi8(b, ZERO)));
+	}
+
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rShift, gShift, bShift;
+	__m128i aMask;
+};
+
+template<typename Pixel, typename Store>
+static inline void yuv2rgb_sse2(
+	const uint8_t* u_ , const uint8_t* v_,
+	const uint8_t* y0_, const uint8_t* y1_,
+	Pixel* out0, Pixel* out1, const Store& store)
+{
+	// This routine calculates 32x2 pixels. Each output pixel uses a
+	// unique corresponding input Y value, but a group of 2x2 ouput pixels
+	// shares the same U and V input value.
+	auto* y0 = reinterpret_cast<const __m128i*>(y0_);
+	auto* y1 = reinterpret_cast<const __m128i*>(y1_);
+
+	const __m128i ZERO = _mm_setzero_si128();
+	__m128i u0f = _mm_load_si128(reinterpret_cast<const __m128i*>(u_));
+	__m128i v0f = _mm_load_si128(reinterpret_cast<const __m128i*>(v_));
+	auto left  = chromaSSE2(_mm_unpacklo_epi8(u0f, ZERO),
+	                        _mm_unpacklo_epi8(v0f, ZERO));
+	auto right = chromaSSE2(_mm_unpackhi_epi8(u0f, ZERO),
+	                        _mm_unpackhi_epi8(v0f, ZERO));
+
+	__m128i r, g, b;
+	lumaSSE2(_mm_load_si128(y0 + 0), left,  r, g, b); // top,left
+	store(out0 +  0, r, g, b);
+	lumaSSE2(_mm_load_si128(y1 + 0), left,  r, g, b); // bottom,left
+	store(out1 +  0, r, g, b);
+	lumaSSE2(_mm_load_si128(y0 + 1), right, r, g, b); // top,right
+	store(out0 + 16, r, g, b);
+	lumaSSE2(_mm_load_si128(y1 + 1), right, r, g, b); // bottom,right
+	store(out1 + 16, r, g, b);
+}
+
+template<typename Pixel, typename Store>
 static inline void convertHelperSSE2(
-	const th_ycbcr_buffer& buffer, RawFrame& output)
+	const th_ycbcr_buffer& buffer, RawFrame& output, const PixelFormat& format)
 {
 	const int width      = buffer[0].width;
 	const int y_stride   = buffer[0].stride;
@@ -226,17 +189,18 @@ static inline void convertHelperSSE2(
 	assert((width % 32) == 0);
 	assert((buffer[0].height % 2) == 0);
 
+	Store store(format);
 	for (int y = 0; y < buffer[0].height; y += 2) {
 		const uint8_t* pY1 = buffer[0].data + y * y_stride;
 		const uint8_t* pY2 = buffer[0].data + (y + 1) * y_stride;
 		const uint8_t* pCb = buffer[1].data + y * uv_stride2;
 		const uint8_t* pCr = buffer[2].data + y * uv_stride2;
-		auto* out0 = output.getLinePtrDirect<uint32_t>(y + 0);
-		auto* out1 = output.getLinePtrDirect<uint32_t>(y + 1);
+		auto* out0 = output.getLinePtrDirect<Pixel>(y + 0);
+		auto* out1 = output.getLinePtrDirect<Pixel>(y + 1);
 
 		for (int x = 0; x < width; x += 32) {
 			// convert a block of (32 x 2) pixels
-			yuv2rgb_sse2(pCb, pCr, pY1, pY2, out0, out1);
+			yuv2rgb_sse2(pCb, pCr, pY1, pY2, out0, out1, store);
 			pCb += 16;
 			pCr += 16;
 			pY1 += 32;
@@ -340,13 +304,24 @@ static void convertHelper(const th_ycbcr_buffer& buffer, RawFrame& output,
 
 void convert(const th_ycbcr_buffer& input, RawFrame& output)
 {
+#ifdef __SSE2__
 	const PixelFormat& format = output.getPixelFormat();
 	if (format.getBytesPerPixel() == 4) {
-#ifdef __SSE2__
-		convertHelperSSE2(input, output);
+		convertHelperSSE2<uint32_t, StoreSSE2_32>(input, output, format);
+	} else {
+		assert(format.getBytesPerPixel() == 2);
+		convertHelperSSE2<uint16_t, StoreSSE2_16>(input, output, format);
+	}
 #else
-		convertHelper<uint32_t>(input, output, format);
+	convertScalar(input, output);
 #endif
+}
+
+void convertScalar(const th_ycbcr_buffer& input, RawFrame& output)
+{
+	const PixelFormat& format = output.getPixelFormat();
+	if (format.getBytesPerPixel() == 4) {
+		convertHelper<uint32_t>(input, output, format);
 	} else {
 		assert(format.getBytesPerPixel() == 2);
 		convertHelper<uint16_t>(input, output, format);
@@ -9,8 +9,17 @@ class RawFrame;
 
 namespace yuv2rgb {
 
+/** Converts a YUV420 image to the pixel format of the given frame. Uses SIMD
+  * instructions when available (the width must be a multiple of 32 then).
+  */
 void convert(const th_ycbcr_buffer& input, RawFrame& output);
 
+/** Portable C++ version of convert(), also used as reference in the
+  * unittest. The SIMD version uses less precise coefficients, so the
+  * result can be slightly different.
+  */
+void convertScalar(const th_ycbcr_buffer& input, RawFrame& output);
+
 } // namespace yuv2rgb
 } // namespace openmsx
 
@@ -13,6 +13,7 @@
 #include "RenderSettings.hh"
 #include "EnumSetting.hh"
 #include "MSXException.hh"
+#include "StartupProfiler.hh"
 #include "Thread.hh"
 #include "build-info.hh"
 #include "random.hh"
@@ -79,7 +80,10 @@ static int main(int argc, char **argv)
 
 	try {
 		randomize(); // seed global random generator
-		initializeSDL();
+		{
+			StartupProfiler::Scope scope("SDL init");
+			initializeSDL();
+		}
 
 		Thread::setMainThread();
 		Reactor reactor;
@@ -93,6 +97,7 @@ static int main(int argc, char **argv)
 
 		if (parseStatus != CommandLineParser::EXIT) {
 			if (!parser.isHiddenStartup()) {
+				StartupProfiler::Scope scope("renderer init");
 				auto& render = reactor.getDisplay().getRenderSettings().getRendererSetting();
 				render.setValue(render.getRestoreValue());
 				// Switching renderer requires events, handle
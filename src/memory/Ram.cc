@@ -8,6 +8,7 @@
 #include "serialize.hh"
 #include <zlib.h>
 #include <algorithm>
+#include <cassert>
 #include <cstring>
 #include <memory>
 
@@ -22,6 +23,8 @@ public:
 	              const string& description, Ram& ram);
 	byte read(unsigned address) override;
 	void write(unsigned address, byte value) override;
+	void readBlock(unsigned start, span<byte> output) override;
+	void writeBlock(unsigned start, span<const byte> input) override;
 private:
 	Ram& ram;
 };
@@ -115,6 +118,18 @@ void RamDebuggable::write(unsigned address, byte value)
 	ram[address] = value;
 }
 
+void RamDebuggable::readBlock(unsigned start, span<byte> output)
+{
+	assert((start + output.size()) <= ram.getSize());
+	memcpy(output.data(), &ram[start], output.size());
+}
+
+void RamDebuggable::writeBlock(unsigned start, span<const byte> input)
+{
+	assert((start + input.size()) <= ram.getSize());
+	memcpy(&ram[start], input.data(), input.size());
+}
+
 
 template<typename Archive>
 void Ram::serialize(Archive& ar, unsigned /*version*/)
@@ -0,0 +1,94 @@
+#include "catch.hpp"
+#include "BinaryCliCommParser.hh"
+#include <string>
+#include <vector>
+
+using namespace openmsx;
+
+struct Request {
+	uint32_t id;
+	std::string command;
+	std::string data;
+	bool hasData;
+
+	bool operator==(const Request& other) const {
+		return (id == other.id) && (command == other.command) &&
+		       (data == other.data) && (hasData == other.hasData);
+	}
+};
+
+static std::vector<Request> parse(const std::string& stream, size_t chunk, bool& ok)
+{
+	std::vector<Request> result;
+	BinaryCliCommParser parser([&](uint32_t id, std::string_view cmd, span<const uint8_t> data) {
+		result.push_back({id, std::string(cmd),
+		                  std::string(reinterpret_cast<const char*>(data.data()), data.size()),
+		                  data.data() != nullptr});
+	});
+	ok = true;
+	for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+		auto n = std::min(chunk, stream.size() - pos);
+		if (!parser.parse(&stream[pos], n)) ok = false;
+	}
+	return result;
+}
+
+static std::string withData(std::string_view cmd, std::string_view data)
+{
+	std::string payload(4, '\0');
+	payload[0] = char(cmd.size());
+	payload += cmd;
+	payload += data;
+	return payload;
+}
+
+TEST_CASE("BinaryCliCommParser")
+{
+	using P = BinaryCliCommParser;
+	bool ok;
+
+	SECTION("frame layout") {
+		CHECK(P::makeFrame(P::REPLY_OK, 0x04030201, "ab") ==
+		      std::string("\x07\x00\x00\x00\x00\x01\x02\x03\x04" "ab", 11));
+	}
+	SECTION("single command") {
+		auto s = P::makeFrame(P::COMMAND, 7, "set power on");
+		for (size_t chunk : {1, 3, 100}) {
+			CHECK(parse(s, chunk, ok) ==
+			      std::vector<Request>{{7, "set power on", "", false}});
+			CHECK(ok);
+		}
+	}
+	SECTION("pipelined commands") {
+		auto s = P::makeFrame(P::COMMAND, 1, "foo") +
+		         P::makeFrame(P::COMMAND, 2, "") +
+		         P::makeFrame(P::COMMAND_WITH_DATA, 3,
+		                      withData("debug write_block", std::string("\0\xff<&", 4)));
+		for (size_t chunk : {1, 5, 1000}) {
+			CHECK(parse(s, chunk, ok) == std::vector<Request>{
+				{1, "foo", "", false},
+				{2, "", "", false},
+				{3, "debug write_block", std::string("\0\xff<&", 4), true}});
+			CHECK(ok);
+		}
+	}
+	SECTION("incomplete frame") {
+		auto s = P::makeFrame(P::COMMAND, 1, "foo");
+		s.pop_back();
+		CHECK(parse(s, 1, ok).empty());
+		CHECK(ok);
+	}
+	SECTION("errors") {
+		// unknown frame type
+		auto s1 = P::makeFrame(9, 1, "foo") + P::makeFrame(P::COMMAND, 2, "bar");
+		CHECK(parse(s1, 100, ok).empty());
+		CHECK(!ok);
+		// too short
+		CHECK(parse(std::string("\x02\x00\x00\x00\x00\x00", 6), 100, ok).empty());
+		CHECK(!ok);
+		// command length doesn't fit in the frame
+		auto s2 = P::makeFrame(P::COMMAND_WITH_DATA, 1, withData("foo", "").substr(0, 5));
+		CHECK(parse(s2, 100, ok).empty());
+		CHECK(!ok);
+	}
+}
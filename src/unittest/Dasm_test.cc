@@ -0,0 +1,34 @@
+#include "catch.hpp"
+#include "Dasm.hh"
+#include <initializer_list>
+#include <vector>
+
+using namespace openmsx;
+
+static std::string dasmBuf(std::initializer_list<byte> bytes, word pc, unsigned& len)
+{
+	std::vector<byte> buf(bytes);
+	std::string result;
+	len = dasm(span<const byte>(buf.data(), buf.size()), pc, result);
+	return result;
+}
+
+TEST_CASE("dasm from buffer")
+{
+	unsigned len;
+	CHECK(dasmBuf({0x00}, 0, len) == "nop                ");
+	CHECK(len == 1);
+	CHECK(dasmBuf({0x3E, 0x12}, 0, len) == "ld     a,#12       ");
+	CHECK(len == 2);
+	CHECK(dasmBuf({0xCD, 0x34, 0x12}, 0, len) == "call   #1234       ");
+	CHECK(len == 3);
+	CHECK(dasmBuf({0x18, 0xFE}, 0x100, len) == "jr     #0100       ");
+	CHECK(len == 2);
+	CHECK(dasmBuf({0xDD, 0xCB, 0x05, 0x46}, 0, len) == "bit    0,ix+#05    ");
+	CHECK(len == 4);
+	CHECK(dasmBuf({0xED, 0xB0}, 0, len) == "ldir               ");
+	CHECK(len == 2);
+	// missing bytes are taken as zero
+	CHECK(dasmBuf({0xC3}, 0, len) == "jp     #0000       ");
+	CHECK(len == 3);
+}
@@ -0,0 +1,86 @@
+#include "catch.hpp"
+#include "HDOverlay.hh"
+#include "File.hh"
+#include "FileOperations.hh"
+#include "MSXException.hh"
+#include <cstring>
+#include <vector>
+
+using namespace openmsx;
+
+static SectorBuffer makeSector(uint8_t value)
+{
+	SectorBuffer buf;
+	memset(buf.raw, value, sizeof(buf.raw));
+	return buf;
+}
+
+static bool sameSector(const SectorBuffer& a, const SectorBuffer& b)
+{
+	return memcmp(a.raw, b.raw, sizeof(a.raw)) == 0;
+}
+
+static std::vector<size_t> getSectors(const HDOverlay& overlay)
+{
+	std::vector<size_t> result;
+	overlay.forEachSector([&](size_t sector) { result.push_back(sector); });
+	return result;
+}
+
+TEST_CASE("HDOverlay")
+{
+	std::string name = FileOperations::join(
+		FileOperations::getTempDir(), "openmsx-hdoverlay-test.ovl");
+	FileOperations::unlink(name);
+	Filename filename(name);
+	constexpr size_t NUM_SECTORS = 100;
+
+	{
+		HDOverlay overlay(filename, NUM_SECTORS);
+		CHECK(overlay.getNumDirtySectors() == 0);
+		CHECK(getSectors(overlay).empty());
+
+		overlay.writeSector(3, makeSector(0x33));
+		overlay.writeSector(50, makeSector(0x50));
+		overlay.writeSector(3, makeSector(0x34)); // overwrite
+		CHECK(overlay.contains(3));
+		CHECK(overlay.contains(50));
+		CHECK(!overlay.contains(4));
+		CHECK(overlay.getNumDirtySectors() == 2);
+		CHECK(getSectors(overlay) == std::vector<size_t>{3, 50});
+
+		SectorBuffer buf;
+		overlay.readSector(3, buf);
+		CHECK(sameSector(buf, makeSector(0x34)));
+	}
+	SECTION("reopen") {
+		HDOverlay overlay(filename, NUM_SECTORS);
+		CHECK(overlay.getNumDirtySectors() == 2);
+		CHECK(getSectors(overlay) == std::vector<size_t>{3, 50});
+		SectorBuffer buf;
+		overlay.readSector(50, buf);
+		CHECK(sameSector(buf, makeSector(0x50)));
+	}
+	SECTION("clear") {
+		{
+			HDOverlay overlay(filename, NUM_SECTORS);
+			overlay.clear();
+			CHECK(overlay.getNumDirtySectors() == 0);
+			CHECK(!overlay.contains(3));
+		}
+		HDOverlay overlay(filename, NUM_SECTORS);
+		CHECK(getSectors(overlay).empty());
+	}
+	SECTION("different base image size") {
+		CHECK_THROWS_AS(HDOverlay(filename, NUM_SECTORS + 1), MSXException);
+	}
+	SECTION("not an overlay file") {
+		{
+			File file(filename, File::TRUNCATE);
+			std::vector<uint8_t> garbage(2 * sizeof(SectorBuffer), 0xAB);
+			file.write(garbage.data(), garbage.size());
+		}
+		CHECK_THROWS_AS(HDOverlay(filename, NUM_SECTORS), MSXException);
+	}
+	FileOperations::unlink(name);
+}
@@ -0,0 +1,46 @@
+#include "catch.hpp"
+#include "ProfileCounters.hh"
+#include "ScopedAssign.hh"
+
+enum class TestCounters { Foo, Bar, NUM };
+static std::ostream& operator<<(std::ostream& os, EnumTypeName<TestCounters>)
+{
+	return os << "TestCounters";
+}
+static std::ostream& operator<<(std::ostream& os, EnumValueName<TestCounters> evn)
+{
+	return os << ((evn.e == TestCounters::Foo) ? "Foo" : "Bar");
+}
+
+TEST_CASE("RuntimeProfileCounters")
+{
+	RuntimeProfileCounters<TestCounters> counters;
+	CHECK(counters.getName() == "TestCounters");
+	CHECK(counters.getCounterName(0) == "Foo");
+	CHECK(counters.getCounterName(1) == "Bar");
+
+	SECTION("disabled") {
+		ScopedAssign sa(ProfileCountersBase::enabled, false);
+		counters.tick(TestCounters::Foo);
+		CHECK(counters.getCounters()[0] == 0);
+	}
+	SECTION("enabled") {
+		ScopedAssign sa(ProfileCountersBase::enabled, true);
+		counters.tick(TestCounters::Foo);
+		counters.tick(TestCounters::Bar);
+		counters.tick(TestCounters::Bar);
+		CHECK(counters.getCounters()[0] == 1);
+		CHECK(counters.getCounters()[1] == 2);
+		counters.reset();
+		CHECK(counters.getCounters()[1] == 0);
+	}
+	SECTION("registry") {
+		auto n = ProfileCountersBase::getAll().size();
+		{
+			RuntimeProfileCounters<TestCounters> other("other");
+			CHECK(ProfileCountersBase::getAll().size() == n + 1);
+			CHECK(ProfileCountersBase::getAll().back() == &other);
+		}
+		CHECK(ProfileCountersBase::getAll().size() == n);
+	}
+}
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+#include "SeekableInflate.hh"
+#include "FileException.hh"
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+using namespace openmsx;
+
+static std::vector<uint8_t> generateData(size_t size)
+{
+	// Somewhat compressible data.
+	std::vector<uint8_t> result(size);
+	std::minstd_rand rng(1234);
+	for (size_t i = 0; i < size; ++i) {
+		result[i] = (rng() % 8) ? uint8_t(i >> 10) : uint8_t(rng());
+	}
+	return result;
+}
+
+static std::vector<uint8_t> rawDeflate(const std::vector<uint8_t>& input)
+{
+	z_stream s;
+	memset(&s, 0, sizeof(s));
+	REQUIRE(deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+	                     8, Z_DEFAULT_STRATEGY) == Z_OK);
+	std::vector<uint8_t> result(deflateBound(&s, uLong(input.size())));
+	s.next_in = const_cast<uint8_t*>(input.data());
+	s.avail_in = uInt(input.size());
+	s.next_out = result.data();
+	s.avail_out = uInt(result.size());
+	REQUIRE(deflate(&s, Z_FINISH) == Z_STREAM_END);
+	result.resize(s.total_out);
+	deflateEnd(&s);
+	return result;
+}
+
+TEST_CASE("SeekableInflate")
+{
+	auto data = generateData(5 * 1024 * 1024 + 123);
+	auto compressed = rawDeflate(data);
+	std::vector<uint8_t> buf(300000);
+
+	SECTION("sequential read") {
+		SeekableInflate si(compressed, data.size(), true);
+		CHECK(si.getSize() == data.size());
+		size_t pos = 0;
+		while (pos < data.size()) {
+			auto num = std::min(buf.size(), data.size() - pos);
+			si.read(pos, buf.data(), num);
+			CHECK(memcmp(buf.data(), &data[pos], num) == 0);
+			pos += num;
+		}
+	}
+	SECTION("random access, small cache") {
+		SeekableInflate::setCacheLimit(1);
+		SeekableInflate si(compressed, data.size(), true);
+		std::minstd_rand rng(42);
+		for (int i = 0; i < 50; ++i) {
+			size_t num = rng() % buf.size();
+			size_t pos = rng() % (data.size() - num);
+			si.read(pos, buf.data(), num);
+			CHECK(memcmp(buf.data(), &data[pos], num) == 0);
+		}
+		// read the tail first, then the start
+		SeekableInflate si2(compressed, data.size(), true);
+		si2.read(data.size() - 10, buf.data(), 10);
+		CHECK(memcmp(buf.data(), &data[data.size() - 10], 10) == 0);
+		si2.read(0, buf.data(), 10);
+		CHECK(memcmp(buf.data(), &data[0], 10) == 0);
+		SeekableInflate::setCacheLimit(64 * 1024 * 1024);
+	}
+	SECTION("read beyond end") {
+		SeekableInflate si(compressed, data.size(), true);
+		CHECK_THROWS_AS(si.read(data.size() - 5, buf.data(), 10), FileException);
+	}
+	SECTION("size only known modulo 2^32") {
+		SeekableInflate si(compressed, uint32_t(data.size()), false);
+		CHECK(si.getSize() == data.size());
+		si.read(data.size() - 10, buf.data(), 10);
+		CHECK(memcmp(buf.data(), &data[data.size() - 10], 10) == 0);
+		CHECK(si.getSize() == data.size());
+		CHECK_THROWS_AS(si.read(data.size() - 5, buf.data(), 10), FileException);
+	}
+	SECTION("wrong size in trailer") {
+		SeekableInflate si(compressed, 1000, false);
+		CHECK(si.getSize() == 1000);
+		CHECK_THROWS_AS(si.read(data.size() - 10, buf.data(), 10), FileException);
+	}
+	SECTION("concurrent readers") {
+		SeekableInflate::setCacheLimit(1);
+		auto reader = [&](unsigned seed, bool& ok) {
+			SeekableInflate si(compressed, data.size(), true);
+			std::vector<uint8_t> b(100000);
+			std::minstd_rand rng(seed);
+			ok = true;
+			for (int i = 0; i < 20; ++i) {
+				size_t num = rng() % b.size();
+				size_t pos = rng() % (data.size() - num);
+				si.read(pos, b.data(), num);
+				ok &= memcmp(b.data(), &data[pos], num) == 0;
+			}
+		};
+		bool ok1, ok2;
+		std::thread t1(reader, 1, std::ref(ok1));
+		std::thread t2(reader, 2, std::ref(ok2));
+		t1.join();
+		t2.join();
+		CHECK(ok1);
+		CHECK(ok2);
+		SeekableInflate::setCacheLimit(64 * 1024 * 1024);
+	}
+	SECTION("truncated input") {
+		compressed.resize(compressed.size() / 2);
+		SeekableInflate si(compressed, data.size(), true);
+		CHECK_THROWS_AS(si.read(data.size() - 5, buf.data(), 5), FileException);
+	}
+}
@@ -34,6 +34,10 @@ TEST_CASE("TclObject, constructors")
 		TclObject t(42);
 		CHECK(t.getString() == "42");
 	}
+	SECTION("uint64_t") {
+		TclObject t(uint64_t(0x123456789));
+		CHECK(t.getString() == "4886718345");
+	}
 	SECTION("double") {
 		TclObject t(6.28);
 		CHECK(t.getString() == "6.28");
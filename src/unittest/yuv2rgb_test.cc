@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include "components.hh"
+
+#if COMPONENT_LASERDISC
+
+#include "yuv2rgb.hh"
+#include "PixelFormat.hh"
+#include "RawFrame.hh"
+#include "MemBuffer.hh"
+#include "xrange.hh"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace openmsx;
+
+// The SIMD version uses 6-bit fixed point coefficients, the reference uses
+// 15-bit. Allow a small difference per (8-bit) color component.
+constexpr int TOLERANCE = 4;
+
+static void checkSame(RawFrame& ref, RawFrame& opt, unsigned width, unsigned height)
+{
+	const auto& f = ref.getPixelFormat();
+	auto diff = [](unsigned p1, unsigned p2, unsigned mask, unsigned shift, unsigned loss) {
+		int c1 = int(((p1 & mask) >> shift) << loss);
+		int c2 = int(((p2 & mask) >> shift) << loss);
+		// after dropping the low bits a small difference can become
+		// one full unit
+		return std::abs(c1 - c2) - ((1 << loss) - 1);
+	};
+	int maxDiff = 0;
+	for (auto y : xrange(height)) {
+		REQUIRE(ref.getLineWidthDirect(y) == width);
+		REQUIRE(opt.getLineWidthDirect(y) == width);
+		for (auto x : xrange(width)) {
+			unsigned p1, p2;
+			if (f.getBytesPerPixel() == 4) {
+				p1 = ref.getLinePtrDirect<uint32_t>(y)[x];
+				p2 = opt.getLinePtrDirect<uint32_t>(y)[x];
+			} else {
+				p1 = ref.getLinePtrDirect<uint16_t>(y)[x];
+				p2 = opt.getLinePtrDirect<uint16_t>(y)[x];
+			}
+			maxDiff = std::max({maxDiff,
+				diff(p1, p2, f.getRmask(), f.getRshift(), f.getRloss()),
+				diff(p1, p2, f.getGmask(), f.getGshift(), f.getGloss()),
+				diff(p1, p2, f.getBmask(), f.getBshift(), f.getBloss())});
+		}
+	}
+	CHECK(maxDiff <= TOLERANCE);
+}
+
+static void test(const PixelFormat& format)
+{
+	constexpr unsigned WIDTH = 64;
+	constexpr unsigned HEIGHT = 16;
+
+	// Cover all Y values and U/V combinations, including the extremes that
+	// get clipped.
+	MemBuffer<uint8_t, 16> yData(WIDTH * HEIGHT);
+	MemBuffer<uint8_t, 16> uData(WIDTH / 2 * HEIGHT / 2);
+	MemBuffer<uint8_t, 16> vData(WIDTH / 2 * HEIGHT / 2);
+	for (auto i : xrange(WIDTH * HEIGHT)) {
+		yData[i] = uint8_t(i * 7);
+	}
+	for (auto i : xrange(WIDTH / 2 * HEIGHT / 2)) {
+		uData[i] = uint8_t(i * 37);
+		vData[i] = uint8_t(i * 101 + 13);
+	}
+
+	th_ycbcr_buffer buffer;
+	buffer[0].width  = WIDTH;
+	buffer[0].height = HEIGHT;
+	buffer[0].stride = WIDTH;
+	buffer[0].data   = yData.data();
+	buffer[1].width  = WIDTH / 2;
+	buffer[1].height = HEIGHT / 2;
+	buffer[1].stride = WIDTH / 2;
+	buffer[1].data   = uData.data();
+	buffer[2] = buffer[1];
+	buffer[2].data   = vData.data();
+
+	RawFrame ref(format, WIDTH, HEIGHT);
+	RawFrame opt(format, WIDTH, HEIGHT);
+	yuv2rgb::convertScalar(buffer, ref);
+	yuv2rgb::convert(buffer, opt);
+	checkSame(ref, opt, WIDTH, HEIGHT);
+}
+
+TEST_CASE("yuv2rgb: 32bpp")
+{
+	test(PixelFormat(32,
+		0x00FF0000, 16, 0,
+		0x0000FF00,  8, 0,
+		0x000000FF,  0, 0,
+		0xFF000000, 24, 0));
+}
+
+TEST_CASE("yuv2rgb: 16bpp")
+{
+	test(PixelFormat(16,
+		0xF800, 11, 3,
+		0x07E0,  5, 2,
+		0x001F,  0, 3,
+		0x0000,  0, 8));
+}
+
+#endif
@@ -0,0 +1,27 @@
+#include "ProfileCounters.hh"
+#include "stl.hh"
+#include <cassert>
+
+static std::vector<ProfileCountersBase*>& getList()
+{
+	static std::vector<ProfileCountersBase*> list;
+	return list;
+}
+
+const std::vector<ProfileCountersBase*>& ProfileCountersBase::getAll()
+{
+	return getList();
+}
+
+ProfileCountersBase::ProfileCountersBase(std::string name_)
+	: name(std::move(name_))
+{
+	getList().push_back(this);
+}
+
+ProfileCountersBase::~ProfileCountersBase()
+{
+	auto& list = getList();
+	auto it = rfind_unguarded(list, this);
+	list.erase(it);
+}
@@ -1,7 +1,14 @@
 #ifndef PROFILECOUNTERS_HH
 #define PROFILECOUNTERS_HH
 
+#include "likely.hh"
+#include "span.hh"
+#include <cstdint>
 #include <iostream>
+#include <sstream>
+#include <string_view>
+#include <string>
+#include <vector>
 
 //
 // Quick and dirty reflection on C++ enums (in the future replace with c++23 reflexpr).
@@ -26,28 +33,54 @@ template<typename E> std::ostream& operator<<(std::ostream& os, EnumValueName<E>
 
 
 
+// Common (non-template) part of RuntimeProfileCounters. All instances are
+// kept in a global list, so that they can be queried (e.g. via the 'profile'
+// command) without knowing the concrete ENUM type.
+class ProfileCountersBase
+{
+public:
+	ProfileCountersBase(const ProfileCountersBase&) = delete;
+	ProfileCountersBase& operator=(const ProfileCountersBase&) = delete;
+
+	// Global switch, when false tick() does (almost) nothing.
+	static inline bool enabled = false;
+
+	[[nodiscard]] static const std::vector<ProfileCountersBase*>& getAll();
+
+	[[nodiscard]] const std::string& getName() const { return name; }
+	[[nodiscard]] virtual std::string getCounterName(size_t i) const = 0;
+	[[nodiscard]] virtual span<const uint64_t> getCounters() const = 0;
+	virtual void reset() = 0;
+
+protected:
+	explicit ProfileCountersBase(std::string name);
+	~ProfileCountersBase();
+
+private:
+	const std::string name;
+};
+
 // A collection of (simple) profile counters:
 // - Counters start at zero.
 // - An individual counter can be incremented by 1 via 'tick(<counter-id>)'.
-// - When this 'ProfileCounters' object is destoyed it prints the value of each
-//   counter.
+// - Counting can be switched on/off at runtime (see
+//   ProfileCountersBase::enabled). When switched off, the cost of tick() is a
+//   single well-predicted branch.
+// - Instances with the same name (e.g. the same counters in different
+//   machines) are reported as one.
 //
-// Template parameters:
-// - bool ENABLED:
-//    when false, the optimizer should be able to completely optimize-out all
-//    profile related code
-// - typename ENUM:
-//    Must be a c++ enum (or enum class) which satisfies the following requirements:
-//    * The numerical values must be 0, 1, ... IOW the values must be usable as
-//      indices in an array. (This is automatically the case if you don't
-//      manually assign numeric values).
-//    * There must be an enum value with the name 'NUM' which has a numerical
-//      value equal to the number of other values in this enum. (This is
-//      automatically the case if you put 'NUM' last in the list of enum
-//      values).
-//    * You must overload the following two functions for the type 'ENUM':
-//          std::ostream& operator<<(std::ostream& os, EnumTypeName<ENUM>);
-//          std::ostream& operator<<(std::ostream& os, EnumValueName<ENUM> evn);
+// Template parameter ENUM must be a c++ enum (or enum class) which satisfies
+// the following requirements:
+//  * The numerical values must be 0, 1, ... IOW the values must be usable as
+//    indices in an array. (This is automatically the case if you don't
+//    manually assign numeric values).
+//  * There must be an enum value with the name 'NUM' which has a numerical
+//    value equal to the number of other values in this enum. (This is
+//    automatically the case if you put 'NUM' last in the list of enum
+//    values).
+//  * You must overload the following two functions for the type 'ENUM':
+//        std::ostream& operator<<(std::ostream& os, EnumTypeName<ENUM>);
+//        std::ostream& operator<<(std::ostream& os, EnumValueName<ENUM> evn);
 //
 // Example usage:
 //    enum class WidgetProfileCounter {
@@ -67,50 +100,50 @@ template<typename E> std::ostream& operator<<(std::ostream& os, EnumValueName<E>
 //        return os << names[size_t(evn.e)];
 //    }
 //
-//    constexpr bool PRINT_WIDGET_PROFILE = true; // possibly depending on some #define
-//
-//    struct Widget : private ProfileCounters<PRINT_WIDGET_PROFILE, WidgetProfileCounter>
+//    struct Widget
 //    {
 //        void calculate() {
-//            tick(WidgetProfileCounter::CALCULATE);
+//            profile.tick(WidgetProfileCounter::CALCULATE);
 //            // ...
 //        }
 //        void invalidate() {
-//            tick(WidgetProfileCounter::CALCULATE);
+//            profile.tick(WidgetProfileCounter::INVALIDATE);
 //            // ...
 //        }
+//        RuntimeProfileCounters<WidgetProfileCounter> profile;
 //    };
-
-template<bool ENABLED, typename ENUM>
-class ProfileCounters
+template<typename ENUM>
+class RuntimeProfileCounters final : public ProfileCountersBase
 {
 public:
-	// Print counters on destruction.
-	~ProfileCounters() {
-		std::cout << "-- Profile counters: " << EnumTypeName<ENUM>() << " -- " << static_cast<void*>(this) << '\n';
-		for (size_t i = 0; i < NUM; ++i) {
-			std::cout << EnumValueName{ENUM(i)} << ": " << counters[i] << '\n';
-		}
-	}
+	explicit RuntimeProfileCounters(std::string name_ = defaultName())
+		: ProfileCountersBase(std::move(name_)) {}
 
-	// Increment
 	void tick(ENUM e) const {
-		++counters[size_t(e)];
+		if (unlikely(enabled)) ++counters[size_t(e)];
 	}
 
-private:
-	static constexpr auto NUM = size_t(ENUM::NUM); // value 'ENUM::NUM' must exist
-	mutable unsigned counters[NUM] = {};
-};
+	[[nodiscard]] std::string getCounterName(size_t i) const override {
+		std::ostringstream os;
+		os << EnumValueName{ENUM(i)};
+		return os.str();
+	}
+	[[nodiscard]] span<const uint64_t> getCounters() const override {
+		return {counters, NUM};
+	}
+	void reset() override {
+		for (auto& c : counters) c = 0;
+	}
 
+private:
+	static std::string defaultName() {
+		std::ostringstream os;
+		os << EnumTypeName<ENUM>();
+		return os.str();
+	}
 
-// Specialization for when profiling is disabled.
-// This class is simple enough so that it can be completely optimized away.
-template<typename ENUM>
-class ProfileCounters<false, ENUM>
-{
-public:
-	void tick(ENUM) const { /*nothing*/ }
+	static constexpr auto NUM = size_t(ENUM::NUM); // value 'ENUM::NUM' must exist
+	mutable uint64_t counters[NUM] = {};
 };
 
 #endif
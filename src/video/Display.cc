@@ -17,6 +17,7 @@
 #include "MSXMotherBoard.hh"
 #include "HardwareConfig.hh"
 #include "TclArgParser.hh"
+#include "ScreenShotWriter.hh"
 #include "XMLElement.hh"
 #include "VideoSystemChangeListener.hh"
 #include "CommandException.hh"
@@ -43,6 +44,7 @@ Display::Display(Reactor& reactor_)
 	, osdGui(reactor_.getCommandController(), *this)
 	, reactor(reactor_)
 	, renderSettings(reactor.getCommandController())
+	, screenShotWriter(reactor.getCommandController())
 	, commandConsole(reactor.getGlobalCommandController(),
 	                 reactor.getEventDistributor(), *this)
 	, currentRenderer(RenderSettings::UNINITIALIZED)
@@ -183,7 +185,9 @@ int Display::signalEvent(const std::shared_ptr<const Event>& event)
 	if (event->getType() == OPENMSX_FINISH_FRAME_EVENT) {
 		auto& ffe = checked_cast<const FinishFrameEvent&>(*event);
 		if (ffe.needRender()) {
+			auto start = Timer::getTime();
 			videoSystem->repaint();
+			presentDuration = Timer::getTime() - start;
 			reactor.getEventDistributor().distributeEvent(
 				std::make_shared<SimpleEvent>(
 					OPENMSX_FRAME_DRAWN_EVENT));
@@ -409,12 +413,14 @@ void Display::ScreenShotCmd::execute(span<const TclObject> tokens, TclObject& re
 	bool msxOnly = false;
 	bool doubleSize = false;
 	bool withOsd = false;
+	bool async = false;
 	ArgsInfo info[] = {
 		valueArg("-prefix", prefix),
 		flagArg("-raw", rawShot),
 		flagArg("-msxonly", msxOnly),
 		flagArg("-doublesize", doubleSize),
-		flagArg("-with-osd", withOsd)
+		flagArg("-with-osd", withOsd),
+		flagArg("-async", async)
 	};
 	auto arguments = parseTclArgs(getInterpreter(), tokens.subspan(1), info);
 
@@ -449,10 +455,12 @@ void Display::ScreenShotCmd::execute(span<const TclObject> tokens, TclObject& re
 	string filename = FileOperations::parseCommandFileArgument(
 		fname, "screenshots", prefix, ".png");
 
+	auto& writer = display.screenShotWriter;
 	if (!rawShot) {
 		// include all layers (OSD stuff, console)
 		try {
-			display.getVideoSystem().takeScreenShot(filename, withOsd);
+			display.getVideoSystem().takeScreenShot(
+				writer, filename, withOsd, async);
 		} catch (MSXException& e) {
 			throw CommandException(
 				"Failed to take screenshot: ", e.getMessage());
@@ -466,14 +474,15 @@ void Display::ScreenShotCmd::execute(span<const TclObject> tokens, TclObject& re
 		}
 		unsigned height = doubleSize ? 480 : 240;
 		try {
-			videoLayer->takeRawScreenShot(height, filename);
+			videoLayer->takeRawScreenShot(height, writer, filename, async);
 		} catch (MSXException& e) {
 			throw CommandException(
 				"Failed to take screenshot: ", e.getMessage());
 		}
 	}
 
-	display.getCliComm().printInfo("Screen saved to ", filename);
+	display.getCliComm().printInfo(
+		async ? "Screen is being saved to " : "Screen saved to ", filename);
 	result = filename;
 }
 
@@ -486,13 +495,16 @@ string Display::ScreenShotCmd::help(const vector<string>& /*tokens*/) const
 	       "screenshot -raw              320x240 raw screenshot (of MSX screen only)\n"
 	       "screenshot -raw -doublesize  640x480 raw screenshot (of MSX screen only)\n"
 	       "screenshot -with-osd         Include OSD elements in the screenshot\n"
-	       "screenshot -no-sprites       Don't include sprites in the screenshot\n";
+	       "screenshot -no-sprites       Don't include sprites in the screenshot\n"
+	       "screenshot -async            Write the file in the background, see also\n"
+	       "                             'screenshot_wait' and 'screenshot_compression'\n";
 }
 
 void Display::ScreenShotCmd::tabCompletion(vector<string>& tokens) const
 {
 	static constexpr const char* const extra[] = {
 		"-prefix", "-raw", "-doublesize", "-with-osd", "-no-sprites",
+		"-async",
 	};
 	completeFileName(tokens, userFileContext(), extra);
 }
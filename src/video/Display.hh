@@ -2,6 +2,7 @@
 #define DISPLAY_HH
 
 #include "RenderSettings.hh"
+#include "ScreenShotWriter.hh"
 #include "Command.hh"
 #include "CommandConsole.hh"
 #include "InfoTopic.hh"
@@ -65,6 +66,11 @@ public:
 
 	std::string getWindowTitle();
 
+	/** Real time (in us) it took to present the last (non-skipped)
+	  * frame, that is to repaint all layers and flush the output.
+	  */
+	uint64_t getPresentDuration() const { return presentDuration; }
+
 private:
 	void resetVideoSystem();
 
@@ -98,6 +104,7 @@ private:
 	CircularBuffer<uint64_t, NUM_FRAME_DURATIONS> frameDurations;
 	uint64_t frameDurationSum;
 	uint64_t prevTimeStamp;
+	uint64_t presentDuration = 0;
 
 	struct ScreenShotCmd final : Command {
 		explicit ScreenShotCmd(CommandController& commandController);
@@ -117,6 +124,7 @@ private:
 
 	Reactor& reactor;
 	RenderSettings renderSettings;
+	ScreenShotWriter screenShotWriter;
 	CommandConsole commandConsole;
 
 	// the current renderer
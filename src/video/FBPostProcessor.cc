@@ -287,6 +287,18 @@ void FBPostProcessor<Pixel>::paint(OutputSurface& output_)
 	unsigned srcStep = srcHeight / g;
 	unsigned dstStep = dstHeight / g;
 
+	// All pixels of the output are written below. When every line is a
+	// plain copy of a single source line they are never read back, then
+	// they can be written directly to the display. Deinterlacing,
+	// deflickering, superimposing, blending two source lines (scaled
+	// height) and adding noise all read back the output lines.
+	bool plainCopy = (factor == 1) &&
+	                 (paintFrame == lastFrames[0].get()) &&
+	                 !superImposeVideoFrame &&
+	                 (srcHeight == dstHeight) &&
+	                 (renderSettings.getNoise() == 0.0f);
+	output.beginFrame(plainCopy);
+
 	// TODO: Store all MSX lines in RawFrame and only scale the ones that fit
 	//       on the PC screen, as a preparation for resizable output window.
 	unsigned srcStartY = 0;
@@ -0,0 +1,98 @@
+#include "FramePacer.hh"
+#include "Display.hh"
+#include "RealTime.hh"
+#include "RenderSettings.hh"
+#include "TclObject.hh"
+#include "Timer.hh"
+#include "unreachable.hh"
+#include <algorithm>
+
+namespace openmsx {
+
+// Weight of the last frame in the moving averages.
+constexpr float ALPHA = 0.2f;
+
+static void average(float& avg, float current)
+{
+	avg = avg * (1 - ALPHA) + current * ALPHA;
+}
+
+FramePacer::FramePacer(RealTime& realTime_, Display& display_)
+	: realTime(realTime_)
+	, display(display_)
+	, renderSettings(display.getRenderSettings())
+{
+}
+
+void FramePacer::frameStart(EmuTime::param time)
+{
+	auto now = Timer::getTime();
+	auto sleepTime = realTime.getSleepTime();
+	if (started && (time > startTime)) {
+		// Everything the host did since the start of the previous
+		// frame, except for sleeping, is the cost of that frame.
+		auto busy = int64_t(now - startRealTime) -
+		            int64_t(sleepTime - startSleepTime);
+		int64_t present = prevPresented ? display.getPresentDuration() : 0;
+		auto emulation = std::max<int64_t>(
+			0, busy - int64_t(renderTime) - present);
+		average(emulationDuration, float(emulation));
+		if (prevRendered)  average(renderDuration, float(renderTime));
+		if (prevPresented) average(presentDuration, float(present));
+		frameDuration = time - startTime;
+	}
+	startRealTime = now;
+	startSleepTime = sleepTime;
+	startTime = time;
+	renderTime = 0;
+	started = true;
+	adaptive = renderSettings.getFramePacing() == RenderSettings::PACING_ADAPTIVE;
+}
+
+bool FramePacer::renderFrame(EmuTime::param time)
+{
+	switch (renderSettings.getFramePacing()) {
+	case RenderSettings::PACING_CLASSIC:
+		return realTime.timeLeft(unsigned(finishFrameDuration), time);
+	case RenderSettings::PACING_ADAPTIVE: {
+		// Predict when this frame will end when it's rendered, and
+		// check that this is still in time.
+		auto cost = emulationDuration + renderDuration + presentDuration;
+		return realTime.timeLeft(uint64_t(cost), time + frameDuration);
+	}
+	default:
+		UNREACHABLE; return true;
+	}
+}
+
+void FramePacer::addFinishTime(uint64_t us)
+{
+	average(finishFrameDuration, float(us));
+	renderTime += us;
+}
+
+void FramePacer::frameEnd(EmuTime::param time, bool rendered, bool presented)
+{
+	if (!started) return;
+	++numFrames;
+	if (!rendered) ++numSkipped;
+	if (!realTime.timeLeft(0, time)) ++numLate;
+	prevRendered = rendered;
+	prevPresented = presented;
+}
+
+void FramePacer::getStats(TclObject& result) const
+{
+	// durations in ms
+	result.addDictKeyValues(
+		"pacing", renderSettings.getFramePacing() == RenderSettings::PACING_ADAPTIVE
+		          ? "adaptive" : "classic",
+		"emulation", emulationDuration / 1000.0f,
+		"render", renderDuration / 1000.0f,
+		"present", presentDuration / 1000.0f,
+		"frames", numFrames,
+		"skipped", numSkipped,
+		"late", numLate);
+}
+
+} // namespace openmsx
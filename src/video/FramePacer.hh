@@ -0,0 +1,100 @@
+#ifndef FRAMEPACER_HH
+#define FRAMEPACER_HH
+
+#include "EmuTime.hh"
+#include <cstdint>
+
+namespace openmsx {
+
+class Display;
+class RealTime;
+class RenderSettings;
+class TclObject;
+
+/** Decides which frames a renderer can skip (frameskip), within the limits
+  * of the minframeskip and maxframeskip settings. Only the rendering of a
+  * frame is skipped, never the emulation.
+  *
+  * In 'classic' mode a frame is rendered when there's still enough real time
+  * left to finish the frame (as measured for the previous frames).
+  *
+  * In 'adaptive' mode the time the host spends on each frame is split into
+  * emulation, rendering (drawing the lines and finishing the frame) and
+  * presenting (repainting the display). A frame is only rendered when the
+  * emulation is predicted to still reach the end of that frame in time, with
+  * all those costs included.
+  *
+  * Each renderer has its own FramePacer. With a V9990 both pacers see the
+  * same host time, so the time spent by one renderer is counted as
+  * emulation time by the other one. That's fine for the prediction: the
+  * other renderer's time is part of the cost of emulating a frame.
+  */
+class FramePacer
+{
+public:
+	FramePacer(RealTime& realTime, Display& display);
+
+	/** Called at the start of each frame, also for skipped frames. */
+	void frameStart(EmuTime::param time);
+
+	/** Should the frame that started at the given time be rendered? */
+	[[nodiscard]] bool renderFrame(EmuTime::param time);
+
+	/** Should the time spent drawing be measured (via addRenderTime())?
+	  * Only the 'adaptive' pacing uses it, so this avoids reading the
+	  * clock for each (partial) frame update in 'classic' mode. */
+	[[nodiscard]] bool measureRenderTime() const { return adaptive; }
+
+	/** Add real time (in us) spent drawing the current frame. */
+	void addRenderTime(uint64_t us) { renderTime += us; }
+
+	/** Add real time (in us) spent finishing the current frame. */
+	void addFinishTime(uint64_t us);
+
+	/** Called at the end of each frame.
+	  * @param time Emulated time at the end of the frame.
+	  * @param rendered Was this frame rendered?
+	  * @param presented Will this frame be shown on the display?
+	  */
+	void frameEnd(EmuTime::param time, bool rendered, bool presented);
+
+	/** Forget the measurements of the current frame, e.g. when the
+	  * renderer was inactive. */
+	void restart() { started = false; }
+
+	/** Statistics as a Tcl dict, for the 'frame_pacing' info topic. */
+	void getStats(TclObject& result) const;
+
+private:
+	RealTime& realTime;
+	Display& display;
+	RenderSettings& renderSettings;
+
+	// Moving averages, in us per frame.
+	float emulationDuration = 0.0f;
+	float renderDuration = 0.0f;  // only for rendered frames
+	float presentDuration = 0.0f; // only for presented frames
+	float finishFrameDuration = 0.0f;
+
+	// Current frame.
+	uint64_t startRealTime = 0;
+	uint64_t startSleepTime = 0;
+	EmuTime startTime = EmuTime::zero();
+	EmuDuration frameDuration = EmuDuration::zero(); // of the last frame
+	uint64_t renderTime = 0;
+	bool started = false;
+	bool adaptive = false; // pacing setting, sampled at the frame start
+
+	// Previous frame, its present time is only known in the next frame.
+	bool prevRendered = false;
+	bool prevPresented = false;
+
+	// Statistics.
+	uint64_t numFrames = 0;
+	uint64_t numSkipped = 0;
+	uint64_t numLate = 0; // frames that ended behind real time
+};
+
+} // namespace openmsx
+
+#endif
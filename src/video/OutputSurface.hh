@@ -9,6 +9,8 @@
 
 namespace openmsx {
 
+class ScreenShotWriter;
+
 /** A frame buffer where pixels can be written to.
   * It could be an in-memory buffer or a video buffer visible to the user
   * (see *OffScreenSurface and *VisibleSurface classes).
@@ -102,7 +104,8 @@ public:
 	/** Save the content of this OutputSurface to a PNG file.
 	  * @throws MSXException If creating the PNG file fails.
 	  */
-	virtual void saveScreenshot(const std::string& filename) = 0;
+	virtual void saveScreenshot(ScreenShotWriter& writer,
+	                            const std::string& filename, bool async) = 0;
 
 protected:
 	OutputSurface() = default;
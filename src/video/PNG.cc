@@ -293,7 +293,8 @@ static void flushData(png_structp ctx)
 }
 
 static void IMG_SavePNG_RW(int width, int height, const void** row_pointers,
-                           const std::string& filename, bool color)
+                           const std::string& filename, bool color,
+                           int compressionLevel = -1)
 {
 	try {
 		File file(filename, File::TRUNCATE);
@@ -315,6 +316,7 @@ static void IMG_SavePNG_RW(int width, int height, const void** row_pointers,
 
 		// Set up the output control.
 		png_set_write_fn(png.ptr, &file, writeData, flushData);
+		png_set_compression_level(png.ptr, compressionLevel);
 
 		// Mark this image as being generated by openMSX and add creation time.
 		std::string version = Version::full();
@@ -362,7 +364,8 @@ static void IMG_SavePNG_RW(int width, int height, const void** row_pointers,
 	}
 }
 
-static void save(SDL_Surface* image, const std::string& filename)
+static void save(SDL_Surface* image, const std::string& filename,
+                 int compressionLevel)
 {
 	SDLAllocFormatPtr frmt24(SDL_AllocFormat(
 		OPENMSX_BIGENDIAN ? SDL_PIXELFORMAT_BGR24 : SDL_PIXELFORMAT_RGB24));
@@ -374,11 +377,13 @@ static void save(SDL_Surface* image, const std::string& filename)
 		row_pointers[i] = surf24.getLinePtr(i);
 	}
 
-	IMG_SavePNG_RW(image->w, image->h, row_pointers, filename, true);
+	IMG_SavePNG_RW(image->w, image->h, row_pointers, filename, true,
+	               compressionLevel);
 }
 
 void save(unsigned width, unsigned height, const void** rowPointers,
-          const PixelFormat& format, const std::string& filename)
+          const PixelFormat& format, const std::string& filename,
+          int compressionLevel)
 {
 	// this implementation creates 1 extra copy, can be optimized if required
 	SDLSurfacePtr surface(
@@ -388,13 +393,14 @@ void save(unsigned width, unsigned height, const void** rowPointers,
 		memcpy(surface.getLinePtr(y),
 		       rowPointers[y], width * format.getBytesPerPixel());
 	}
-	save(surface.get(), filename);
+	save(surface.get(), filename, compressionLevel);
 }
 
-void save(unsigned width, unsigned height,
-          const void** rowPointers, const std::string& filename)
+void save(unsigned width, unsigned height, const void** rowPointers,
+          const std::string& filename, int compressionLevel)
 {
-	IMG_SavePNG_RW(width, height, rowPointers, filename, true);
+	IMG_SavePNG_RW(width, height, rowPointers, filename, true,
+	               compressionLevel);
 }
 
 void saveGrayscale(unsigned width, unsigned height,
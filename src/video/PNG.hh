@@ -16,10 +16,15 @@ namespace openmsx::PNG {
 	 */
 	SDLSurfacePtr load(const std::string& filename, bool want32bpp);
 
+	/** Save an image, either in the given pixel format or (second
+	 * version) as 24bpp RGB. The compression level is passed to zlib, so
+	 * it's in range [0..9], -1 selects the zlib default.
+	 */
 	void save(unsigned width, unsigned height, const void** rowPointers,
-	          const PixelFormat& format, const std::string& filename);
+	          const PixelFormat& format, const std::string& filename,
+	          int compressionLevel = -1);
 	void save(unsigned width, unsigned height, const void** rowPointers,
-	          const std::string& filename);
+	          const std::string& filename, int compressionLevel = -1);
 	void saveGrayscale(unsigned width, unsigned height,
 	                   const void** rowPointers, const std::string& filename);
 
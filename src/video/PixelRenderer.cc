@@ -19,7 +19,9 @@ TODO:
 #include "RealTime.hh"
 #include "MSXMotherBoard.hh"
 #include "Reactor.hh"
+#include "TclObject.hh"
 #include "Timer.hh"
+#include "outer.hh"
 #include "unreachable.hh"
 #include <algorithm>
 #include <cassert>
@@ -112,6 +114,8 @@ PixelRenderer::PixelRenderer(VDP& vdp_, Display& display)
 	, videoSourceSetting(vdp.getMotherBoard().getVideoSource())
 	, spriteChecker(vdp.getSpriteChecker())
 	, rasterizer(display.getVideoSystem().createRasterizer(vdp))
+	, framePacer(realTime, display)
+	, framePacingInfo(vdp.getMotherBoard().getMachineInfoCommand())
 {
 	// In case of loadstate we can't yet query any state from the VDP
 	// (because that object is not yet fully deserialized). But
@@ -119,7 +123,6 @@ PixelRenderer::PixelRenderer(VDP& vdp_, Display& display)
 	// safe to query.
 	reInit();
 
-	finishFrameDuration = 0;
 	frameSkipCounter = 999; // force drawing of frame
 	prevRenderFrame = false;
 
@@ -144,6 +147,7 @@ void PixelRenderer::reInit()
 	// This for example can happen after a loadstate or after switching
 	// renderer in the middle of a frame.
 	renderFrame = false;
+	framePacer.restart();
 
 	rasterizer->reset();
 	displayEnabled = vdp.isDisplayEnabled();
@@ -161,8 +165,10 @@ void PixelRenderer::frameStart(EmuTime::param time)
 		frameSkipCounter = 999;
 		renderFrame = false;
 		prevRenderFrame = false;
+		framePacer.restart();
 		return;
 	}
+	framePacer.frameStart(time);
 	prevRenderFrame = renderFrame;
 	if (vdp.isInterlaced() && renderSettings.getDeinterlace() &&
 	    vdp.getEvenOdd() && vdp.isEvenOddEnabled()) {
@@ -179,8 +185,7 @@ void PixelRenderer::frameStart(EmuTime::param time)
 			if (rasterizer->isRecording()) {
 				renderFrame = true;
 			} else {
-				renderFrame = realTime.timeLeft(
-					unsigned(finishFrameDuration), time);
+				renderFrame = framePacer.renderFrame(time);
 			}
 			if (renderFrame) {
 				frameSkipCounter = 0;
@@ -211,10 +216,7 @@ void PixelRenderer::frameEnd(EmuTime::param time)
 		auto time1 = Timer::getTime();
 		rasterizer->frameEnd();
 		auto time2 = Timer::getTime();
-		auto current = time2 - time1;
-		const float ALPHA = 0.2f;
-		finishFrameDuration = finishFrameDuration * (1 - ALPHA) +
-		                      current * ALPHA;
+		framePacer.addFinishTime(time2 - time1);
 
 		if (vdp.isInterlaced() && vdp.isEvenOddEnabled() &&
 		    renderSettings.getDeinterlace() &&
@@ -224,14 +226,17 @@ void PixelRenderer::frameEnd(EmuTime::param time)
 			skipEvent = true;
 		}
 	}
+	bool presented = false;
 	if (vdp.getMotherBoard().isActive() &&
 	    !vdp.getMotherBoard().isFastForwarding()) {
-		eventDistributor.distributeEvent(
-			std::make_shared<FinishFrameEvent>(
-				rasterizer->getPostProcessor()->getVideoSource(),
-				videoSourceSetting.getSource(),
-				skipEvent));
+		auto event = std::make_shared<FinishFrameEvent>(
+			rasterizer->getPostProcessor()->getVideoSource(),
+			videoSourceSetting.getSource(),
+			skipEvent);
+		presented = event->needRender();
+		eventDistributor.distributeEvent(std::move(event));
 	}
+	framePacer.frameEnd(time, renderFrame, presented);
 }
 
 void PixelRenderer::updateHorizontalScrollLow(
@@ -567,6 +572,8 @@ void PixelRenderer::renderUntil(EmuTime::param time)
 	// Also it is a small performance optimisation.
 	if (limitX == nextX && limitY == nextY) return;
 
+	bool measure = framePacer.measureRenderTime();
+	auto startTime = measure ? Timer::getTime() : 0;
 	if (displayEnabled) {
 		if (vdp.spritesEnabled()) {
 			// Update sprite checking, so that rasterizer can call getSprites.
@@ -602,6 +609,7 @@ void PixelRenderer::renderUntil(EmuTime::param time)
 
 	nextX = limitX;
 	nextY = limitY;
+	if (measure) framePacer.addRenderTime(Timer::getTime() - startTime);
 }
 
 void PixelRenderer::update(const Setting& setting)
@@ -615,4 +623,29 @@ void PixelRenderer::update(const Setting& setting)
 	}
 }
 
+
+// class FramePacingInfoTopic
+
+PixelRenderer::FramePacingInfoTopic::FramePacingInfoTopic(
+		InfoCommand& machineInfoCommand)
+	: InfoTopic(machineInfoCommand, "frame_pacing")
+{
+}
+
+void PixelRenderer::FramePacingInfoTopic::execute(
+	span<const TclObject> /*tokens*/, TclObject& result) const
+{
+	auto& renderer = OUTER(PixelRenderer, framePacingInfo);
+	renderer.framePacer.getStats(result);
+}
+
+std::string PixelRenderer::FramePacingInfoTopic::help(
+	const std::vector<std::string>& /*tokens*/) const
+{
+	return "Returns frame pacing statistics of the MSX video output: the "
+	       "average emulation, render and present time per frame (in ms) "
+	       "and the number of frames, skipped frames and frames that "
+	       "ended behind real time.";
+}
+
 } // namespace openmsx
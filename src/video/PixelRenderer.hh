@@ -2,10 +2,14 @@
 #define PIXELRENDERER_HH
 
 #include "Renderer.hh"
+#include "FramePacer.hh"
+#include "InfoTopic.hh"
 #include "Observer.hh"
 #include "RenderSettings.hh"
 #include "openmsx.hh"
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace openmsx {
 
@@ -118,9 +122,16 @@ private:
 
 	const std::unique_ptr<Rasterizer> rasterizer;
 
-	float finishFrameDuration;
+	FramePacer framePacer;
 	int frameSkipCounter;
 
+	struct FramePacingInfoTopic final : InfoTopic {
+		explicit FramePacingInfoTopic(InfoCommand& machineInfoCommand);
+		void execute(span<const TclObject> tokens,
+		             TclObject& result) const override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+	} framePacingInfo;
+
 	/** Number of the next position within a line to render.
 	  * Expressed in VDP clock ticks since start of line.
 	  */
@@ -5,10 +5,11 @@
 #include "DoubledFrame.hh"
 #include "Deflicker.hh"
 #include "SuperImposedFrame.hh"
-#include "PNG.hh"
+#include "ScreenShotWriter.hh"
 #include "RenderSettings.hh"
 #include "RawFrame.hh"
 #include "AviRecorder.hh"
+#include "RawFrameRecorder.hh"
 #include "CliComm.hh"
 #include "MSXMotherBoard.hh"
 #include "Reactor.hh"
@@ -35,6 +36,7 @@ PostProcessor::PostProcessor(MSXMotherBoard& motherBoard_,
 	, screen(screen_)
 	, paintFrame(nullptr)
 	, recorder(nullptr)
+	, rawRecorder(nullptr)
 	, superImposeVideoFrame(nullptr)
 	, superImposeVdpFrame(nullptr)
 	, interleaveCount(0)
@@ -73,6 +75,13 @@ PostProcessor::~PostProcessor()
 			"during recording.");
 		recorder->stop();
 	}
+	if (rawRecorder) {
+		getCliComm().printWarning(
+			"Frame recording stopped, because you "
+			"changed machine or changed a video setting "
+			"during recording.");
+		rawRecorder->stop();
+	}
 }
 
 CliComm& PostProcessor::getCliComm()
@@ -134,6 +143,19 @@ std::unique_ptr<RawFrame> PostProcessor::rotateFrames(
 	                   lastFrames + recycleIdx + 1);
 	lastFrames[0] = std::move(finishedFrame);
 
+	// Possibly record the raw (unprocessed) frame
+	if (rawRecorder && needRecord()) {
+		try {
+			rawRecorder->addFrame(*lastFrames[0], time);
+		} catch (MSXException& e) {
+			getCliComm().printWarning(
+				"Frame recording stopped with error: " +
+				e.getMessage());
+			rawRecorder->stop();
+			assert(!rawRecorder);
+		}
+	}
+
 	// Are enough frames available?
 	if (lastFramesCount >= numRequired) {
 		// Only the last 'numRequired' are kept up to date.
@@ -254,7 +276,9 @@ static void getScaledFrame(FrameSource& paintFrame, unsigned bpp,
 	}
 }
 
-void PostProcessor::takeRawScreenShot(unsigned height2, const std::string& filename)
+void PostProcessor::takeRawScreenShot(
+	unsigned height2, ScreenShotWriter& writer, const std::string& filename,
+	bool async)
 {
 	if (!paintFrame) {
 		throw CommandException("TODO");
@@ -264,7 +288,8 @@ void PostProcessor::takeRawScreenShot(unsigned height2, const std::string& filen
 	WorkBuffer workBuffer;
 	getScaledFrame(*paintFrame, getBpp(), height2, lines, workBuffer);
 	unsigned width = (height2 == 240) ? 320 : 640;
-	PNG::save(width, height2, lines, paintFrame->getPixelFormat(), filename);
+	writer.save(width, height2, lines, paintFrame->getPixelFormat(), filename,
+	            async);
 }
 
 unsigned PostProcessor::getBpp() const
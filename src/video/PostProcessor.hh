@@ -17,6 +17,7 @@ class DoubledFrame;
 class EventDistributor;
 class FrameSource;
 class RawFrame;
+class RawFrameRecorder;
 class RenderSettings;
 class SuperImposedFrame;
 
@@ -70,10 +71,19 @@ public:
 	  */
 	void setRecorder(AviRecorder* recorder_) { recorder = recorder_; }
 
-	/** Is recording active.
+	/** Is recording (video or raw frames) active.
 	  * ATM used to keep frameskip constant during recording.
 	  */
-	bool isRecording() const { return recorder != nullptr; }
+	bool isRecording() const { return recorder || rawRecorder; }
+
+	/** Start/stop recording of the unscaled frames.
+	  * @param rawRecorder_ Each finished frame (the RawFrame, so before
+	  *                     deinterlace, deflicker, ...) is pushed to this
+	  *                     RawFrameRecorder. Or nullptr to stop recording.
+	  */
+	void setRawFrameRecorder(RawFrameRecorder* rawRecorder_) {
+		rawRecorder = rawRecorder_;
+	}
 
 	/** Get the number of bits per pixel for the pixels in these frames.
 	  * @return Possible values are 15, 16 or 32
@@ -87,7 +97,8 @@ public:
 	FrameSource* getPaintFrame() const { return paintFrame; }
 
 	// VideoLayer
-	void takeRawScreenShot(unsigned height, const std::string& filename) override;
+	void takeRawScreenShot(unsigned height, ScreenShotWriter& writer,
+	                       const std::string& filename, bool async) override;
 
 
 	CliComm& getCliComm();
@@ -132,6 +143,9 @@ protected:
 	/** Video recorder, nullptr when not recording. */
 	AviRecorder* recorder;
 
+	/** Raw frame recorder, nullptr when not recording. */
+	RawFrameRecorder* rawRecorder;
+
 	/** Video frame on which to superimpose the (VDP) output.
 	  * nullptr when not superimposing. */
 	const RawFrame* superImposeVideoFrame;
@@ -0,0 +1,266 @@
+#include "RawFrameRecorder.hh"
+#include "CommandException.hh"
+#include "Display.hh"
+#include "FileContext.hh"
+#include "FileOperations.hh"
+#include "MSXMotherBoard.hh"
+#include "PostProcessor.hh"
+#include "RawFrame.hh"
+#include "Reactor.hh"
+#include "TclArgParser.hh"
+#include "TclObject.hh"
+#include "outer.hh"
+#include "strCat.hh"
+#include "xrange.hh"
+#include "xxhash.hh"
+#include <cassert>
+#include <cstring>
+
+using std::string;
+using std::vector;
+
+namespace openmsx {
+
+constexpr char MAGIC[16] = {'o','p','e','n','M','S','X',' ','f','r','a','m','e','s',' ','1'};
+constexpr uint16_t SAME_AS_PREVIOUS = 0x8000;
+
+RawFrameRecorder::RawFrameRecorder(Reactor& reactor_)
+	: reactor(reactor_)
+	, recordCommand(reactor.getCommandController())
+{
+}
+
+RawFrameRecorder::~RawFrameRecorder()
+{
+	assert(!file);
+}
+
+void RawFrameRecorder::start(Mode mode_, const string& filename_)
+{
+	stop();
+	if (!reactor.getMotherBoard()) {
+		throw CommandException("No active MSX machine.");
+	}
+	// Like for the 'record' command: set all V99x8, V9990, Laserdisc
+	// layers in record mode, only the active one actually sends frames.
+	vector<PostProcessor*> pps;
+	for (auto* l : reactor.getDisplay().getAllLayers()) {
+		if (auto* pp = dynamic_cast<PostProcessor*>(l)) {
+			pps.push_back(pp);
+		}
+	}
+	if (pps.empty()) {
+		throw CommandException(
+			"Current renderer doesn't support frame recording.");
+	}
+
+	try {
+		file = std::make_unique<File>(filename_, File::TRUNCATE);
+	} catch (MSXException& e) {
+		throw CommandException("Can't start recording: ", e.getMessage());
+	}
+	mode = mode_;
+	filename = filename_;
+	bytesPerPixel = 0; // header is written together with the first frame
+	numFrames = 0;
+	lastHash = 0;
+	prevWidths.clear();
+	prevPixels.clear();
+	prevPitch = 0;
+
+	postProcessors = std::move(pps);
+	for (auto* pp : postProcessors) {
+		pp->setRawFrameRecorder(this);
+	}
+}
+
+void RawFrameRecorder::stop()
+{
+	for (auto* pp : postProcessors) {
+		pp->setRawFrameRecorder(nullptr);
+	}
+	postProcessors.clear();
+	file.reset();
+	prevPixels = {}; // free memory
+	prevWidths = {};
+}
+
+uint32_t RawFrameRecorder::hashFrame(RawFrame& frame)
+{
+	auto bpp = frame.getPixelFormat().getBytesPerPixel();
+	vector<uint32_t> lineHashes;
+	lineHashes.reserve(2 * frame.getHeight());
+	for (auto y : xrange(frame.getHeight())) {
+		auto width = frame.getLineWidthDirect(y);
+		auto* pixels = frame.getLinePtrDirect<char>(y);
+		lineHashes.push_back(width);
+		lineHashes.push_back(xxhash(std::string_view(pixels, width * bpp)));
+	}
+	return xxhash(std::string_view(
+		reinterpret_cast<const char*>(lineHashes.data()),
+		lineHashes.size() * sizeof(uint32_t)));
+}
+
+void RawFrameRecorder::addFrame(RawFrame& frame, EmuTime::param time)
+{
+	assert(file);
+	const auto& format = frame.getPixelFormat();
+	if (bytesPerPixel == 0) {
+		bytesPerPixel = format.getBytesPerPixel();
+		if (mode != HASH) {
+			file->write(MAGIC, sizeof(MAGIC));
+			uint32_t header[4] = {
+				bytesPerPixel, format.getRmask(),
+				format.getGmask(), format.getBmask()
+			};
+			file->write(header, sizeof(header));
+		}
+	} else if (format.getBytesPerPixel() != bytesPerPixel) {
+		throw MSXException("Pixel format changed.");
+	}
+	if (mode == HASH) {
+		lastHash = hashFrame(frame);
+		uint64_t ticks = (time - EmuTime::zero()).length();
+		string line = strCat(ticks, ' ', hex_string<8>(lastHash), '\n');
+		file->write(line.data(), line.size());
+	} else {
+		writeRaw(frame, time);
+	}
+	++numFrames;
+}
+
+void RawFrameRecorder::writeRaw(RawFrame& frame, EmuTime::param time)
+{
+	unsigned height = frame.getHeight();
+	uint64_t ticks = (time - EmuTime::zero()).length();
+	uint16_t info[2] = { uint16_t(height), uint16_t(frame.getField()) };
+	file->write(&ticks, sizeof(ticks));
+	file->write(info, sizeof(info));
+
+	bool delta = mode == DELTA;
+	size_t pitch = frame.getRowLength() * bytesPerPixel;
+	if (delta && ((prevWidths.size() != height) || (prevPitch != pitch))) {
+		// first frame or size changed: no previous frame to compare with
+		prevWidths.assign(height, 0);
+		prevPixels.resize(height * pitch);
+		prevPitch = pitch;
+	}
+	for (auto y : xrange(height)) {
+		auto width = uint16_t(frame.getLineWidthDirect(y));
+		auto* pixels = frame.getLinePtrDirect<uint8_t>(y);
+		size_t size = width * bytesPerPixel;
+		if (delta) {
+			auto* prev = &prevPixels[y * pitch];
+			if ((prevWidths[y] == width) && (memcmp(prev, pixels, size) == 0)) {
+				uint16_t ref = width | SAME_AS_PREVIOUS;
+				file->write(&ref, sizeof(ref));
+				continue;
+			}
+			prevWidths[y] = width;
+			memcpy(prev, pixels, size);
+		}
+		file->write(&width, sizeof(width));
+		file->write(pixels, size);
+	}
+}
+
+void RawFrameRecorder::processStart(
+	Interpreter& interp, span<const TclObject> tokens, TclObject& result)
+{
+	std::string_view prefix = "openmsx";
+	bool delta = false;
+	bool hash = false;
+	ArgsInfo info[] = {
+		valueArg("-prefix", prefix),
+		flagArg("-delta", delta),
+		flagArg("-hash", hash),
+	};
+	auto arguments = parseTclArgs(interp, tokens.subspan(2), info);
+	if (delta && hash) {
+		throw CommandException("Can't have both -delta and -hash.");
+	}
+	std::string_view filenameArg;
+	switch (arguments.size()) {
+	case 0:
+		// nothing
+		break;
+	case 1:
+		filenameArg = arguments[0].getString();
+		break;
+	default:
+		throw SyntaxError();
+	}
+	string fname = FileOperations::parseCommandFileArgument(
+		filenameArg, "videos", prefix, hash ? ".hashes" : ".frames");
+
+	if (file) {
+		result = "Already recording.";
+	} else {
+		start(hash ? HASH : (delta ? DELTA : RAW), fname);
+		result = "Recording to " + fname;
+	}
+}
+
+void RawFrameRecorder::status(TclObject& result) const
+{
+	result.addDictKeyValue("status", file ? "recording" : "idle");
+	if (file) {
+		result.addDictKeyValue("filename", filename);
+		result.addDictKeyValue("frames", numFrames);
+		if (mode == HASH) {
+			result.addDictKeyValue("last_hash", strCat(hex_string<8>(lastHash)));
+		}
+	}
+}
+
+// class RawFrameRecorder::Cmd
+
+RawFrameRecorder::Cmd::Cmd(CommandController& commandController_)
+	: Command(commandController_, "record_frames")
+{
+}
+
+void RawFrameRecorder::Cmd::execute(span<const TclObject> tokens, TclObject& result)
+{
+	if (tokens.size() < 2) {
+		throw CommandException("Missing argument");
+	}
+	auto& recorder = OUTER(RawFrameRecorder, recordCommand);
+	executeSubCommand(tokens[1].getString(),
+		"start",  [&]{ recorder.processStart(getInterpreter(), tokens, result); },
+		"stop",   [&]{
+			checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+			recorder.stop(); },
+		"status", [&]{
+			checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+			recorder.status(result); });
+}
+
+string RawFrameRecorder::Cmd::help(const vector<string>& /*tokens*/) const
+{
+	return "Records the unscaled MSX frames, e.g. for automated tests.\n"
+	       "record_frames start              Record to file 'openmsxNNNN.frames'\n"
+	       "record_frames start <filename>   Record to given file\n"
+	       "record_frames start -prefix foo  Record to file 'fooNNNN.frames'\n"
+	       "record_frames start -delta       Don't store lines that didn't change\n"
+	       "record_frames start -hash        Only store a hash per frame (text file)\n"
+	       "record_frames stop               Stop recording\n"
+	       "record_frames status             Query recording state\n";
+}
+
+void RawFrameRecorder::Cmd::tabCompletion(vector<string>& tokens) const
+{
+	if (tokens.size() == 2) {
+		static constexpr const char* const cmds[] = {
+			"start", "stop", "status",
+		};
+		completeString(tokens, cmds);
+	} else if ((tokens.size() >= 3) && (tokens[1] == "start")) {
+		static constexpr const char* const options[] = {
+			"-prefix", "-delta", "-hash",
+		};
+		completeFileName(tokens, userFileContext(), options);
+	}
+}
+
+} // namespace openmsx
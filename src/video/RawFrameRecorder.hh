@@ -0,0 +1,92 @@
+#ifndef RAWFRAMERECORDER_HH
+#define RAWFRAMERECORDER_HH
+
+#include "Command.hh"
+#include "EmuTime.hh"
+#include "File.hh"
+#include "span.hh"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+class Interpreter;
+class PostProcessor;
+class RawFrame;
+class Reactor;
+class TclObject;
+
+/** Records the unscaled (raw) MSX frames, meant for automated tests.
+ *
+ * Unlike the 'record' command (AviRecorder) no scaling or image encoding is
+ * done: the frames are stored exactly as the renderer produced them (pixels
+ * in the host pixel format, per line the actual width). Alternatively only a
+ * hash per frame is stored, which is enough to check that the emulated
+ * output didn't change.
+ *
+ * Layout of the 'raw' file (all integers in host byte order):
+ *   char     magic[16]    "openMSX frames 1"
+ *   uint32   bytesPerPixel
+ *   uint32   Rmask, Gmask, Bmask
+ *   frame    frames[]     (till end of file)
+ * with
+ *   frame:   uint64 time (EmuTime ticks), uint16 height, uint16 field,
+ *            line lines[height]
+ *   line:    uint16 width, followed by 'width' pixels. In delta mode bit 15
+ *            of 'width' can be set, then the line is identical to the same
+ *            line in the previous frame and no pixels follow.
+ *
+ * The 'hash' file is a text file with one line per frame: the emulated time
+ * of the frame (EmuTime ticks) and the (32-bit, hex) hash of all lines
+ * (pixels and widths) of that frame.
+ * Note that the pixel format (so also the hash) depends on the renderer.
+ */
+class RawFrameRecorder
+{
+public:
+	explicit RawFrameRecorder(Reactor& reactor);
+	~RawFrameRecorder();
+
+	void addFrame(RawFrame& frame, EmuTime::param time);
+	void stop();
+
+	/** Hash of all lines (width and pixels) of the given frame. */
+	[[nodiscard]] static uint32_t hashFrame(RawFrame& frame);
+
+private:
+	enum Mode { RAW, DELTA, HASH };
+
+	void start(Mode mode, const std::string& filename);
+	void writeRaw(RawFrame& frame, EmuTime::param time);
+	void processStart(Interpreter& interp, span<const TclObject> tokens,
+	                  TclObject& result);
+	void status(TclObject& result) const;
+
+	Reactor& reactor;
+
+	struct Cmd final : Command {
+		explicit Cmd(CommandController& commandController);
+		void execute(span<const TclObject> tokens, TclObject& result) override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	} recordCommand;
+
+	std::unique_ptr<File> file; // nullptr when not recording
+	std::vector<PostProcessor*> postProcessors;
+	std::string filename;
+	Mode mode = RAW;
+	uint64_t numFrames = 0;
+	uint32_t lastHash = 0;
+	unsigned bytesPerPixel = 0;
+
+	// previous frame, only used in delta mode
+	std::vector<uint8_t> prevPixels; // 'prevPitch' bytes per line
+	std::vector<uint16_t> prevWidths;
+	size_t prevPitch = 0;
+};
+
+} // namespace openmsx
+
+#endif
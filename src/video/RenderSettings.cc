@@ -67,6 +67,19 @@ RenderSettings::RenderSettings(CommandController& commandController)
 	, minFrameSkipSetting(commandController,
 		"minframeskip", "set the min amount of frameskip", 0, 0, 100)
 
+	, framePacingSetting(commandController,
+		"frame_pacing", "how to decide which frames are skipped "
+		"(between minframeskip and maxframeskip):\n"
+		" classic  -> skip when the previous frames took too long to "
+		"finish\n"
+		" adaptive -> measure the emulation, render and present time "
+		"of each frame and only skip the rendering of frames that "
+		"would otherwise make the emulation fall behind",
+		PACING_CLASSIC,
+		EnumSetting<FramePacing>::Map{
+			{"classic",  PACING_CLASSIC},
+			{"adaptive", PACING_ADAPTIVE}})
+
 	, fullScreenSetting(commandController,
 		"fullscreen", "full screen display on/off", false)
 
@@ -43,6 +43,10 @@ public:
 		DEFORM_NORMAL, DEFORM_3D
 	};
 
+	/** How to decide which frames can be skipped (see FramePacer).
+	  */
+	enum FramePacing { PACING_CLASSIC, PACING_ADAPTIVE };
+
 	explicit RenderSettings(CommandController& commandController);
 	~RenderSettings();
 
@@ -63,6 +67,9 @@ public:
 	IntegerSetting& getMinFrameSkipSetting() { return minFrameSkipSetting; }
 	int getMinFrameSkip() const { return minFrameSkipSetting.getInt(); }
 
+	/** Frame pacing [classic, adaptive]. */
+	FramePacing getFramePacing() const { return framePacingSetting.getEnum(); }
+
 	/** Full screen [on, off]. */
 	BooleanSetting& getFullScreenSetting() { return fullScreenSetting; }
 	bool getFullScreen() const { return fullScreenSetting.getBoolean(); }
@@ -204,6 +211,7 @@ private:
 	BooleanSetting deflickerSetting;
 	IntegerSetting maxFrameSkipSetting;
 	IntegerSetting minFrameSkipSetting;
+	EnumSetting<FramePacing> framePacingSetting;
 	BooleanSetting fullScreenSetting;
 	FloatSetting gammaSetting;
 	FloatSetting brightnessSetting;
@@ -25,9 +25,10 @@ SDLGLOffScreenSurface::SDLGLOffScreenSurface(const OutputSurface& output)
 	setOpenGlPixelFormat();
 }
 
-void SDLGLOffScreenSurface::saveScreenshot(const std::string& filename)
+void SDLGLOffScreenSurface::saveScreenshot(
+	ScreenShotWriter& writer, const std::string& filename, bool async)
 {
-	SDLGLVisibleSurface::saveScreenshotGL(*this, filename);
+	SDLGLVisibleSurface::saveScreenshotGL(*this, writer, filename, async);
 }
 
 } // namespace openmsx
@@ -18,7 +18,8 @@ public:
 
 private:
 	// OutputSurface
-	void saveScreenshot(const std::string& filename) override;
+	void saveScreenshot(ScreenShotWriter& writer,
+	                    const std::string& filename, bool async) override;
 
 	gl::Texture fboTex;
 	gl::FrameBufferObject fbo;
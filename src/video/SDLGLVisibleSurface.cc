@@ -4,7 +4,7 @@
 #include "GLSnow.hh"
 #include "OSDConsoleRenderer.hh"
 #include "OSDGUILayer.hh"
-#include "PNG.hh"
+#include "ScreenShotWriter.hh"
 #include "build-info.hh"
 #include "MemBuffer.hh"
 #include "vla.hh"
@@ -87,13 +87,15 @@ SDLGLVisibleSurface::~SDLGLVisibleSurface()
 	SDL_GL_DeleteContext(glContext);
 }
 
-void SDLGLVisibleSurface::saveScreenshot(const std::string& filename)
+void SDLGLVisibleSurface::saveScreenshot(
+	ScreenShotWriter& writer, const std::string& filename, bool async)
 {
-	saveScreenshotGL(*this, filename);
+	saveScreenshotGL(*this, writer, filename, async);
 }
 
 void SDLGLVisibleSurface::saveScreenshotGL(
-	const OutputSurface& output, const std::string& filename)
+	const OutputSurface& output, ScreenShotWriter& writer,
+	const std::string& filename, bool async)
 {
 	auto [x, y] = output.getViewOffset();
 	auto [w, h] = output.getViewSize();
@@ -104,7 +106,7 @@ void SDLGLVisibleSurface::saveScreenshotGL(
 		rowPointers[h - 1 - i] = &buffer[w * 3 * i];
 	}
 	glReadPixels(x, y, w, h, GL_RGB, GL_UNSIGNED_BYTE, buffer.data());
-	PNG::save(w, h, rowPointers, filename);
+	writer.save(w, h, rowPointers, filename, async);
 }
 
 void SDLGLVisibleSurface::finish()
@@ -20,10 +20,12 @@ public:
 	~SDLGLVisibleSurface() override;
 
 	static void saveScreenshotGL(const OutputSurface& output,
-	                             const std::string& filename);
+	                             ScreenShotWriter& writer,
+	                             const std::string& filename, bool async);
 
 	// OutputSurface
-	void saveScreenshot(const std::string& filename) override;
+	void saveScreenshot(ScreenShotWriter& writer,
+	                    const std::string& filename, bool async) override;
 
 	// VisibleSurface
 	void finish() override;
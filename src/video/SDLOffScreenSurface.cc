@@ -35,9 +35,10 @@ SDLOffScreenSurface::SDLOffScreenSurface(const SDL_Surface& proto)
 	setSDLRenderer(renderer.get());
 }
 
-void SDLOffScreenSurface::saveScreenshot(const std::string& filename)
+void SDLOffScreenSurface::saveScreenshot(
+	ScreenShotWriter& writer, const std::string& filename, bool async)
 {
-	SDLVisibleSurface::saveScreenshotSDL(*this, filename);
+	SDLVisibleSurface::saveScreenshotSDL(*this, writer, filename, async);
 }
 
 void SDLOffScreenSurface::clearScreen()
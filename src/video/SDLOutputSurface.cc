@@ -11,11 +11,21 @@ SDLDirectPixelAccess::SDLDirectPixelAccess(SDL_Surface* surface_)
 		// Note: we ignore the return value from SDL_LockSurface()
 		SDL_LockSurface(surface);
 	}
+	pixels = static_cast<char*>(surface->pixels);
+	pitch = surface->pitch;
+}
+
+SDLDirectPixelAccess::SDLDirectPixelAccess(void* pixels_, int pitch_)
+	: surface(nullptr)
+	, pixels(static_cast<char*>(pixels_))
+	, pitch(pitch_)
+{
+	assert(pixels);
 }
 
 SDLDirectPixelAccess::~SDLDirectPixelAccess()
 {
-	if (SDL_MUSTLOCK(surface)) {
+	if (surface && SDL_MUSTLOCK(surface)) {
 		SDL_UnlockSurface(surface);
 	}
 }
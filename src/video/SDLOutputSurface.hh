@@ -11,15 +11,19 @@ class SDLDirectPixelAccess
 {
 public:
 	SDLDirectPixelAccess(SDL_Surface* surface_);
+	/** Access to pixels that are already locked (e.g. a texture). */
+	SDLDirectPixelAccess(void* pixels_, int pitch_);
 	~SDLDirectPixelAccess();
 
 	template<typename Pixel>
 	Pixel* getLinePtr(unsigned y) {
-		return reinterpret_cast<Pixel*>(static_cast<char*>(surface->pixels) + y * surface->pitch);
+		return reinterpret_cast<Pixel*>(pixels + y * pitch);
 	}
 
 private:
-	SDL_Surface* surface;
+	SDL_Surface* surface; // nullptr when there's nothing to unlock
+	char* pixels;
+	int pitch;
 };
 
 /** A frame buffer where pixels can be written to.
@@ -48,9 +52,22 @@ public:
 	 */
 	SDLDirectPixelAccess getDirectPixelAccess()
 	{
+		if (lockedPixels) {
+			return SDLDirectPixelAccess(lockedPixels, lockedPitch);
+		}
 		return SDLDirectPixelAccess(getSDLSurface());
 	}
 
+	/** Called before a complete new frame is written via
+	  * getDirectPixelAccess(), flushFrameBuffer() ends the frame.
+	  * @param writeOnly The pixels will only be written, never read
+	  *        back. This allows to write directly into the display
+	  *        buffer, which can be slow to read from, so that
+	  *        flushFrameBuffer() doesn't need to copy them.
+	  * The default implementation does nothing.
+	  */
+	virtual void beginFrame(bool /*writeOnly*/) {}
+
 	/** Copy frame buffer to display buffer.
 	  * The default implementation does nothing.
 	  */
@@ -68,9 +85,19 @@ protected:
 	void setSDLSurface(SDL_Surface* surface_) { surface = surface_; }
 	void setSDLRenderer(SDL_Renderer* r) { renderer = r; }
 
+	/** While set, getDirectPixelAccess() gives access to these pixels
+	  * instead of the SDL surface. */
+	void setLockedPixels(void* pixels, int pitch) {
+		lockedPixels = pixels;
+		lockedPitch = pitch;
+	}
+	[[nodiscard]] bool hasLockedPixels() const { return lockedPixels != nullptr; }
+
 private:
 	SDL_Surface* surface = nullptr;
 	SDL_Renderer* renderer = nullptr;
+	void* lockedPixels = nullptr;
+	int lockedPitch = 0;
 };
 
 } // namespace openmsx
@@ -4,7 +4,6 @@
 #include "build-info.hh"
 #include "checked_cast.hh"
 #include "random.hh"
-#include <cstring>
 #include <cstdint>
 
 namespace openmsx {
@@ -27,16 +26,19 @@ void SDLSnow<Pixel>::paint(OutputSurface& output_)
 	std::uniform_int_distribution<int> distribution(0, 255);
 
 	auto& output = checked_cast<SDLOutputSurface&>(output_);
+	output.beginFrame(true);
 	{
 		auto pixelAccess = output.getDirectPixelAccess();
 		auto [width, height] = output.getLogicalSize();
 		for (int y = 0; y < height; y += 2) {
 			auto* p0 = pixelAccess.getLinePtr<Pixel>(y + 0);
 			auto* p1 = pixelAccess.getLinePtr<Pixel>(y + 1);
+			// Write both lines (don't copy p0 to p1), the pixels
+			// may not be read back (see beginFrame()).
 			for (int x = 0; x < width; x += 2) {
-				p0[x + 0] = p0[x + 1] = gray[distribution(generator)];
+				p0[x + 0] = p0[x + 1] =
+				p1[x + 0] = p1[x + 1] = gray[distribution(generator)];
 			}
-			memcpy(p1, p0, width * sizeof(Pixel));
 		}
 	}
 	output.flushFrameBuffer();
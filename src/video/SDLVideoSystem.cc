@@ -218,11 +218,13 @@ void SDLVideoSystem::flush()
 	screen->finish();
 }
 
-void SDLVideoSystem::takeScreenShot(const std::string& filename, bool withOsd)
+void SDLVideoSystem::takeScreenShot(
+	ScreenShotWriter& writer, const std::string& filename, bool withOsd,
+	bool async)
 {
 	if (withOsd) {
 		// we can directly save current content as screenshot
-		screen->saveScreenshot(filename);
+		screen->saveScreenshot(writer, filename, async);
 	} else {
 		// we first need to re-render to an off-screen surface
 		// with OSD layers disabled
@@ -230,7 +232,7 @@ void SDLVideoSystem::takeScreenShot(const std::string& filename, bool withOsd)
 		ScopedLayerHider hideOsd(*osdGuiLayer);
 		std::unique_ptr<OutputSurface> surf = screen->createOffScreenSurface();
 		display.repaint(*surf);
-		surf->saveScreenshot(filename);
+		surf->saveScreenshot(writer, filename, async);
 	}
 }
 
@@ -41,7 +41,9 @@ public:
 #endif
 	bool checkSettings() override;
 	void flush() override;
-	void takeScreenShot(const std::string& filename, bool withOsd) override;
+	void takeScreenShot(ScreenShotWriter& writer,
+	                    const std::string& filename, bool withOsd,
+	                    bool async) override;
 	void updateWindowTitle() override;
 	OutputSurface* getOutputSurface() override;
 	void showCursor(bool show) override;
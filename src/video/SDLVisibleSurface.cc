@@ -1,6 +1,6 @@
 #include "SDLVisibleSurface.hh"
 #include "SDLOffScreenSurface.hh"
-#include "PNG.hh"
+#include "ScreenShotWriter.hh"
 #include "SDLSnow.hh"
 #include "OSDConsoleRenderer.hh"
 #include "OSDGUILayer.hh"
@@ -59,10 +59,29 @@ SDLVisibleSurface::SDLVisibleSurface(
 	calculateViewPort(size, size);
 }
 
+void SDLVisibleSurface::beginFrame(bool writeOnly)
+{
+	// A locked (streaming) texture may not contain the old pixels, so
+	// this is only possible when they're not read back. Then the frame is
+	// written straight into the texture instead of into 'surface' (which
+	// would then have to be copied to the texture).
+	if (!writeOnly || hasLockedPixels()) return;
+	void* pixels;
+	int pitch;
+	if (SDL_LockTexture(texture.get(), nullptr, &pixels, &pitch) == 0) {
+		setLockedPixels(pixels, pitch);
+	}
+}
+
 void SDLVisibleSurface::flushFrameBuffer()
 {
 	SDL_Renderer* render = getSDLRenderer();
-	SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch);
+	if (hasLockedPixels()) {
+		SDL_UnlockTexture(texture.get());
+		setLockedPixels(nullptr, 0);
+	} else {
+		SDL_UpdateTexture(texture.get(), nullptr, surface->pixels, surface->pitch);
+	}
 	SDL_RenderClear(render);
 	SDL_RenderCopy(render, texture.get(), nullptr, nullptr);
 }
@@ -107,13 +126,15 @@ std::unique_ptr<OutputSurface> SDLVisibleSurface::createOffScreenSurface()
 	return std::make_unique<SDLOffScreenSurface>(*surface);
 }
 
-void SDLVisibleSurface::saveScreenshot(const std::string& filename)
+void SDLVisibleSurface::saveScreenshot(
+	ScreenShotWriter& writer, const std::string& filename, bool async)
 {
-	saveScreenshotSDL(*this, filename);
+	saveScreenshotSDL(*this, writer, filename, async);
 }
 
 void SDLVisibleSurface::saveScreenshotSDL(
-	const SDLOutputSurface& output, const std::string& filename)
+	const SDLOutputSurface& output, ScreenShotWriter& writer,
+	const std::string& filename, bool async)
 {
 	auto [width, height] = output.getLogicalSize();
 	VLA(const void*, rowPointers, height);
@@ -126,7 +147,7 @@ void SDLVisibleSurface::saveScreenshotSDL(
 			SDL_PIXELFORMAT_RGB24, buffer.data(), width * 3)) {
 		throw MSXException("Couldn't acquire screenshot pixels: ", SDL_GetError());
 	}
-	PNG::save(width, height, rowPointers, filename);
+	writer.save(width, height, rowPointers, filename, async);
 }
 
 void SDLVisibleSurface::clearScreen()
@@ -17,10 +17,13 @@ public:
 	                  VideoSystem& videoSystem);
 
 	static void saveScreenshotSDL(const SDLOutputSurface& output,
-	                              const std::string& filename);
+	                              ScreenShotWriter& writer,
+	                              const std::string& filename, bool async);
 
 	// OutputSurface
-	void saveScreenshot(const std::string& filename) override;
+	void saveScreenshot(ScreenShotWriter& writer,
+	                    const std::string& filename, bool async) override;
+	void beginFrame(bool writeOnly) override;
 	void flushFrameBuffer() override;
 	void clearScreen() override;
 
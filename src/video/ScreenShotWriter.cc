@@ -0,0 +1,187 @@
+#include "ScreenShotWriter.hh"
+#include "CommandException.hh"
+#include "File.hh"
+#include "FileOperations.hh"
+#include "MSXException.hh"
+#include "PNG.hh"
+#include "TclObject.hh"
+#include "outer.hh"
+#include "strCat.hh"
+#include "vla.hh"
+#include "xrange.hh"
+#include <cstring>
+
+namespace openmsx {
+
+// Limit the memory used by screenshots that are waiting to be written. When
+// there are this many, save() blocks until the oldest one is done.
+constexpr unsigned MAX_PENDING = 4;
+
+ScreenShotWriter::ScreenShotWriter(CommandController& commandController)
+	: waitCmd(commandController)
+	, compressionSetting(commandController, "screenshot_compression",
+		"zlib compression level for screenshots: 0 is fastest, "
+		"9 gives the smallest files", 6, 0, 9)
+{
+}
+
+ScreenShotWriter::~ScreenShotWriter()
+{
+	if (thread.joinable()) {
+		// pending screenshots are still written
+		{
+			std::lock_guard lock(mutex);
+			stop = true;
+		}
+		cond.notify_all();
+		thread.join();
+	}
+}
+
+void ScreenShotWriter::save(
+	unsigned width, unsigned height, const void** rowPointers,
+	const PixelFormat& format, const std::string& filename, bool async)
+{
+	save(width, height, rowPointers, format.getBytesPerPixel(), &format,
+	     filename, async);
+}
+
+void ScreenShotWriter::save(
+	unsigned width, unsigned height, const void** rowPointers,
+	const std::string& filename, bool async)
+{
+	save(width, height, rowPointers, 3, nullptr, filename, async);
+}
+
+void ScreenShotWriter::save(
+	unsigned width, unsigned height, const void** rowPointers,
+	unsigned bytesPerPixel, const PixelFormat* format,
+	const std::string& filename, bool async)
+{
+	int level = compressionSetting.getInt();
+	if (!async) {
+		if (format) {
+			PNG::save(width, height, rowPointers, *format, filename, level);
+		} else {
+			PNG::save(width, height, rowPointers, filename, level);
+		}
+		return;
+	}
+
+	// Create the (empty) file right away: this reports errors in the
+	// filename immediately and it reserves the name for the automatic
+	// numbering of the next screenshot.
+	{ File file(filename, File::TRUNCATE); }
+
+	std::unique_lock lock(mutex);
+	cond.wait(lock, [&] { return pending < MAX_PENDING; });
+	std::vector<uint8_t> pixels;
+	if (!pool.empty()) {
+		pixels = std::move(pool.back());
+		pool.pop_back();
+	}
+	lock.unlock();
+
+	// copy outside the lock, the worker thread only needs it for the queue
+	size_t lineSize = size_t(width) * bytesPerPixel;
+	pixels.resize(lineSize * height);
+	for (auto y : xrange(height)) {
+		memcpy(&pixels[y * lineSize], rowPointers[y], lineSize);
+	}
+
+	lock.lock();
+	queue.push_back(Job{std::move(pixels), filename,
+	                    format ? *format : PixelFormat(), width, height,
+	                    level, format == nullptr});
+	++pending;
+	if (!thread.joinable()) {
+		thread = std::thread([this]() { run(); });
+	}
+	lock.unlock();
+	cond.notify_all();
+}
+
+std::vector<std::string> ScreenShotWriter::waitForPending()
+{
+	std::unique_lock lock(mutex);
+	cond.wait(lock, [&] { return pending == 0; });
+	auto result = std::move(errors);
+	errors.clear();
+	return result;
+}
+
+void ScreenShotWriter::encode(const Job& job)
+{
+	unsigned bytesPerPixel = job.rgb24 ? 3 : job.format.getBytesPerPixel();
+	size_t lineSize = size_t(job.width) * bytesPerPixel;
+	VLA(const void*, rowPointers, job.height);
+	for (auto y : xrange(job.height)) {
+		rowPointers[y] = &job.pixels[y * lineSize];
+	}
+	if (job.rgb24) {
+		PNG::save(job.width, job.height, rowPointers, job.filename,
+		          job.compressionLevel);
+	} else {
+		PNG::save(job.width, job.height, rowPointers, job.format,
+		          job.filename, job.compressionLevel);
+	}
+}
+
+void ScreenShotWriter::run()
+{
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || !queue.empty(); });
+		if (queue.empty()) return; // only when stopping
+
+		auto job = std::move(queue.front());
+		queue.pop_front();
+		lock.unlock();
+
+		std::string error;
+		try {
+			encode(job);
+		} catch (MSXException& e) {
+			error = std::move(e).getMessage();
+			// don't leave an empty or truncated file behind
+			FileOperations::unlink(job.filename);
+		}
+
+		lock.lock();
+		if (!error.empty()) errors.push_back(std::move(error));
+		pool.push_back(std::move(job.pixels));
+		--pending;
+		cond.notify_all();
+	}
+}
+
+
+// class WaitCmd
+
+ScreenShotWriter::WaitCmd::WaitCmd(CommandController& commandController_)
+	: Command(commandController_, "screenshot_wait")
+{
+}
+
+void ScreenShotWriter::WaitCmd::execute(
+	span<const TclObject> tokens, TclObject& /*result*/)
+{
+	checkNumArgs(tokens, 1, Prefix{1}, nullptr);
+	auto& writer = OUTER(ScreenShotWriter, waitCmd);
+	auto errors = writer.waitForPending();
+	if (!errors.empty()) {
+		std::string message = "Failed to write screenshot:";
+		for (const auto& e : errors) strAppend(message, '\n', e);
+		throw CommandException(std::move(message));
+	}
+}
+
+std::string ScreenShotWriter::WaitCmd::help(
+	const std::vector<std::string>& /*tokens*/) const
+{
+	return "Wait till all screenshots that were taken with "
+	       "'screenshot -async' are written to disk. Reports an error "
+	       "for each of them that failed.\n";
+}
+
+} // namespace openmsx
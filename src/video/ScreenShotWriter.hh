@@ -0,0 +1,85 @@
+#ifndef SCREENSHOTWRITER_HH
+#define SCREENSHOTWRITER_HH
+
+#include "Command.hh"
+#include "IntegerSetting.hh"
+#include "PixelFormat.hh"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openmsx {
+
+class CommandController;
+
+/** Writes screenshots to PNG files, either directly or (in async mode) on a
+ * background thread. The mode is chosen per save() call.
+ *
+ * The capture itself must happen on the main thread (it reads from the
+ * renderer), but compressing the image and writing the file is by far the
+ * most expensive part. In async mode the pixels are copied to a (reused)
+ * buffer and save() returns immediately. Use 'screenshot_wait' to make sure
+ * all pending screenshots are written.
+ */
+class ScreenShotWriter final
+{
+public:
+	explicit ScreenShotWriter(CommandController& commandController);
+	~ScreenShotWriter();
+
+	/** Same interface as PNG::save(), plus the mode. Throws MSXException
+	  * on error. In async mode only errors in creating the file are
+	  * reported here, errors while writing are reported by
+	  * waitForPending() (and the partially written file is removed). */
+	void save(unsigned width, unsigned height, const void** rowPointers,
+	          const PixelFormat& format, const std::string& filename,
+	          bool async);
+	void save(unsigned width, unsigned height, const void** rowPointers,
+	          const std::string& filename, bool async);
+
+	/** Block until all pending screenshots are written. Returns the error
+	  * messages of the ones that failed (since the previous call). */
+	std::vector<std::string> waitForPending();
+
+private:
+	struct Job {
+		std::vector<uint8_t> pixels;
+		std::string filename;
+		PixelFormat format;
+		unsigned width;
+		unsigned height;
+		int compressionLevel;
+		bool rgb24;
+	};
+
+	void save(unsigned width, unsigned height, const void** rowPointers,
+	          unsigned bytesPerPixel, const PixelFormat* format,
+	          const std::string& filename, bool async);
+	static void encode(const Job& job);
+	void run();
+
+	struct WaitCmd final : Command {
+		explicit WaitCmd(CommandController& commandController);
+		void execute(span<const TclObject> tokens, TclObject& result) override;
+		std::string help(const std::vector<std::string>& tokens) const override;
+	} waitCmd;
+
+	IntegerSetting compressionSetting;
+
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<Job> queue;                  // not yet started
+	std::vector<std::vector<uint8_t>> pool; // buffers of finished jobs
+	std::vector<std::string> errors;
+	unsigned pending = 0; // queued or being written
+	bool stop = false;
+	std::thread thread;   // only started on first use
+};
+
+} // namespace openmsx
+
+#endif
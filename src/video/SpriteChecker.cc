@@ -17,6 +17,46 @@ TODO:
 
 namespace openmsx {
 
+/** Find the leftmost pixel where (at least) two sprites on a line overlap.
+  * Only the first 'count' sprites that pass 'canCollide' are considered.
+  * Instead of testing every pair of sprites, the sprite patterns are ORed
+  * one by one into a bitmap of the whole line (one bit per pixel). Pixels
+  * that were already set before are the collision pixels.
+  * @return x-coordinate of the collision (0..255), or -1 when there's none.
+  */
+template<typename CanCollide>
+static inline int findCollision(const SpriteChecker::SpriteInfo* sprites,
+                                int count, CanCollide canCollide)
+{
+	// Word 'w' holds the pixels with x-coordinate [32*w - 32, 32*w), the
+	// leftmost pixel in the most significant bit (like SpritePattern).
+	// Word 0 is the left border (sprites with the EC bit set), words 9
+	// and 10 are the right border. Sprites can't collide in the border.
+	using SpritePattern = SpriteChecker::SpritePattern;
+	SpritePattern occupied[11] = {};
+	SpritePattern collided[11] = {};
+	for (int i = 0; i < count; ++i) {
+		const auto& sprite = sprites[i];
+		if (!canCollide(sprite.colorAttrib)) continue;
+		int pos = sprite.x + 32;
+		assert((0 <= pos) && (pos < 32 * 9));
+		int w = pos / 32;
+		int shift = pos % 32;
+		SpritePattern left = sprite.pattern >> shift;
+		SpritePattern right = shift ? (sprite.pattern << (32 - shift)) : 0;
+		collided[w + 0] |= occupied[w + 0] & left;
+		collided[w + 1] |= occupied[w + 1] & right;
+		occupied[w + 0] |= left;
+		occupied[w + 1] |= right;
+	}
+	for (int w = 1; w < 9; ++w) {
+		if (collided[w]) {
+			return 32 * (w - 1) + Math::countLeadingZeros(collided[w]);
+		}
+	}
+	return -1;
+}
+
 SpriteChecker::SpriteChecker(VDP& vdp_, RenderSettings& renderSettings,
                              EmuTime::param time)
 	: vdp(vdp_), vram(vdp.getVRAM())
@@ -201,52 +241,25 @@ inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
 	  they can collide in the V9958 extra border mask. This behaviour is
 	  the same in sprite mode 1 and 2.
 
-	Implemented by checking every pair for collisions.
-	For large numbers of sprites that would be slow,
-	but there are max 4 sprites and therefore max 6 pairs.
+	Implemented with a bitmap of the line, see findCollision().
 	If any collision is found, method returns at once.
 	*/
 	bool can0collide = vdp.canSpriteColor0Collide();
+	auto canCollide = [&](byte colorAttrib) {
+		return can0collide || ((colorAttrib & 0xf) != 0);
+	};
 	for (int line = minLine; line < maxLine; ++line) {
-		int minXCollision = 999;
-		for (int i = std::min<int>(4, spriteCount[line]); --i >= 1; /**/) {
-			auto color1 = spriteBuffer[line][i].colorAttrib & 0xf;
-			if (!can0collide && (color1 == 0)) continue;
-			int x_i = spriteBuffer[line][i].x;
-			SpritePattern pattern_i = spriteBuffer[line][i].pattern;
-			for (int j = i; --j >= 0; ) {
-				auto color2 = spriteBuffer[line][j].colorAttrib & 0xf;
-				if (!can0collide && (color2 == 0)) continue;
-				// Do sprite i and sprite j collide?
-				int x_j = spriteBuffer[line][j].x;
-				int dist = x_j - x_i;
-				if ((-magSize < dist) && (dist < magSize)) {
-					SpritePattern pattern_j = spriteBuffer[line][j].pattern;
-					if (dist < 0) {
-						pattern_j <<= -dist;
-					} else {
-						pattern_j >>= dist;
-					}
-					SpritePattern colPat = pattern_i & pattern_j;
-					if (x_i < 0) {
-						assert(x_i >= -32);
-						colPat &= (1 << (32 + x_i)) - 1;
-					}
-					if (colPat) {
-						int xCollision = x_i + Math::countLeadingZeros(colPat);
-						assert(xCollision >= 0);
-						minXCollision = std::min(minXCollision, xCollision);
-					}
-				}
-			}
-		}
-		if (minXCollision < 256) {
+		if (spriteCount[line] < 2) continue;
+		int xCollision = findCollision(
+			spriteBuffer[line], std::min<int>(4, spriteCount[line]),
+			canCollide);
+		if (xCollision != -1) {
 			vdp.setSpriteStatus(vdp.getStatusReg0() | 0x20);
 			// verified: collision coords are also filled
 			//           in for sprite mode 1
 			// x-coord should be increased by 12
 			// y-coord                         8
-			collisionX = minXCollision + 12;
+			collisionX = xCollision + 12;
 			collisionY = line - vdp.getLineZero() + 8;
 			return; // don't check lines with higher Y-coord
 		}
@@ -435,58 +448,26 @@ inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
 	  they can collide in the V9958 extra border mask. This behaviour is
 	  the same in sprite mode 1 and 2.
 
-	Implemented by checking every pair for collisions.
-	For large numbers of sprites that would be slow.
-	There are max 8 sprites and therefore max 42 pairs.
-	  TODO: Maybe this is slow... Think of something faster.
-	        Probably new approach is needed anyway for OR-ing.
+	Implemented with a bitmap of the line, see findCollision(). Instead of
+	checking all (max 28) pairs of sprites, each sprite is only processed
+	once.
 	*/
 	bool can0collide = vdp.canSpriteColor0Collide();
+	auto canCollide = [&](byte colorAttrib) {
+		// If CC or IC is set, this sprite cannot collide.
+		return (can0collide || ((colorAttrib & 0xf) != 0)) &&
+		       ((colorAttrib & 0x60) == 0);
+	};
 	for (int line = minLine; line < maxLine; ++line) {
-		int minXCollision = 999; // no collision
-		SpriteInfo* visibleSprites = spriteBuffer[line];
-		for (int i = std::min<int>(8, spriteCount[line]); --i >= 1; /**/) {
-			auto colorAttrib1 = visibleSprites[i].colorAttrib;
-			if (!can0collide && ((colorAttrib1 & 0xf) == 0)) continue;
-			// If CC or IC is set, this sprite cannot collide.
-			if (colorAttrib1 & 0x60) continue;
-
-			int x_i = visibleSprites[i].x;
-			SpritePattern pattern_i = visibleSprites[i].pattern;
-			for (int j = i; --j >= 0; ) {
-				auto colorAttrib2 = visibleSprites[j].colorAttrib;
-				if (!can0collide && ((colorAttrib2 & 0xf) == 0)) continue;
-				// If CC or IC is set, this sprite cannot collide.
-				if (colorAttrib2 & 0x60) continue;
-
-				// Do sprite i and sprite j collide?
-				int x_j = visibleSprites[j].x;
-				int dist = x_j - x_i;
-				if ((-magSize < dist) && (dist < magSize)) {
-					SpritePattern pattern_j = visibleSprites[j].pattern;
-					if (dist < 0) {
-						pattern_j <<= -dist;
-					} else {
-						pattern_j >>= dist;
-					}
-					SpritePattern colPat = pattern_i & pattern_j;
-					if (x_i < 0) {
-						assert(x_i >= -32);
-						colPat &= (1 << (32 + x_i)) - 1;
-					}
-					if (colPat) {
-						int xCollision = x_i + Math::countLeadingZeros(colPat);
-						assert(xCollision >= 0);
-						minXCollision = std::min(minXCollision, xCollision);
-					}
-				}
-			}
-		}
-		if (minXCollision < 256) {
+		if (spriteCount[line] < 2) continue;
+		int xCollision = findCollision(
+			spriteBuffer[line], std::min<int>(8, spriteCount[line]),
+			canCollide);
+		if (xCollision != -1) {
 			vdp.setSpriteStatus(vdp.getStatusReg0() | 0x20);
 			// x-coord should be increased by 12
 			// y-coord                         8
-			collisionX = minXCollision + 12;
+			collisionX = xCollision + 12;
 			collisionY = line - vdp.getLineZero() + 8;
 			return; // don't check lines with higher Y-coord
 		}
@@ -38,6 +38,7 @@ TODO:
 #include "VDPVRAM.hh"
 #include "serialize.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -171,6 +172,7 @@ struct Graphic4Mode
 	static constexpr byte PIXELS_PER_BYTE = 2;
 	static constexpr byte PIXELS_PER_BYTE_SHIFT = 1;
 	static constexpr unsigned PIXELS_PER_LINE = 256;
+	static constexpr unsigned LINE_ADDR_MASK = 0x0007F;
 	static inline unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static inline byte point(VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template <typename LogOp>
@@ -221,6 +223,7 @@ struct Graphic5Mode
 	static constexpr byte PIXELS_PER_BYTE = 4;
 	static constexpr byte PIXELS_PER_BYTE_SHIFT = 2;
 	static constexpr unsigned PIXELS_PER_LINE = 512;
+	static constexpr unsigned LINE_ADDR_MASK = 0x0007F;
 	static inline unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static inline byte point(VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template <typename LogOp>
@@ -273,6 +276,7 @@ struct Graphic6Mode
 	static constexpr byte PIXELS_PER_BYTE = 2;
 	static constexpr byte PIXELS_PER_BYTE_SHIFT = 1;
 	static constexpr unsigned PIXELS_PER_LINE = 512;
+	static constexpr unsigned LINE_ADDR_MASK = 0x1007F;
 	static inline unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static inline byte point(VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template <typename LogOp>
@@ -323,6 +327,7 @@ struct Graphic7Mode
 	static constexpr byte PIXELS_PER_BYTE = 1;
 	static constexpr byte PIXELS_PER_BYTE_SHIFT = 0;
 	static constexpr unsigned PIXELS_PER_LINE = 256;
+	static constexpr unsigned LINE_ADDR_MASK = 0x1007F;
 	static inline unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static inline byte point(VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -371,6 +376,7 @@ struct NonBitmapMode
 	static constexpr byte PIXELS_PER_BYTE = 1;
 	static constexpr byte PIXELS_PER_BYTE_SHIFT = 0;
 	static constexpr unsigned PIXELS_PER_LINE = 256;
+	static constexpr unsigned LINE_ADDR_MASK = 0x000FF;
 	static inline unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static inline byte point(VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -719,6 +725,18 @@ using TNotOp = TransparentOp<NotOp>;
 
 // Commands
 
+/** Can a (part of a) line of the destination be written without anyone
+  * observing the individual writes (see VDPVRAM::cmdIsUnobserved())? Then
+  * the byte commands (HMMV, HMMM, YMMM) can first determine how many bytes
+  * fit before the limit and then process them in one tight loop.
+  */
+template<typename Mode>
+static inline bool isLineUnobserved(const VDPVRAM& vram, unsigned y, bool extVRAM)
+{
+	return vram.cmdIsUnobserved(Mode::addressOf(0, y, extVRAM),
+	                            Mode::LINE_ADDR_MASK);
+}
+
 void VDPCmdEngine::setStatusChangeTime(EmuTime::param t)
 {
 	statusChangeTime = t;
@@ -1349,24 +1367,43 @@ void VDPCmdEngine::executeHmmv(EmuTime::param limit)
 	bool dstExt = (ARG & MXD) != 0;
 	bool doPset = !dstExt || hasExtendedVRAM;
 	auto calculator = getSlotCalculator(limit);
+	bool unobserved = doPset && isLineUnobserved<Mode>(vram, DY, dstExt);
 
 	while (!calculator.limitReached()) {
-		if (likely(doPset)) {
-			vram.cmdWrite(Mode::addressOf(ADX, DY, dstExt),
-			              COL, calculator.getTime());
-		}
-		ADX += TX;
-		Delta delta = DELTA_48;
-		if (--ANX == 0) {
-			delta = DELTA_104; // 48 + 56;
-			DY += TY; --NY;
-			ADX = DX; ANX = tmpNX;
-			if (--tmpNY == 0) {
-				commandDone(calculator.getTime());
-				break;
+		if (unobserved) {
+			unsigned num = 1;
+			while (num < ANX) {
+				calculator.next(DELTA_48);
+				if (calculator.limitReached()) break;
+				++num;
+			}
+			for (auto i : xrange(num)) {
+				vram.cmdWriteUnobserved(
+					Mode::addressOf(ADX + i * TX, DY, dstExt), COL);
+			}
+			ADX += num * TX;
+			ANX -= num;
+			if (ANX != 0) break; // limit reached
+		} else {
+			if (likely(doPset)) {
+				vram.cmdWrite(Mode::addressOf(ADX, DY, dstExt),
+				              COL, calculator.getTime());
+			}
+			ADX += TX;
+			if (--ANX != 0) {
+				calculator.next(DELTA_48);
+				continue;
 			}
 		}
-		calculator.next(delta);
+		// end of line
+		DY += TY; --NY;
+		ADX = DX; ANX = tmpNX;
+		if (--tmpNY == 0) {
+			commandDone(calculator.getTime());
+			break;
+		}
+		unobserved = doPset && isLineUnobserved<Mode>(vram, DY, dstExt);
+		calculator.next(DELTA_104); // 48 + 56
 	}
 	engineTime = calculator.getTime();
 	calcFinishTime(tmpNX, tmpNY, 48);
@@ -1457,36 +1494,65 @@ void VDPCmdEngine::executeHmmm(EmuTime::param limit)
 	bool doPoint = !srcExt || hasExtendedVRAM;
 	bool doPset  = !dstExt || hasExtendedVRAM;
 	auto calculator = getSlotCalculator(limit);
+	bool unobserved = doPset && isLineUnobserved<Mode>(vram, DY, dstExt);
+	auto readSrc = [&](unsigned x) -> byte {
+		return likely(doPoint)
+			? vram.cmdReadWindow.readNP(Mode::addressOf(x, SY, srcExt))
+			: 0xFF;
+	};
 
 	switch (phase) {
 	case 0:
 loop:		if (unlikely(calculator.limitReached())) { phase = 0; break; }
-		tmpSrc = likely(doPoint)
-			? vram.cmdReadWindow.readNP(
-			       Mode::addressOf(ASX, SY, srcExt))
-			: 0xFF;
+		if (unobserved) {
+			// count the bytes that are both read and written
+			unsigned num = 0;
+			bool readOnly = false;
+			while (true) {
+				calculator.next(DELTA_24);
+				if (calculator.limitReached()) { readOnly = true; break; }
+				if (++num == ANX) break;
+				calculator.next(DELTA_64);
+				if (calculator.limitReached()) break;
+			}
+			for (auto i : xrange(num)) {
+				vram.cmdWriteUnobserved(
+					Mode::addressOf(ADX + i * TX, DY, dstExt),
+					readSrc(ASX + i * TX));
+			}
+			ASX += num * TX; ADX += num * TX;
+			ANX -= num;
+			if (ANX != 0) { // limit reached
+				if (readOnly) tmpSrc = readSrc(ASX);
+				phase = readOnly ? 1 : 0;
+				break;
+			}
+			goto endOfLine;
+		}
+		tmpSrc = readSrc(ASX);
 		calculator.next(DELTA_24);
 		[[fallthrough]];
-	case 1: {
+	case 1:
 		if (unlikely(calculator.limitReached())) { phase = 1; break; }
 		if (likely(doPset)) {
 			vram.cmdWrite(Mode::addressOf(ADX, DY, dstExt),
 			              tmpSrc, calculator.getTime());
 		}
 		ASX += TX; ADX += TX;
-		Delta delta = DELTA_64;
-		if (--ANX == 0) {
-			delta = DELTA_128; // 64 + 64
-			SY += TY; DY += TY; --NY;
-			ASX = SX; ADX = DX; ANX = tmpNX;
-			if (--tmpNY == 0) {
-				commandDone(calculator.getTime());
-				break;
-			}
+		if (--ANX != 0) {
+			calculator.next(DELTA_64);
+			goto loop;
 		}
-		calculator.next(delta);
+endOfLine:
+		SY += TY; DY += TY; --NY;
+		ASX = SX; ADX = DX; ANX = tmpNX;
+		if (--tmpNY == 0) {
+			commandDone(calculator.getTime());
+			break;
+		}
+		unobserved = doPset && isLineUnobserved<Mode>(vram, DY, dstExt);
+		calculator.next(DELTA_128); // 64 + 64
 		goto loop;
-	}
 	default:
 		UNREACHABLE;
 	}
@@ -1591,10 +1657,41 @@ void VDPCmdEngine::executeYmmm(EmuTime::param limit)
 	bool dstExt = (ARG & MXD) != 0;
 	bool doPset  = !dstExt || hasExtendedVRAM;
 	auto calculator = getSlotCalculator(limit);
+	bool unobserved = doPset && isLineUnobserved<Mode>(vram, DY, dstExt);
 
 	switch (phase) {
 	case 0:
 loop:		if (unlikely(calculator.limitReached())) { phase = 0; break; }
+		if (unobserved) {
+			// count the bytes that are both read and written
+			unsigned num = 0;
+			bool readOnly = false;
+			while (true) {
+				calculator.next(DELTA_24);
+				if (calculator.limitReached()) { readOnly = true; break; }
+				if (++num == ANX) break;
+				calculator.next(DELTA_40);
+				if (calculator.limitReached()) break;
+			}
+			for (auto i : xrange(num)) {
+				unsigned x = ADX + i * TX;
+				vram.cmdWriteUnobserved(
+					Mode::addressOf(x, DY, dstExt),
+					vram.cmdReadWindow.readNP(
+						Mode::addressOf(x, SY, dstExt)));
+			}
+			ADX += num * TX;
+			ANX -= num;
+			if (ANX != 0) { // limit reached
+				if (readOnly) {
+					tmpSrc = vram.cmdReadWindow.readNP(
+						Mode::addressOf(ADX, SY, dstExt));
+				}
+				phase = readOnly ? 1 : 0;
+				break;
+			}
+			goto endOfLine;
+		}
 		if (likely(doPset)) {
 			tmpSrc = vram.cmdReadWindow.readNP(
 			       Mode::addressOf(ADX, SY, dstExt));
@@ -1609,6 +1706,7 @@ loop:		if (unlikely(calculator.limitReached())) { phase = 0; break; }
 		}
 		ADX += TX;
 		if (--ANX == 0) {
+endOfLine:
 			// note: going to the next line does not take extra time
 			SY += TY; DY += TY; --NY;
 			ADX = DX; ANX = tmpNX;
@@ -1616,6 +1714,7 @@ loop:		if (unlikely(calculator.limitReached())) { phase = 0; break; }
 				commandDone(calculator.getTime());
 				break;
 			}
+			unobserved = doPset && isLineUnobserved<Mode>(vram, DY, dstExt);
 		}
 		calculator.next(DELTA_40);
 		goto loop;
@@ -1737,6 +1836,21 @@ void VDPCmdEngine::executeHmmc(EmuTime::param limit)
 }
 
 
+std::ostream& operator<<(std::ostream& os, EnumTypeName<VDPCmdCounters>)
+{
+	return os << "VDPCmdCounters";
+}
+std::ostream& operator<<(std::ostream& os, EnumValueName<VDPCmdCounters> evn)
+{
+	std::string_view names[size_t(VDPCmdCounters::NUM)] = {
+		"StartCommand",
+		"Sync",
+		"StealAccessSlot",
+		"CommandDone",
+	};
+	return os << names[size_t(evn.e)];
+}
+
 VDPCmdEngine::VDPCmdEngine(VDP& vdp_, CommandController& commandController)
 	: vdp(vdp_), vram(vdp.getVRAM())
 	, cmdTraceSetting(
@@ -1757,6 +1871,7 @@ VDPCmdEngine::VDPCmdEngine(VDP& vdp_, CommandController& commandController)
 	, engineTime(EmuTime::zero())
 	, statusChangeTime(EmuTime::infinity())
 	, hasExtendedVRAM(vram.getSize() == (192 * 1024))
+	, profileCounters(strCat(vdp.getName(), " cmd"))
 {
 	status = 0;
 	scrMode = -1;
@@ -1915,6 +2030,7 @@ void VDPCmdEngine::updateDisplayMode(DisplayMode mode, bool cmdBit, EmuTime::par
 
 void VDPCmdEngine::executeCommand(EmuTime::param time)
 {
+	profileCounters.tick(VDPCmdCounters::StartCommand);
 	// V9938 ops only work in SCREEN 5-8.
 	// V9958 ops work in non SCREEN 5-8 when CMD bit is set
 	if (scrMode < 0) {
@@ -2000,6 +2116,7 @@ void VDPCmdEngine::executeCommand(EmuTime::param time)
 
 void VDPCmdEngine::sync2(EmuTime::param time)
 {
+	profileCounters.tick(VDPCmdCounters::Sync);
 	switch ((scrMode << 8) | CMD) {
 	case 0x000: case 0x100: case 0x200: case 0x300: case 0x400:
 	case 0x001: case 0x101: case 0x201: case 0x301: case 0x401:
@@ -2579,6 +2696,7 @@ void VDPCmdEngine::reportVdpCommand()
 
 void VDPCmdEngine::commandDone(EmuTime::param time)
 {
+	profileCounters.tick(VDPCmdCounters::CommandDone);
 	// Note: TR is not reset yet; it is reset when S#2 is read next.
 	status &= 0xFE; // reset CE
 	executingProbe = false;
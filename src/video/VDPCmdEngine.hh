@@ -6,6 +6,7 @@
 #include "BooleanSetting.hh"
 #include "Probe.hh"
 #include "TclCallback.hh"
+#include "ProfileCounters.hh"
 #include "serialize_meta.hh"
 #include "openmsx.hh"
 
@@ -15,6 +16,15 @@ class VDPVRAM;
 class DisplayMode;
 class CommandController;
 
+enum class VDPCmdCounters {
+	StartCommand,
+	Sync,            // sync with a command in progress
+	StealAccessSlot, // CPU VRAM access while a command is in progress
+	CommandDone,
+	NUM // must be last
+};
+std::ostream& operator<<(std::ostream& os, EnumTypeName<VDPCmdCounters>);
+std::ostream& operator<<(std::ostream& os, EnumValueName<VDPCmdCounters> evn);
 
 /** VDP command engine by Alex Wulms.
   * Implements command execution unit of V9938/58.
@@ -45,6 +55,7 @@ public:
 	 */
 	void stealAccessSlot(EmuTime::param time) {
 		if (!CMD) return;
+		profileCounters.tick(VDPCmdCounters::StealAccessSlot);
 		engineTime = time;
 		nextAccessSlot(VDPAccessSlots::DELTA_1); // skip one slot
 		assert(engineTime > time);
@@ -239,6 +250,8 @@ private:
 	/** Flag that indicated whether extended VRAM is available
 	 */
 	const bool hasExtendedVRAM;
+
+	RuntimeProfileCounters<VDPCmdCounters> profileCounters;
 };
 SERIALIZE_CLASS_VERSION(VDPCmdEngine, 3);
 
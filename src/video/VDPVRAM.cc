@@ -4,6 +4,7 @@
 #include "Math.hh"
 #include "outer.hh"
 #include "serialize.hh"
+#include "xrange.hh"
 #include <algorithm>
 #include <cstring>
 
@@ -67,6 +68,28 @@ void VDPVRAM::LogicalVRAMDebuggable::write(
 	vram.cpuWrite(transform(address), value, time);
 }
 
+void VDPVRAM::LogicalVRAMDebuggable::readBlock(unsigned start, span<byte> output)
+{
+	auto& vram = OUTER(VDPVRAM, logicalVRAMDebug);
+	auto time = getMotherBoard().getCurrentTime();
+	if (vram.vdp.getDisplayMode().isPlanar()) {
+		for (auto i : xrange(output.size())) {
+			output[i] = vram.cpuRead(transform(start + unsigned(i)), time);
+		}
+	} else {
+		vram.cpuReadBlock(start, output, time);
+	}
+}
+
+void VDPVRAM::LogicalVRAMDebuggable::writeBlock(unsigned start, span<const byte> input)
+{
+	auto& vram = OUTER(VDPVRAM, logicalVRAMDebug);
+	auto time = getMotherBoard().getCurrentTime();
+	for (auto i : xrange(input.size())) {
+		vram.cpuWrite(transform(start + unsigned(i)), input[i], time);
+	}
+}
+
 
 // class PhysicalVRAMDebuggable
 
@@ -92,6 +115,21 @@ void VDPVRAM::PhysicalVRAMDebuggable::write(
 	vram.cpuWrite(address, value, time);
 }
 
+void VDPVRAM::PhysicalVRAMDebuggable::readBlock(unsigned start, span<byte> output)
+{
+	auto& vram = OUTER(VDPVRAM, physicalVRAMDebug);
+	vram.cpuReadBlock(start, output, getMotherBoard().getCurrentTime());
+}
+
+void VDPVRAM::PhysicalVRAMDebuggable::writeBlock(unsigned start, span<const byte> input)
+{
+	auto& vram = OUTER(VDPVRAM, physicalVRAMDebug);
+	auto time = getMotherBoard().getCurrentTime();
+	for (auto i : xrange(input.size())) {
+		vram.cpuWrite(start + unsigned(i), input[i], time);
+	}
+}
+
 
 // class VDPVRAM
 
@@ -148,6 +186,47 @@ void VDPVRAM::clear()
 	}
 }
 
+void VDPVRAM::cpuReadBlock(unsigned start, span<byte> output, EmuTime::param time)
+{
+	assert(vdp.isInsideFrame(time));
+	#ifdef DEBUG
+	assert(time >= vramTime);
+	vramTime = time;
+	#endif
+
+	// 'sizeMask' can have holes (e.g. A15/A16 are ignored in VR=0 mode),
+	// but the bits below the lowest hole map to consecutive addresses.
+	unsigned lowMask = (unsigned(sizeMask + 1) & ~unsigned(sizeMask)) - 1;
+
+	// Same effect as cpuRead() for each address: all reads happen at the
+	// same time, so one sync (when the command engine may have written
+	// any of these addresses) and one stolen access slot are enough.
+	// Test the range as aligned power-of-2 blocks, for those mayContain()
+	// is exact.
+	bool inside = false;
+	unsigned addr = start;
+	size_t left = output.size();
+	while (left && !inside) {
+		unsigned size = std::min(addr & (~addr + 1), lowMask + 1);
+		if (size == 0) size = lowMask + 1;
+		while (size > left) size >>= 1;
+		inside = cmdWriteWindow.mayContain(addr & sizeMask, size - 1);
+		addr += size;
+		left -= size;
+	}
+	if (inside) cmdEngine->sync(time);
+	cmdEngine->stealAccessSlot(time);
+
+	size_t i = 0;
+	while (i < output.size()) {
+		unsigned address = start + unsigned(i);
+		size_t num = std::min<size_t>(output.size() - i,
+		                              lowMask + 1 - (address & lowMask));
+		memcpy(&output[i], &data[address & sizeMask], num);
+		i += num;
+	}
+}
+
 void VDPVRAM::updateDisplayMode(DisplayMode mode, bool cmdBit, EmuTime::param time)
 {
 	assert(vdp.isInsideFrame(time));
@@ -297,6 +297,17 @@ public:
 		return (address & combiMask) == unsigned(baseAddr);
 	}
 
+	/** Test whether any of the addresses that only differ from the given
+	  * address in the bits of 'varyingMask' is inside this window.
+	  * @param address The address to test.
+	  * @param varyingMask The bits that can have any value.
+	  */
+	inline bool mayContain(unsigned address, unsigned varyingMask) const {
+		if (!isEnabled()) return false;
+		unsigned fixedMask = combiMask & ~varyingMask;
+		return (address & fixedMask) == (unsigned(baseAddr) & fixedMask);
+	}
+
 	/** Notifies the observer of this window of a VRAM change,
 	  * if the changes address is inside this window.
 	  * @param address The address to test.
@@ -428,6 +439,30 @@ public:
 		writeCommon(address, value, time);
 	}
 
+	/** Can the command engine write to the addresses that only differ from
+	  * the given address in the bits of 'varyingMask' without notifying
+	  * anyone? If so, the moment of those writes doesn't matter and
+	  * cmdWriteUnobserved() can be used instead of cmdWrite().
+	  */
+	inline bool cmdIsUnobserved(unsigned address, unsigned varyingMask) const {
+		address &= sizeMask;
+		return !bitmapVisibleWindow.mayContain(address, varyingMask) &&
+		       !spriteAttribTable  .mayContain(address, varyingMask) &&
+		       !spritePatternTable .mayContain(address, varyingMask);
+	}
+
+	/** Same as cmdWrite(), but without timing and notifications. Only
+	  * allowed for addresses for which cmdIsUnobserved() returned true.
+	  */
+	inline void cmdWriteUnobserved(unsigned address, byte value) {
+		address &= sizeMask;
+		if (unlikely(address >= actualSize)) return; // see cmdWrite()
+		assert(!bitmapVisibleWindow.isInside(address));
+		assert(!spriteAttribTable  .isInside(address));
+		assert(!spritePatternTable .isInside(address));
+		data[address] = value;
+	}
+
 	/** Write a byte to VRAM through the CPU interface.
 	  * @param address The address to write.
 	  * @param value The value to write.
@@ -547,6 +582,11 @@ public:
 	void serialize(Archive& ar, unsigned version);
 
 private:
+	/* Equivalent to cpuRead() for each address in a range (all at the
+	 * same time), used by the debuggables.
+	 */
+	void cpuReadBlock(unsigned start, span<byte> output, EmuTime::param time);
+
 	/* Common code of cmdWrite() and cpuWrite()
 	 */
 	inline void writeCommon(unsigned address, byte value, EmuTime::param time) {
@@ -615,6 +655,8 @@ private:
 		explicit LogicalVRAMDebuggable(VDP& vdp);
 		byte read(unsigned address, EmuTime::param time) override;
 		void write(unsigned address, byte value, EmuTime::param time) override;
+		void readBlock(unsigned start, span<byte> output) override;
+		void writeBlock(unsigned start, span<const byte> input) override;
 	private:
 		unsigned transform(unsigned address);
 	} logicalVRAMDebug;
@@ -627,6 +669,8 @@ private:
 		PhysicalVRAMDebuggable(VDP& vdp, unsigned actualSize);
 		byte read(unsigned address, EmuTime::param time) override;
 		void write(unsigned address, byte value, EmuTime::param time) override;
+		void readBlock(unsigned start, span<byte> output) override;
+		void writeBlock(unsigned start, span<const byte> input) override;
 	} physicalVRAMDebug;
 
 	// TODO: Renderer field can be removed, if updateDisplayMode
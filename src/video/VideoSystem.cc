@@ -9,7 +9,8 @@ bool VideoSystem::checkSettings()
 }
 
 void VideoSystem::takeScreenShot(
-	const std::string& /*filename*/, bool /*withOsd*/)
+	ScreenShotWriter& /*writer*/, const std::string& /*filename*/,
+	bool /*withOsd*/, bool /*async*/)
 {
 	throw MSXException(
 		"Taking screenshot not possible with current renderer.");
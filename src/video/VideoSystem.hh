@@ -14,6 +14,7 @@ class LDRasterizer;
 class V9990;
 class LaserdiscPlayer;
 class OutputSurface;
+class ScreenShotWriter;
 
 /** Video back-end system.
   */
@@ -62,11 +63,15 @@ public:
 
 	/** Take a screenshot.
 	  * The default implementation throws an exception.
+	  * @param writer Encodes and writes the PNG file.
 	  * @param filename Name of the file to save the screenshot to.
 	  * @param withOsd Should OSD elements be included in the screenshot.
+	  * @param async Write the file in the background, see ScreenShotWriter.
 	  * @throws MSXException If taking the screen shot fails.
 	  */
-	virtual void takeScreenShot(const std::string& filename, bool withOsd);
+	virtual void takeScreenShot(ScreenShotWriter& writer,
+	                            const std::string& filename, bool withOsd,
+	                            bool async);
 
 	/** Called when the window title string has changed.
 	  */
@@ -11,6 +11,7 @@
 #include "serialize.hh"
 #include "likely.hh"
 #include "unreachable.hh"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -610,6 +611,19 @@ inline void V9990CmdEngine::V9990Bpp8::psetColor(
 	vram.writeVRAMDirect(addr, result);
 }
 
+inline void V9990CmdEngine::V9990Bpp8::psetPlain(
+	V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch, byte srcColor)
+{
+	vram.writeVRAMDirect(addressOf(x, y, pitch), srcColor);
+}
+
+inline void V9990CmdEngine::V9990Bpp8::psetColorPlain(
+	V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch, word color)
+{
+	unsigned addr = addressOf(x, y, pitch);
+	vram.writeVRAMDirect(addr, (addr & 0x40000) ? (color >> 8) : (color & 0xFF));
+}
+
 // 16 bpp -------------------------------------------------------------
 inline unsigned V9990CmdEngine::V9990Bpp16::getPitch(unsigned width)
 {
@@ -682,6 +696,20 @@ inline void V9990CmdEngine::V9990Bpp16::psetColor(
 	vram.writeVRAMDirect(addr + 0x40000, result >> 8);
 }
 
+inline void V9990CmdEngine::V9990Bpp16::psetPlain(
+	V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch, word srcColor)
+{
+	unsigned addr = addressOf(x, y, pitch);
+	vram.writeVRAMDirect(addr + 0x00000, srcColor & 0xFF);
+	vram.writeVRAMDirect(addr + 0x40000, srcColor >> 8);
+}
+
+inline void V9990CmdEngine::V9990Bpp16::psetColorPlain(
+	V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch, word color)
+{
+	psetPlain(vram, x, y, pitch, color);
+}
+
 // ====================================================================
 /** Constructor
   */
@@ -1028,19 +1056,29 @@ void V9990CmdEngine::startLMMV(EmuTime::param time)
 template<typename Mode>
 void V9990CmdEngine::executeLMMV(EmuTime::param limit)
 {
-	// TODO can be optimized a lot
-
 	auto delta = getTiming(*this, LMMV_TIMING);
 	unsigned pitch = Mode::getPitch(vdp.getImageWidth());
 	int dx = (ARG & DIX) ? -1 : 1;
 	int dy = (ARG & DIY) ? -1 : 1;
 	const byte* lut = Mode::getLogOpLUT(LOG);
+	bool plain = (Mode::BITS_PER_PIXEL >= 8) && isPlainWrite();
 	while (engineTime < limit) {
-		engineTime += delta;
-		Mode::psetColor(vram, DX, DY, pitch, fgCol, WM, lut, LOG);
+		unsigned num = getSpanLength(delta, limit, ANX);
+		engineTime += delta * num;
+		if (plain) {
+			if constexpr (Mode::BITS_PER_PIXEL >= 8) {
+				for (unsigned i = 0; i < num; ++i, DX += dx) {
+					Mode::psetColorPlain(vram, DX, DY, pitch, fgCol);
+				}
+			}
+		} else {
+			for (unsigned i = 0; i < num; ++i, DX += dx) {
+				Mode::psetColor(vram, DX, DY, pitch, fgCol, WM, lut, LOG);
+			}
+		}
 
-		DX += dx;
-		if (!--(ANX)) {
+		ANX -= num;
+		if (!ANX) {
 			DX -= (NX * dx);
 			DY += dy;
 			if (!--(ANY)) {
@@ -1120,22 +1158,34 @@ void V9990CmdEngine::startLMMM(EmuTime::param time)
 template<typename Mode>
 void V9990CmdEngine::executeLMMM(EmuTime::param limit)
 {
-	// TODO can be optimized a lot
-
 	auto delta = getTiming(*this, LMMM_TIMING);
 	unsigned pitch = Mode::getPitch(vdp.getImageWidth());
 	int dx = (ARG & DIX) ? -1 : 1;
 	int dy = (ARG & DIY) ? -1 : 1;
 	const byte* lut = Mode::getLogOpLUT(LOG);
+	bool plain = (Mode::BITS_PER_PIXEL >= 8) && isPlainWrite();
 	while (engineTime < limit) {
-		engineTime += delta;
-		auto src = Mode::point(vram, SX, SY, pitch);
-		src = Mode::shift(src, SX, DX);
-		Mode::pset(vram, DX, DY, pitch, src, WM, lut, LOG);
+		unsigned num = getSpanLength(delta, limit, ANX);
+		engineTime += delta * num;
+		// Pixels are processed one by one (also in the plain case),
+		// source and destination may overlap.
+		if (plain) {
+			if constexpr (Mode::BITS_PER_PIXEL >= 8) {
+				for (unsigned i = 0; i < num; ++i, DX += dx, SX += dx) {
+					auto src = Mode::point(vram, SX, SY, pitch);
+					Mode::psetPlain(vram, DX, DY, pitch, src);
+				}
+			}
+		} else {
+			for (unsigned i = 0; i < num; ++i, DX += dx, SX += dx) {
+				auto src = Mode::point(vram, SX, SY, pitch);
+				src = Mode::shift(src, SX, DX);
+				Mode::pset(vram, DX, DY, pitch, src, WM, lut, LOG);
+			}
+		}
 
-		DX += dx;
-		SX += dx;
-		if (!--(ANX)) {
+		ANX -= num;
+		if (!ANX) {
 			DX -= (NX * dx);
 			SX -= (NX * dx);
 			DY += dy;
@@ -1268,14 +1318,22 @@ void V9990CmdEngine::executeBMXL<V9990CmdEngine::V9990Bpp16>(EmuTime::param limi
 	int dy = (ARG & DIY) ? -1 : 1;
 	const byte* lut = V9990Bpp16::getLogOpLUT(LOG);
 
+	bool plain = isPlainWrite();
 	while (engineTime < limit) {
-		engineTime += delta;
-		word src = vram.readVRAMBx(srcAddress + 0) +
-		           vram.readVRAMBx(srcAddress + 1) * 256;
-		srcAddress += 2;
-		V9990Bpp16::pset(vram, DX, DY, pitch, src, WM, lut, LOG);
-		DX += dx;
-		if (!--(ANX)) {
+		unsigned num = getSpanLength(delta, limit, ANX);
+		engineTime += delta * num;
+		for (unsigned i = 0; i < num; ++i, DX += dx) {
+			word src = vram.readVRAMBx(srcAddress + 0) +
+			           vram.readVRAMBx(srcAddress + 1) * 256;
+			srcAddress += 2;
+			if (plain) {
+				V9990Bpp16::psetPlain(vram, DX, DY, pitch, src);
+			} else {
+				V9990Bpp16::pset(vram, DX, DY, pitch, src, WM, lut, LOG);
+			}
+		}
+		ANX -= num;
+		if (!ANX) {
 			DX -= (NX * dx);
 			DY += dy;
 			if (!--(ANY)) {
@@ -1336,12 +1394,15 @@ void V9990CmdEngine::executeBMLX<V9990CmdEngine::V9990Bpp16>(EmuTime::param limi
 	int dy = (ARG & DIY) ? -1 : 1;
 
 	while (engineTime < limit) {
-		engineTime += delta;
-		auto src = V9990Bpp16::point(vram, SX, SY, pitch);
-		vram.writeVRAMBx(dstAddress++, src & 0xFF);
-		vram.writeVRAMBx(dstAddress++, src >> 8);
-		SX += dx;
-		if (!--(ANX)) {
+		unsigned num = getSpanLength(delta, limit, ANX);
+		engineTime += delta * num;
+		for (unsigned i = 0; i < num; ++i, SX += dx) {
+			auto src = V9990Bpp16::point(vram, SX, SY, pitch);
+			vram.writeVRAMBx(dstAddress++, src & 0xFF);
+			vram.writeVRAMBx(dstAddress++, src >> 8);
+		}
+		ANX -= num;
+		if (!ANX) {
 			SX -= (NX * dx);
 			SY += dy;
 			if (!--(ANY)) {
@@ -1763,6 +1824,14 @@ byte V9990CmdEngine::peekCmdData(EmuTime::param time)
 	return (status & TR) ? data : 0xFF;
 }
 
+unsigned V9990CmdEngine::getSpanLength(
+	EmuDuration::param delta, EmuTime::param limit, unsigned max) const
+{
+	assert(engineTime < limit);
+	if (delta == EmuDuration::zero()) return max; // broken timing
+	return std::min((limit - engineTime).divUp(delta), max);
+}
+
 void V9990CmdEngine::cmdReady(EmuTime::param /*time*/)
 {
 	CMD = 0; // for deserialize
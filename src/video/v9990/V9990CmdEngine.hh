@@ -198,6 +198,13 @@ private:
 		static inline void psetColor(
 			V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch,
 			word color, word mask, const byte* lut, byte op);
+		// pset()/psetColor() for IMP without transparency and full WM
+		static inline void psetPlain(
+			V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch,
+			byte srcColor);
+		static inline void psetColorPlain(
+			V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch,
+			word color);
 	};
 
 	class V9990Bpp16 {
@@ -219,6 +226,13 @@ private:
 		static inline void psetColor(
 			V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch,
 			word color, word mask, const byte* lut, byte op);
+		// pset()/psetColor() for IMP without transparency and full WM
+		static inline void psetPlain(
+			V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch,
+			word srcColor);
+		static inline void psetColorPlain(
+			V9990VRAM& vram, unsigned x, unsigned y, unsigned pitch,
+			word color);
 	};
 
 	void startSTOP  (EmuTime::param time);
@@ -321,6 +335,23 @@ private:
 	  */
 	void cmdReady(EmuTime::param time);
 
+	/** The number of pixels, starting at the current engineTime, of which
+	  * the processing starts before 'limit', at most 'max'. The commands
+	  * use this to process (a part of) a line without checking the time
+	  * for each pixel.
+	  */
+	[[nodiscard]] unsigned getSpanLength(EmuDuration::param delta,
+	                                     EmuTime::param limit,
+	                                     unsigned max) const;
+
+	/** Does the logical operation simply replace the destination (IMP, no
+	  * transparency) and is the write mask fully enabled? In 8bpp and
+	  * 16bpp modes pixels are then written without reading VRAM first.
+	  */
+	[[nodiscard]] bool isPlainWrite() const {
+		return ((LOG & 0x1F) == 0x0C) && (WM == 0xFFFF);
+	}
+
 	/** For debugging: Print the info about the current command.
 	  */
 	void reportV9990Command();
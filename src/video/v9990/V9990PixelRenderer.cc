@@ -27,9 +27,9 @@ V9990PixelRenderer::V9990PixelRenderer(V9990& vdp_)
 	, videoSourceSetting(vdp.getMotherBoard().getVideoSource())
 	, rasterizer(vdp.getReactor().getDisplay().
 	                getVideoSystem().createV9990Rasterizer(vdp))
+	, framePacer(realTime, vdp.getReactor().getDisplay())
 {
 	frameSkipCounter = 999; // force drawing of frame;
-	finishFrameDuration = 0;
 	drawFrame = false; // don't draw before frameStart is called
 	prevDrawFrame = false;
 
@@ -55,6 +55,7 @@ void V9990PixelRenderer::reset(EmuTime::param time)
 	displayEnabled = vdp.isDisplayEnabled();
 	setDisplayMode(vdp.getDisplayMode(), time);
 	setColorMode(vdp.getColorMode(), time);
+	framePacer.restart();
 
 	rasterizer->reset();
 }
@@ -65,8 +66,10 @@ void V9990PixelRenderer::frameStart(EmuTime::param time)
 		frameSkipCounter = 999;
 		drawFrame = false;
 		prevDrawFrame = false;
+		framePacer.restart();
 		return;
 	}
+	framePacer.frameStart(time);
 	prevDrawFrame = drawFrame;
 	if (vdp.isInterlaced() && renderSettings.getDeinterlace() &&
 	    vdp.getEvenOdd() && vdp.isEvenOddEnabled()) {
@@ -83,8 +86,7 @@ void V9990PixelRenderer::frameStart(EmuTime::param time)
 			if (rasterizer->isRecording()) {
 				drawFrame = true;
 			} else {
-				drawFrame = realTime.timeLeft(
-					unsigned(finishFrameDuration), time);
+				drawFrame = framePacer.renderFrame(time);
 			}
 			if (drawFrame) {
 				frameSkipCounter = 0;
@@ -113,10 +115,7 @@ void V9990PixelRenderer::frameEnd(EmuTime::param time)
 		auto time1 = Timer::getTime();
 		rasterizer->frameEnd(time);
 		auto time2 = Timer::getTime();
-		auto current = time2 - time1;
-		const float ALPHA = 0.2f;
-		finishFrameDuration = finishFrameDuration * (1 - ALPHA) +
-		                      current * ALPHA;
+		framePacer.addFinishTime(time2 - time1);
 
 		if (vdp.isInterlaced() && vdp.isEvenOddEnabled() &&
 		    renderSettings.getDeinterlace() &&
@@ -127,14 +126,17 @@ void V9990PixelRenderer::frameEnd(EmuTime::param time)
 		}
 
 	}
+	bool presented = false;
 	if (vdp.getMotherBoard().isActive() &&
 	    !vdp.getMotherBoard().isFastForwarding()) {
-		eventDistributor.distributeEvent(
-			std::make_shared<FinishFrameEvent>(
-				rasterizer->getPostProcessor()->getVideoSource(),
-				videoSourceSetting.getSource(),
-				skipEvent));
+		auto event = std::make_shared<FinishFrameEvent>(
+			rasterizer->getPostProcessor()->getVideoSource(),
+			videoSourceSetting.getSource(),
+			skipEvent);
+		presented = event->needRender();
+		eventDistributor.distributeEvent(std::move(event));
 	}
+	framePacer.frameEnd(time, drawFrame, presented);
 }
 
 void V9990PixelRenderer::sync(EmuTime::param time, bool force)
@@ -173,6 +175,8 @@ void V9990PixelRenderer::renderUntil(EmuTime::param time)
 
 	if ((toX == lastX) && (toY == lastY)) return;
 
+	bool measure = framePacer.measureRenderTime();
+	auto startTime = measure ? Timer::getTime() : 0;
 	// edges of the DISPLAY part of the vdp output
 	int left       = vdp.getLeftBorder();
 	int right      = vdp.getRightBorder();
@@ -196,6 +200,7 @@ void V9990PixelRenderer::renderUntil(EmuTime::param time)
 
 	lastX = toX;
 	lastY = toY;
+	if (measure) framePacer.addRenderTime(Timer::getTime() - startTime);
 }
 
 void V9990PixelRenderer::subdivide(int fromX, int fromY, int toX, int toY,
@@ -2,6 +2,7 @@
 #define V9990PIXELRENDERER_HH
 
 #include "V9990Renderer.hh"
+#include "FramePacer.hh"
 #include "Observer.hh"
 #include "RenderSettings.hh"
 #include "openmsx.hh"
@@ -74,7 +75,7 @@ private:
 
 	/** Frameskip
 	  */
-	float finishFrameDuration;
+	FramePacer framePacer;
 	int frameSkipCounter;
 
 	/** Accuracy setting for current frame.
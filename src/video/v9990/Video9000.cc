@@ -123,13 +123,15 @@ void Video9000::paint(OutputSurface& output)
 	activeLayer->paint(output);
 }
 
-void Video9000::takeRawScreenShot(unsigned height, const std::string& filename)
+void Video9000::takeRawScreenShot(
+	unsigned height, ScreenShotWriter& writer, const std::string& filename,
+	bool async)
 {
 	auto* layer = dynamic_cast<VideoLayer*>(activeLayer);
 	if (!layer) {
 		throw CommandException("TODO");
 	}
-	layer->takeRawScreenShot(height, filename);
+	layer->takeRawScreenShot(height, writer, filename, async);
 }
 
 int Video9000::signalEvent(const std::shared_ptr<const Event>& event)
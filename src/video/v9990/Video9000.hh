@@ -39,7 +39,8 @@ private:
 
 	// VideoLayer
 	void paint(OutputSurface& output) override;
-	void takeRawScreenShot(unsigned height, const std::string& filename) override;
+	void takeRawScreenShot(unsigned height, ScreenShotWriter& writer,
+	                       const std::string& filename, bool async) override;
 
 	// EventListener
 	int signalEvent(const std::shared_ptr<const Event>& event) override;